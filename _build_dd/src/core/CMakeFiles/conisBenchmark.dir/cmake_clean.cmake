@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../conisBenchmark"
+  "../../conisBenchmark.pdb"
+  "CMakeFiles/conisBenchmark.dir/benchmark/subdivisionbenchmark.cpp.o"
+  "CMakeFiles/conisBenchmark.dir/benchmark/subdivisionbenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/conisBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
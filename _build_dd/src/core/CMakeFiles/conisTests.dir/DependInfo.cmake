@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/test/curve/chunkedstorage_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/curve/chunkedstorage_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/curve/chunkedstorage_test.cpp.o.d"
+  "/root/repo/src/core/test/curve/coniscurve_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/curve/coniscurve_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/curve/coniscurve_test.cpp.o.d"
+  "/root/repo/src/core/test/curve/curvenormals_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/curve/curvenormals_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/curve/curvenormals_test.cpp.o.d"
+  "/root/repo/src/core/test/curve/persistentcurve_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/curve/persistentcurve_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/curve/persistentcurve_test.cpp.o.d"
+  "/root/repo/src/core/test/curve/spatialindex_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/curve/spatialindex_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/curve/spatialindex_test.cpp.o.d"
+  "/root/repo/src/core/test/jobs/jobsystem_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/jobs/jobsystem_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/jobs/jobsystem_test.cpp.o.d"
+  "/root/repo/src/core/test/log/log_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/log/log_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/log/log_test.cpp.o.d"
+  "/root/repo/src/core/test/scalar/doubledouble_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/scalar/doubledouble_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/scalar/doubledouble_test.cpp.o.d"
+  "/root/repo/src/core/test/scalar/fastmath_test.cpp" "src/core/CMakeFiles/conisTests.dir/test/scalar/fastmath_test.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/scalar/fastmath_test.cpp.o.d"
+  "/root/repo/src/core/test/test_helpers.cpp" "src/core/CMakeFiles/conisTests.dir/test/test_helpers.cpp.o" "gcc" "src/core/CMakeFiles/conisTests.dir/test/test_helpers.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_build_dd/src/core/CMakeFiles/conis_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
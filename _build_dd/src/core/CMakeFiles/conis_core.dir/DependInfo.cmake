@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/src/changeset.cpp" "src/core/CMakeFiles/conis_core.dir/src/changeset.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/changeset.cpp.o.d"
+  "/root/repo/src/core/src/conics/conic.cpp" "src/core/CMakeFiles/conis_core.dir/src/conics/conic.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/conics/conic.cpp.o.d"
+  "/root/repo/src/core/src/conics/conicfitter.cpp" "src/core/CMakeFiles/conis_core.dir/src/conics/conicfitter.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/conics/conicfitter.cpp.o.d"
+  "/root/repo/src/core/src/coniscurve.cpp" "src/core/CMakeFiles/conis_core.dir/src/coniscurve.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/coniscurve.cpp.o.d"
+  "/root/repo/src/core/src/curve/arclengthtable.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/arclengthtable.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/arclengthtable.cpp.o.d"
+  "/root/repo/src/core/src/curve/compactcurve.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/compactcurve.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/compactcurve.cpp.o.d"
+  "/root/repo/src/core/src/curve/curvatureprofile.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curvatureprofile.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curvatureprofile.cpp.o.d"
+  "/root/repo/src/core/src/curve/curve.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curve.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curve.cpp.o.d"
+  "/root/repo/src/core/src/curve/curveloader.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curveloader.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curveloader.cpp.o.d"
+  "/root/repo/src/core/src/curve/curvepresetfactory.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curvepresetfactory.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curvepresetfactory.cpp.o.d"
+  "/root/repo/src/core/src/curve/curvesaver.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curvesaver.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curvesaver.cpp.o.d"
+  "/root/repo/src/core/src/curve/curveutils.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/curveutils.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/curveutils.cpp.o.d"
+  "/root/repo/src/core/src/curve/persistentcurve.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/persistentcurve.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/persistentcurve.cpp.o.d"
+  "/root/repo/src/core/src/curve/refinement/normalrefiner.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/refinement/normalrefiner.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/refinement/normalrefiner.cpp.o.d"
+  "/root/repo/src/core/src/curve/spatialgrid.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/spatialgrid.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/spatialgrid.cpp.o.d"
+  "/root/repo/src/core/src/curve/subdivision/conicsubdivider.cpp" "src/core/CMakeFiles/conis_core.dir/src/curve/subdivision/conicsubdivider.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/curve/subdivision/conicsubdivider.cpp.o.d"
+  "/root/repo/src/core/src/jobs/jobsystem.cpp" "src/core/CMakeFiles/conis_core.dir/src/jobs/jobsystem.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/jobs/jobsystem.cpp.o.d"
+  "/root/repo/src/core/src/util/log.cpp" "src/core/CMakeFiles/conis_core.dir/src/util/log.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/util/log.cpp.o.d"
+  "/root/repo/src/core/src/util/memory.cpp" "src/core/CMakeFiles/conis_core.dir/src/util/memory.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/util/memory.cpp.o.d"
+  "/root/repo/src/core/src/util/precisionstats.cpp" "src/core/CMakeFiles/conis_core.dir/src/util/precisionstats.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/src/util/precisionstats.cpp.o.d"
+  "/root/repo/src/core/test/test_helpers.cpp" "src/core/CMakeFiles/conis_core.dir/test/test_helpers.cpp.o" "gcc" "src/core/CMakeFiles/conis_core.dir/test/test_helpers.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
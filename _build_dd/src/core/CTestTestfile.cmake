@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/src/core
+# Build directory: /root/repo/_build_dd/src/core
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(conisTests "/root/repo/_build_dd/conisTests")
+set_tests_properties(conisTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/core/CMakeLists.txt;139;add_test;/root/repo/src/core/CMakeLists.txt;0;")
@@ -0,0 +1,39 @@
+file(REMOVE_RECURSE
+  "../../conisTests"
+  "../../conisTests.pdb"
+  "CMakeFiles/conisTests.dir/test/conics/conic_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/conics/conic_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/arclengthtable_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/arclengthtable_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/chunkedstorage_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/chunkedstorage_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/coniscurve_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/coniscurve_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/curvatureprofile_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/curvatureprofile_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/curvenormals_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/curvenormals_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/persistentcurve_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/persistentcurve_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/curve/spatialindex_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/curve/spatialindex_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/jobs/jobsystem_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/jobs/jobsystem_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/log/log_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/log/log_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/refinement/normalrefiner_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/refinement/normalrefiner_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/scalar/doubledouble_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/scalar/doubledouble_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/scalar/fastmath_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/scalar/fastmath_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/subdivision/conicsubdivider_test.cpp.o"
+  "CMakeFiles/conisTests.dir/test/subdivision/conicsubdivider_test.cpp.o.d"
+  "CMakeFiles/conisTests.dir/test/test_helpers.cpp.o"
+  "CMakeFiles/conisTests.dir/test/test_helpers.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/conisTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,51 @@
+file(REMOVE_RECURSE
+  "../../libconis_core.a"
+  "../../libconis_core.pdb"
+  "CMakeFiles/conis_core.dir/src/changeset.cpp.o"
+  "CMakeFiles/conis_core.dir/src/changeset.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/conics/conic.cpp.o"
+  "CMakeFiles/conis_core.dir/src/conics/conic.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/conics/conicfitter.cpp.o"
+  "CMakeFiles/conis_core.dir/src/conics/conicfitter.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/coniscurve.cpp.o"
+  "CMakeFiles/conis_core.dir/src/coniscurve.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/arclengthtable.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/arclengthtable.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/compactcurve.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/compactcurve.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curvatureprofile.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curvatureprofile.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curve.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curve.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curveloader.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curveloader.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curvepresetfactory.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curvepresetfactory.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curvesaver.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curvesaver.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/curveutils.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/curveutils.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/persistentcurve.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/persistentcurve.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/refinement/normalrefiner.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/refinement/normalrefiner.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/spatialgrid.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/spatialgrid.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/curve/subdivision/conicsubdivider.cpp.o"
+  "CMakeFiles/conis_core.dir/src/curve/subdivision/conicsubdivider.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/jobs/jobsystem.cpp.o"
+  "CMakeFiles/conis_core.dir/src/jobs/jobsystem.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/util/log.cpp.o"
+  "CMakeFiles/conis_core.dir/src/util/log.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/util/memory.cpp.o"
+  "CMakeFiles/conis_core.dir/src/util/memory.cpp.o.d"
+  "CMakeFiles/conis_core.dir/src/util/precisionstats.cpp.o"
+  "CMakeFiles/conis_core.dir/src/util/precisionstats.cpp.o.d"
+  "CMakeFiles/conis_core.dir/test/test_helpers.cpp.o"
+  "CMakeFiles/conis_core.dir/test/test_helpers.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/conis_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
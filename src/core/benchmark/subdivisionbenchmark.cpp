@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "conis/core/curve/curveloader.hpp"
+#include "conis/core/curve/subdivision/conicsubdivider.hpp"
+#include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/precisionstats.hpp"
+#include "conis/core/vector.hpp"
+
+using namespace conis::core;
+
+#if defined(CONIS_SCALAR_DOUBLE_DOUBLE)
+static constexpr const char *scalarName = "double-double";
+#elif defined(CONIS_SCALAR_DOUBLE)
+static constexpr const char *scalarName = "double";
+#else
+static constexpr const char *scalarName = "long double";
+#endif
+
+/**
+ * Subdivides every curve of the given corpus and reports the time it takes.
+ * Build the library with different CONIS_SCALAR values and compare the output to compare the scalar backends.
+ * The checksum is the sum of all subdivided coordinates; it should agree between the backends up to their precision.
+ *
+ * Usage: conisBenchmark [curve directory] [subdivision level] [repetitions]
+ */
+int main(int argc, char *argv[]) {
+    const std::filesystem::path curveDir = argc > 1 ? argv[1] : CONIS_CURVES_DIR;
+    const int level = argc > 2 ? std::stoi(argv[2]) : 6;
+    const int repetitions = argc > 3 ? std::stoi(argv[3]) : 5;
+
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry: std::filesystem::directory_iterator(curveDir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+            files.emplace_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::cout << "Scalar: " << scalarName << " (" << sizeof(real_t) << " bytes), level: " << level
+              << ", repetitions: " << repetitions << std::endl;
+
+    SubdivisionSettings settings;
+    ConicSubdivider subdivider(settings);
+    CurveLoader loader;
+    double totalMs = 0;
+    long double totalChecksum = 0;
+    for (const auto &file: files) {
+        const Curve controlCurve = loader.loadCurveFromFile(file.string());
+        if (controlCurve.numPoints() < 3) {
+            continue;
+        }
+        Curve curve;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            controlCurve.copyDataTo(curve);
+            subdivider.subdivide(curve, level);
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(end - start).count() / repetitions;
+
+        long double checksum = 0;
+        for (const auto &v: curve.getVertices()) {
+            checksum += static_cast<long double>(v.x()) + static_cast<long double>(v.y());
+        }
+        totalMs += ms;
+        totalChecksum += checksum;
+        std::cout << std::left << std::setw(36) << file.filename().string() << std::right << std::setw(8)
+                  << curve.numPoints() << " points " << std::fixed << std::setprecision(3) << std::setw(10) << ms
+                  << " ms  checksum " << std::setprecision(18) << checksum << std::endl;
+    }
+    std::cout << "Total: " << std::fixed << std::setprecision(3) << totalMs << " ms  checksum "
+              << std::setprecision(18) << totalChecksum << std::endl;
+
+    const PrecisionStats &stats = precisionStats();
+    std::cout << "Half plane tests: " << stats.halfPlaneFast << " fast, " << stats.halfPlaneFallback << " fallback"
+              << std::endl;
+    std::cout << "Intersection tests: " << stats.intersectFast << " fast, " << stats.intersectFallback << " fallback"
+              << std::endl;
+    return 0;
+}
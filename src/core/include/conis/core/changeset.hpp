@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+namespace conis::core {
+
+/**
+ * A half-open range [begin, end) of point indices.
+ */
+using IndexRange = struct IndexRange {
+    int begin = 0;
+    int end = 0;
+
+    bool operator==(const IndexRange &other) const { return begin == other.begin && end == other.end; }
+};
+
+/**
+ * @brief Describes which points of a single curve changed since the last notification.
+ */
+using CurveChanges = struct CurveChanges {
+    // Sorted, non-overlapping and non-adjacent ranges of points whose position or normal may have changed
+    std::vector<IndexRange> ranges;
+    // The number of points or the closedness changed: all points should be considered changed
+    bool resized = false;
+
+    /**
+     * @brief Marks the points in the given range as changed, merging it with the existing ranges.
+     * @param range The range of changed points. Empty ranges are ignored.
+     */
+    void add(IndexRange range);
+    void merge(const CurveChanges &other);
+    [[nodiscard]] bool empty() const { return ranges.empty() && !resized; }
+};
+
+/**
+ * @brief The changes to the control curve and the subdivision curve of a ConisCurve delivered to its listeners. A
+ * single change set may describe any number of coalesced edits.
+ */
+using ChangeSet = struct ChangeSet {
+    CurveChanges control;
+    CurveChanges subdiv;
+
+    void merge(const ChangeSet &other);
+    [[nodiscard]] bool empty() const { return control.empty() && subdiv.empty(); }
+};
+
+} // namespace conis::core
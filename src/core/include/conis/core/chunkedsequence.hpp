@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cassert>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "conis/core/fenwicktree.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief A sequence of elements stored in chunks of around ChunkSize elements, with a Fenwick tree over the chunk
+ * sizes. Finding the element at a position takes O(log n), and inserting or removing an element only shifts the
+ * elements of a single chunk instead of all elements after it as std::vector does. Chunks are split when they reach
+ * twice ChunkSize and merged when they become small, which rebuilds the tree in O(n / ChunkSize), but only once per
+ * O(ChunkSize) edits.
+ *
+ * Every element gets an id when it is inserted, which it keeps until it is erased. Looking up an element or its
+ * neighbours by id takes O(1) and finding its position O(log n), so that e.g. a spatial index can refer to elements by
+ * id without being updated when elements are inserted or erased before them. The ids of erased elements are reused.
+ * @tparam T The element type.
+ * @tparam ChunkSize The preferred number of elements per chunk.
+ */
+template<typename T, int ChunkSize = 512>
+class ChunkedSequence {
+    static_assert(ChunkSize >= 4, "Chunks should hold at least a few elements");
+
+public:
+    /**
+     * @brief Visits the elements in order.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator(const ChunkedSequence *sequence, const int rank, const int offset)
+            : sequence_(sequence),
+              rank_(rank),
+              offset_(offset) {}
+
+        reference operator*() const { return chunk().items[offset_]; }
+        pointer operator->() const { return &chunk().items[offset_]; }
+        // The id of the element
+        [[nodiscard]] int id() const { return chunk().ids[offset_]; }
+
+        const_iterator &operator++() {
+            if (++offset_ == static_cast<int>(chunk().items.size())) {
+                rank_++;
+                offset_ = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator &other) const { return rank_ == other.rank_ && offset_ == other.offset_; }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+    private:
+        const ChunkedSequence *sequence_;
+        int rank_;
+        int offset_;
+
+        [[nodiscard]] const auto &chunk() const { return sequence_->chunks_[sequence_->order_[rank_]]; }
+    };
+
+    ChunkedSequence() = default;
+
+    /**
+     * @brief Replaces the elements. The elements get the ids 0 to n - 1 in order.
+     */
+    template<typename It>
+    void assign(It first, It last) {
+        clear();
+        for (; first != last; ++first) {
+            if (order_.empty() || static_cast<int>(chunks_[order_.back()].items.size()) == ChunkSize) {
+                order_.push_back(newChunk());
+            }
+            Chunk &chunk = chunks_[order_.back()];
+            locations_.push_back({order_.back(), static_cast<int>(chunk.items.size())});
+            chunk.items.push_back(*first);
+            chunk.ids.push_back(size_++);
+        }
+        reorder(0);
+    }
+
+    void clear() {
+        chunks_.clear();
+        order_.clear();
+        rank_.clear();
+        freeChunks_.clear();
+        locations_.clear();
+        freeIds_.clear();
+        sizes_.clear();
+        size_ = 0;
+    }
+
+    [[nodiscard]] int size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] int numChunks() const { return static_cast<int>(order_.size()); }
+
+    [[nodiscard]] const T &operator[](const int pos) const {
+        const auto [chunk, offset] = locate(pos);
+        return chunks_[chunk].items[offset];
+    }
+
+    // The id of an element must not be changed through the returned reference
+    [[nodiscard]] T &operator[](const int pos) {
+        const auto [chunk, offset] = locate(pos);
+        return chunks_[chunk].items[offset];
+    }
+
+    [[nodiscard]] int idAt(const int pos) const {
+        const auto [chunk, offset] = locate(pos);
+        return chunks_[chunk].ids[offset];
+    }
+
+    [[nodiscard]] int indexOf(const int id) const {
+        const Location &location = locations_[id];
+        return sizes_.prefixSum(rank_[location.chunk]) + location.offset;
+    }
+
+    [[nodiscard]] const T &byId(const int id) const {
+        const Location &location = locations_[id];
+        return chunks_[location.chunk].items[location.offset];
+    }
+
+    [[nodiscard]] T &byId(const int id) {
+        const Location &location = locations_[id];
+        return chunks_[location.chunk].items[location.offset];
+    }
+
+    /**
+     * @brief Returns the id of the element after the one with the given id. The last element is followed by the first.
+     */
+    [[nodiscard]] int nextId(const int id) const {
+        const Location &location = locations_[id];
+        const Chunk &chunk = chunks_[location.chunk];
+        if (location.offset + 1 < static_cast<int>(chunk.ids.size())) {
+            return chunk.ids[location.offset + 1];
+        }
+        const int rank = rank_[location.chunk] + 1;
+        return chunks_[order_[rank < numChunks() ? rank : 0]].ids.front();
+    }
+
+    /**
+     * @brief Returns the id of the element before the one with the given id. The first element is preceded by the last.
+     */
+    [[nodiscard]] int prevId(const int id) const {
+        const Location &location = locations_[id];
+        if (location.offset > 0) {
+            return chunks_[location.chunk].ids[location.offset - 1];
+        }
+        const int rank = rank_[location.chunk] - 1;
+        return chunks_[order_[rank >= 0 ? rank : numChunks() - 1]].ids.back();
+    }
+
+    /**
+     * @brief Inserts an element before the given position.
+     * @param pos The position of the new element, in [0, size()].
+     * @param value The element to insert.
+     * @return The id of the new element.
+     */
+    int insert(const int pos, T value) {
+        assert(pos >= 0 && pos <= size_);
+        if (order_.empty()) {
+            order_.push_back(newChunk());
+            reorder(0);
+        }
+        // Appending goes into the last chunk
+        const int last = order_.back();
+        const auto [handle, offset] = pos == size_ ? Location{last, static_cast<int>(chunks_[last].items.size())}
+                                                   : locate(pos);
+        const int rank = rank_[handle];
+        const int id = newId();
+        Chunk &chunk = chunks_[handle];
+        chunk.items.insert(chunk.items.begin() + offset, std::move(value));
+        chunk.ids.insert(chunk.ids.begin() + offset, id);
+        relocate(handle, offset);
+        size_++;
+        if (static_cast<int>(chunk.items.size()) < 2 * ChunkSize) {
+            sizes_.add(rank, 1);
+            return id;
+        }
+        // Split the chunk in two; the index has to be rebuilt, but only once every ChunkSize insertions
+        const int upperHandle = newChunk();
+        Chunk &lower = chunks_[handle];
+        Chunk &upper = chunks_[upperHandle];
+        upper.items.assign(std::make_move_iterator(lower.items.begin() + ChunkSize),
+                           std::make_move_iterator(lower.items.end()));
+        upper.ids.assign(lower.ids.begin() + ChunkSize, lower.ids.end());
+        lower.items.resize(ChunkSize);
+        lower.ids.resize(ChunkSize);
+        relocate(upperHandle, 0);
+        order_.insert(order_.begin() + rank + 1, upperHandle);
+        reorder(rank + 1);
+        return id;
+    }
+
+    /**
+     * @brief Removes the element at the given position. Its id may be reused by the next insertion.
+     * @param pos The position of the element to remove, in [0, size()).
+     */
+    void erase(const int pos) {
+        const auto [handle, offset] = locate(pos);
+        const int rank = rank_[handle];
+        Chunk &chunk = chunks_[handle];
+        freeIds_.push_back(chunk.ids[offset]);
+        chunk.items.erase(chunk.items.begin() + offset);
+        chunk.ids.erase(chunk.ids.begin() + offset);
+        relocate(handle, offset);
+        size_--;
+        const int chunkSize = static_cast<int>(chunk.items.size());
+        if (chunkSize == 0) {
+            freeChunk(handle);
+            order_.erase(order_.begin() + rank);
+            reorder(rank);
+            return;
+        }
+        // Merge small chunks with their successor, so that the number of chunks stays proportional to the size
+        if (chunkSize < ChunkSize / 4 && rank + 1 < numChunks() &&
+            chunkSize + static_cast<int>(chunks_[order_[rank + 1]].items.size()) <= ChunkSize) {
+            const int nextHandle = order_[rank + 1];
+            Chunk &next = chunks_[nextHandle];
+            chunk.items.insert(chunk.items.end(),
+                               std::make_move_iterator(next.items.begin()),
+                               std::make_move_iterator(next.items.end()));
+            chunk.ids.insert(chunk.ids.end(), next.ids.begin(), next.ids.end());
+            relocate(handle, chunkSize);
+            freeChunk(nextHandle);
+            order_.erase(order_.begin() + rank + 1);
+            reorder(rank + 1);
+            return;
+        }
+        sizes_.add(rank, -1);
+    }
+
+    [[nodiscard]] const_iterator begin() const { return {this, 0, 0}; }
+    [[nodiscard]] const_iterator end() const { return {this, numChunks(), 0}; }
+
+private:
+    using Chunk = struct Chunk {
+        std::vector<T> items;
+        std::vector<int> ids;
+    };
+    using Location = struct Location {
+        int chunk;
+        int offset;
+    };
+
+    // The chunks are identified by their index in chunks_, which does not change when chunks are split or merged
+    std::vector<Chunk> chunks_;
+    std::vector<int> freeChunks_;
+    // The chunks in order and the position of every chunk in that order
+    std::vector<int> order_;
+    std::vector<int> rank_;
+    // The sizes of the chunks in order
+    FenwickTree sizes_;
+    // The chunk and offset of every id
+    std::vector<Location> locations_;
+    std::vector<int> freeIds_;
+    int size_ = 0;
+
+    // Returns the chunk containing the element at the given position and the offset of the element in that chunk
+    [[nodiscard]] Location locate(const int pos) const {
+        assert(pos >= 0 && pos < size_);
+        int offset;
+        const int rank = sizes_.find(pos, offset);
+        return {order_[rank], offset};
+    }
+
+    int newChunk() {
+        int handle;
+        if (freeChunks_.empty()) {
+            handle = static_cast<int>(chunks_.size());
+            chunks_.emplace_back();
+            rank_.push_back(-1);
+        } else {
+            handle = freeChunks_.back();
+            freeChunks_.pop_back();
+        }
+        chunks_[handle].items.reserve(2 * ChunkSize);
+        chunks_[handle].ids.reserve(2 * ChunkSize);
+        return handle;
+    }
+
+    void freeChunk(const int handle) {
+        chunks_[handle].items.clear();
+        chunks_[handle].ids.clear();
+        freeChunks_.push_back(handle);
+    }
+
+    int newId() {
+        if (freeIds_.empty()) {
+            locations_.emplace_back();
+            return static_cast<int>(locations_.size()) - 1;
+        }
+        const int id = freeIds_.back();
+        freeIds_.pop_back();
+        return id;
+    }
+
+    // Updates the locations of the elements of a chunk from the given offset on, after these were shifted
+    void relocate(const int handle, const int from) {
+        const std::vector<int> &ids = chunks_[handle].ids;
+        for (int offset = from; offset < static_cast<int>(ids.size()); offset++) {
+            locations_[ids[offset]] = {handle, offset};
+        }
+    }
+
+    // Updates the positions of the chunks from the given one on and rebuilds the tree, after the order changed
+    void reorder(const int from) {
+        for (int rank = from; rank < numChunks(); rank++) {
+            rank_[order_[rank]] = rank;
+        }
+        sizes_.assign(numChunks(), [this](const int rank) {
+            return static_cast<int>(chunks_[order_[rank]].items.size());
+        });
+    }
+};
+
+} // namespace conis::core
@@ -4,9 +4,14 @@
 
 namespace conis::core {
 
-class Conic {
+/**
+ * @brief A conic section with coefficients of type S. The library works with Conic (S = real_t); the lower precision
+ * instantiations are used for the deepest subdivision levels (see SubdivisionSettings::fullPrecisionLevels).
+ */
+template<typename S>
+class BasicConic {
 public:
-    Conic() = default;
+    BasicConic() = default;
 
     // The conic matrix Q represents the coefficients of the general conic equation:
     // ax^2 + bxy + cy^2 + dx + ey + f = 0.
@@ -18,8 +23,8 @@ public:
     //
     // Note that the arguments here are therefore assumed to be:
     // ax^2 + 2bxy + cy^2 + 2dx + 2ey + f = 0.
-    Conic(real_t a, real_t b, real_t c, real_t d, real_t e, real_t f, real_t epsilon);
-    Conic(const Matrix3DD &Q, real_t epsilon);
+    BasicConic(S a, S b, S c, S d, S e, S f, S epsilon);
+    BasicConic(const Matrix3<S> &Q, S epsilon);
 
     /**
      * @brief Checks whether the ray with the given origin and direction intersects and samples the intersection point.
@@ -32,11 +37,11 @@ public:
      * @return true if the ray intersects
      * @return false otherwise
      */
-    bool sample(const Vector2DD &origin, const Vector2DD &direction, Vector2DD &point, Vector2DD &normal) const;
+    bool sample(const Vector2<S> &origin, const Vector2<S> &direction, Vector2<S> &point, Vector2<S> &normal) const;
 
     void printConic() const;
 
-    const Matrix3DD &getMatrix() { return Q_; }
+    const Matrix3<S> &getMatrix() { return Q_; }
 
     /**
      * @brief Checks whether the given ray intersects this conic.
@@ -47,15 +52,26 @@ public:
      * @return true if the ray intersects this conic.
      * @return false otherwise.
      */
-    bool intersects(const Vector2DD &ro, const Vector2DD &rd, real_t &t) const;
+    bool intersects(const Vector2<S> &ro, const Vector2<S> &rd, S &t) const;
 
-    [[nodiscard]] Vector2DD conicNormal(const Vector2DD &p, const Vector2DD &rd) const;
-    [[nodiscard]] Vector2DD conicNormal(const Vector2DD &p) const;
+    [[nodiscard]] Vector2<S> conicNormal(const Vector2<S> &p, const Vector2<S> &rd) const;
+    [[nodiscard]] Vector2<S> conicNormal(const Vector2<S> &p) const;
+
+    /**
+     * @brief Computes the (unsigned) curvature of the conic at the given point, which is assumed to lie on the conic.
+     * For the implicit curve F(x, y) = 0 this is |F_y^2 F_xx - 2 F_x F_y F_xy + F_x^2 F_yy| / |grad F|^3.
+     *
+     * @param p A point on the conic.
+     * @return The curvature of the conic at p. Zero for degenerate (straight line) conics.
+     */
+    [[nodiscard]] S curvature(const Vector2<S> &p) const;
 
 private:
-    Matrix3DD Q_;
+    Matrix3<S> Q_;
     bool valid_ = false;
-    real_t epsilon_ = 0;
+    S epsilon_ = 0;
 };
 
+using Conic = BasicConic<real_t>;
+
 } // namespace conis::core
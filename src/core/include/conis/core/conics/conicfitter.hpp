@@ -1,27 +1,47 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <Eigen/SVD>
 
 #include "conic.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
 
-class ConicFitter {
+/**
+ * @brief Fits a conic of scalar type S through a patch of points and normals. The system matrix and the SVD are kept
+ * between fits, so that fitting patches of the same size does not allocate (except for S = Dual, whose derivatives are
+ * computed in separate buffers).
+ */
+template<typename S>
+class BasicConicFitter {
 public:
-    explicit ConicFitter(real_t epsilon);
+    explicit BasicConicFitter(S epsilon);
 
-    Conic fitConic(const std::vector<PatchPoint> &patchPoints);
+    BasicConic<S> fitConic(const BasicPatchPoint<S> *patchPoints, int numPoints);
+
+    BasicConic<S> fitConic(const std::vector<BasicPatchPoint<S>> &patchPoints) {
+        return fitConic(patchPoints.data(), static_cast<int>(patchPoints.size()));
+    }
+
+    BasicConic<S> fitConic(const PatchPoints<S> &patchPoints) {
+        return fitConic(patchPoints.data(), static_cast<int>(patchPoints.size()));
+    }
 
 private:
     int numEq_ = 0;
     int numUnknowns_ = 0;
-    real_t epsilon_;
+    S epsilon_;
+    Eigen::MatrixX<S> A_;
+    Eigen::RowVectorX<S> row_;
+    Eigen::JacobiSVD<Eigen::MatrixX<S>> svd_;
+    Eigen::VectorX<S> coefs_;
 
-    [[nodiscard]] Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic> initAEigen(
-        const std::vector<PatchPoint> &patchPoints) const;
+    void initAEigen(const BasicPatchPoint<S> *patchPoints, int numPoints);
 
-    Eigen::VectorX<real_t> solveLinSystem(const Eigen::MatrixX<real_t> &A);
+    void solveLinSystem();
 };
 
+using ConicFitter = BasicConicFitter<real_t>;
+
 } // namespace conis::core
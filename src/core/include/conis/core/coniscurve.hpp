@@ -1,14 +1,25 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <unordered_set>
 
+#include "conis/core/changeset.hpp"
 #include "conis/core/conics/conic.hpp"
 #include "conis/core/curve/curve.hpp"
+#include "conis/core/curve/persistentcurve.hpp"
 #include "conis/core/curve/refinement/normalrefinementsettings.hpp"
 #include "conis/core/curve/refinement/normalrefiner.hpp"
 #include "conis/core/curve/subdivision/conicsubdivider.hpp"
 #include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/curvesnapshot.hpp"
+#include "conis/core/jobs/jobsystem.hpp"
 #include "conis/core/listener.hpp"
+#include "conis/core/memory.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
@@ -18,14 +29,64 @@ namespace conis::core {
  */
 class ConisCurve {
 public:
-    ConisCurve(const SubdivisionSettings &subdivSettings, const NormalRefinementSettings &normRefSettings);
+    /**
+     * @brief Creates an empty curve.
+     * @param subdivSettings The subdivision settings. Must outlive the curve.
+     * @param normRefSettings The normal refinement settings. Must outlive the curve.
+     * @param memoryResource The memory resource the subdivider and the normal refiner take their scratch memory from,
+     * e.g. a std::pmr::monotonic_buffer_resource per curve that is released in one go. With
+     * NormalRefinementSettings::parallel it is used from multiple threads, so it has to be thread-safe in that case.
+     * Must outlive the curve. If null, the curve uses a synchronized pool of its own.
+     */
+    ConisCurve(const SubdivisionSettings &subdivSettings,
+               const NormalRefinementSettings &normRefSettings,
+               std::pmr::memory_resource *memoryResource = nullptr);
+    ~ConisCurve();
 
     [[nodiscard]] const Curve &getControlCurve() const { return controlCurve_; }
-    [[nodiscard]] const Curve &getSubdivCurve() const { return subdivCurve_; }
+    /**
+     * @brief The subdivision curve of the latest snapshot. The reference is only valid until the next subdivision, so
+     * threads other than the one that owns this curve should use getSnapshot instead.
+     */
+    [[nodiscard]] const Curve &getSubdivCurve() const { return snapshot_->subdivCurve; }
     [[nodiscard]] int getSubdivLevel() const { return lastSubdivLevel_; }
+    /**
+     * @brief Returns the latest published snapshot. Every subdivision publishes a new snapshot instead of modifying
+     * the previous one, so the returned snapshot stays valid and unchanged for as long as it is held. Safe to call
+     * from any thread.
+     * @return The latest snapshot.
+     */
+    [[nodiscard]] std::shared_ptr<const CurveSnapshot> getSnapshot() const;
 
     void setControlCurve(Curve curve);
+    /**
+     * @brief Subdivides the control curve to the given level. The listeners are told that the entire subdivision
+     * curve changed, so call this when the level or the subdivision settings change. Edits of the control curve
+     * resubdivide by themselves and only report the points they affect.
+     * @param level The subdivision level.
+     */
     void subdivideCurve(int level);
+
+    /**
+     * @brief Returns the allocations made by the subdivider and the normal refiner of this curve from its memory
+     * resource (see the constructor). Only their scratch memory comes from this resource; the curves themselves use the
+     * global heap.
+     * @return The allocation statistics.
+     */
+    [[nodiscard]] AllocationStats getAllocationStats() const { return memoryResource_.stats(); }
+
+    /**
+     * @brief Starts a batch of edits. Until the matching commit, edits only modify the control curve: the subdivision
+     * and the notification of the listeners are postponed to the commit, where they happen once for the whole batch.
+     * The subdivision curve and the snapshot keep showing the state before the batch in the meantime. Batches can be
+     * nested; only the outermost commit resubdivides. Within a batch, addPoint and removePoint take O(log n), since
+     * the control curve uses chunked storage (see Curve::setChunkedStorageEnabled).
+     */
+    void beginEdit();
+    /**
+     * @brief Ends a batch of edits started by beginEdit and resubdivides if anything was edited.
+     */
+    void commit();
     int addPoint(const Vector2DD &p);
     void removePoint(int idx);
 
@@ -33,11 +94,63 @@ public:
     void recalculateNormal(int idx);
 
     void insertInflectionPoints();
+    /**
+     * @brief Subdivides the control curve again at the current level, e.g. after the subdivision settings changed.
+     * See subdivideCurve.
+     */
     void resubdivide();
     void refineNormals(CurvatureType curvatureType);
     void refineNormal(int idx, CurvatureType curvatureType);
-    void refineNormalsProgressively(CurvatureType curvatureType);
-    void refineNormalProgressively(int idx, CurvatureType curvatureType);
+
+    /**
+     * @brief Refines the normals of a copy of the control curve in the background. The refinement regularly publishes
+     * the normals of the copy; applyRefinementSnapshot copies the latest ones into the control curve. The inflection
+     * points are inserted into the control curve right away, as the refinement needs them. The settings are copied when
+     * the refinement starts. Starting a refinement cancels the previous one.
+     * @param curvatureType The curvature used to measure the smoothness.
+     * @return A handle to wait for or cancel the refinement.
+     */
+    JobHandle refineNormalsProgressively(CurvatureType curvatureType);
+    /**
+     * @brief Like refineNormalsProgressively, but refines a single normal as an interactive job.
+     */
+    JobHandle refineNormalProgressively(int idx, CurvatureType curvatureType);
+    /**
+     * @brief Replaces the normals of the control curve by the latest normals of a progressive refinement (if there are
+     * new ones) and resubdivides. Call this regularly from the thread that owns this curve while a refinement is
+     * running. Edits to the normals made since the refinement started are overwritten. The normals are discarded if
+     * points were added or removed in the meantime.
+     * @return True if refined normals were applied.
+     */
+    bool applyRefinementSnapshot();
+    /**
+     * @brief Cancels the progressive refinement (if any), waits for it to stop and discards its unapplied snapshot.
+     */
+    void cancelRefinement();
+
+    /**
+     * @brief Records the control curve as a step in the undo history, unless it was not edited since the current step.
+     * Call this before an edit; undo records the edited curve itself. Recording discards the steps that were undone.
+     * The edits are tracked per chunk of the control curve (see PersistentCurve), so only the edited chunks are copied
+     * and the curves are never compared. This keeps recording cheap and the history small for large curves.
+     */
+    void checkpoint();
+    /**
+     * @brief Restores the control curve of the previous step in the undo history. Unrecorded edits are recorded first,
+     * so that they can be redone. Cancels a running progressive refinement.
+     * @return True if there was a step to undo.
+     */
+    bool undo();
+    /**
+     * @brief Restores the control curve of the next step in the undo history, i.e. undoes the last undo. Edits made
+     * since the last undo discard the undone steps instead.
+     * @return True if there was a step to redo.
+     */
+    bool redo();
+    [[nodiscard]] bool canUndo() const;
+    [[nodiscard]] bool canRedo() const;
+    void clearHistory();
+    [[nodiscard]] int getHistorySize() const { return static_cast<int>(history_.size()); }
 
     void setControlCurveClosed(bool closed);
     void setVertexPosition(int idx, const Vector2DD &p);
@@ -48,18 +161,97 @@ public:
 
     void addListener(Listener *listener);
     void removeListener(Listener *listener);
+    /**
+     * @brief Delivers the pending changes to the listeners, or schedules their delivery if a notification scheduler
+     * was set.
+     */
     void notifyListeners();
+    /**
+     * @brief Delivers the changes made since the last delivery to the listeners in a single notification. Does
+     * nothing if there are no pending changes.
+     */
+    void flushNotifications();
+    /**
+     * @brief Coalesces change notifications: instead of notifying the listeners after every edit, the scheduler is
+     * called once for the first edit after a delivery. It should arrange for flushNotifications to be called later,
+     * e.g. when the next frame is drawn. Without a scheduler, listeners are notified after every edit.
+     * @param scheduler The scheduler, or an empty function to notify immediately again.
+     */
+    void setNotificationScheduler(std::function<void()> scheduler);
 
 private:
     const SubdivisionSettings &subdivSettings_;
     const NormalRefinementSettings &normRefSettings_;
     std::unordered_set<int> inflPointIndices_;
     std::vector<Listener *> listeners;
+    std::function<void()> notificationScheduler_;
+    bool notificationScheduled_ = false;
+    ChangeSet pendingChanges_;
+    // Scratch memory of the subdivider and the refiner, unless the caller supplies a resource. Synchronized, since the
+    // refiner may run in parallel.
+    std::pmr::synchronized_pool_resource memoryPool_;
+    CountingResource memoryResource_;
     ConicSubdivider subdivider_;
     NormalRefiner normalRefiner_;
     Curve controlCurve_;
-    Curve subdivCurve_;
+    // Only replaced atomically, so that getSnapshot can be called concurrently with subdivideCurve
+    std::shared_ptr<const CurveSnapshot> snapshot_;
+    // A previous snapshot that no reader holds anymore, whose buffers the next subdivision reuses
+    std::shared_ptr<CurveSnapshot> spareSnapshot_;
+    // The control points edited since the last subdivision
+    CurveChanges controlEdits_;
+    // Whether the entire subdivision curve changed since the last subdivision
+    bool subdivInvalidated_ = false;
+    // The inflection points inserted by the last subdivision, in the index space of the control curve with the
+    // inflection points inserted
+    std::vector<int> subdivInflPoints_;
     int lastSubdivLevel_ = 0;
+    // Nesting depth of the edit batches and whether a subdivision was postponed by one
+    int editDepth_ = 0;
+    bool subdivisionPending_ = false;
+    using HistoryStep = struct HistoryStep {
+        PersistentCurve controlCurve;
+        std::unordered_set<int> inflPointIndices;
+    };
+    std::vector<HistoryStep> history_;
+    // The step that corresponds to the control curve, unless it was edited since
+    int historyIdx_ = -1;
+    // The edits made to the control curve since the current history step
+    PersistentCurve::Edits historyEdits_;
+    JobHandle refinementJob_;
+    // Minimum time between two publications of the normals of a progressive refinement
+    static constexpr std::chrono::milliseconds publishInterval{50};
+    std::mutex snapshotMutex_;
+    std::optional<std::vector<Vector2DD>> refinedNormals_;
+
+    void prepareControlCurve();
+    void publishNormals(const std::vector<Vector2DD> &normals);
+    // Marks the control points with a custom normal as inflection points
+    void updateInflPointIndices();
+    void updateSubdivision();
+    void recordSubdivChanges(const Curve &previousSubdivCurve, const Curve &subdivCurve);
+    void recordEdit(int begin, int end);
+    void recordInsert(int idx);
+    void recordRemove(int idx);
+    void recordReplace();
+    template<typename S>
+    void subdivideCompact(int level, Curve &subdivCurve);
+    void restoreHistoryStep(int idx);
+};
+
+/**
+ * @brief Batches all edits made to a ConisCurve during its lifetime (see ConisCurve::beginEdit).
+ */
+class EditBatch {
+public:
+    explicit EditBatch(ConisCurve &conisCurve) : conisCurve_(conisCurve) { conisCurve_.beginEdit(); }
+    ~EditBatch() { conisCurve_.commit(); }
+
+    EditBatch(const EditBatch &) = delete;
+    EditBatch &operator=(const EditBatch &) = delete;
+
+private:
+    ConisCurve &conisCurve_;
 };
 
 } // namespace conis::core
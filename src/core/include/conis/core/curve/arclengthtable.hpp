@@ -0,0 +1,68 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "conis/core/curve/curve.hpp"
+#include "conis/core/vector.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief The cumulative arc length of a curve at every vertex, measured along its (straight) edges. Finding the point
+ * at a given arc length takes O(log n). The table refers to the curve it was built for, so it has to be rebuilt after
+ * the curve is edited and may not outlive the curve.
+ */
+class ArcLengthTable {
+public:
+    /**
+     * @brief Builds the table with a parallel prefix sum over the edge lengths.
+     * @param curve The curve to measure.
+     */
+    explicit ArcLengthTable(const Curve &curve);
+    // The table would refer to a destroyed curve
+    explicit ArcLengthTable(Curve &&curve) = delete;
+
+    /**
+     * @brief The arc length at every vertex. Closed curves have an extra entry for the edge back to the first vertex,
+     * so the last entry is always the total length.
+     */
+    [[nodiscard]] const std::vector<real_t> &getLengths() const { return lengths_; }
+    [[nodiscard]] real_t totalLength() const { return lengths_.empty() ? real_t(0) : lengths_.back(); }
+
+    /**
+     * @brief Finds the edge that contains the point at the given arc length.
+     * @param length The arc length. Clamped to [0, totalLength()].
+     * @return The index of the first vertex of the edge and how far along the edge the point lies, in [0, 1].
+     */
+    [[nodiscard]] std::pair<int, real_t> locate(real_t length) const;
+    [[nodiscard]] Vector2DD positionAt(real_t length) const;
+
+    /**
+     * @brief Returns the number of points uniformSamples creates for the given spacing, without sampling them.
+     * @param spacing The preferred distance between consecutive points along the curve. Must be positive.
+     * @return The number of points.
+     */
+    [[nodiscard]] int numUniformSamples(real_t spacing) const;
+    /**
+     * @brief Samples points that are spaced uniformly by arc length. The spacing is adjusted slightly such that it
+     * divides the total length: the samples of open curves start and end at the end points, those of closed curves
+     * start at the first vertex and are evenly spaced around the curve.
+     * @param spacing The preferred distance between consecutive points along the curve. Must be positive.
+     * @param points Filled with numUniformSamples(spacing) points. Reuses the buffer.
+     */
+    void uniformSamples(real_t spacing, std::vector<Vector2DD> &points) const;
+    /**
+     * @brief Resamples the curve uniformly by arc length (see uniformSamples). The normals of the resampled curve are
+     * recalculated.
+     * @param spacing The preferred distance between consecutive points along the curve. Must be positive.
+     * @return The resampled curve.
+     */
+    [[nodiscard]] Curve resample(real_t spacing) const;
+
+private:
+    const Curve &curve_;
+    std::vector<real_t> lengths_;
+};
+
+} // namespace conis::core
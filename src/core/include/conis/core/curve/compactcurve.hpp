@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "conis/core/curve/curvaturetype.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "conis/core/vector.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief A lightweight curve storing only vertices and normals with coordinates of type S.
+ * Used to store the deepest subdivision levels in a more compact format than Curve does.
+ *
+ * The coordinates are stored as a structure of arrays: the x and y coordinates of the vertices and of the normals each
+ * have their own aligned array. Loops over consecutive vertices can thus load a vector register at once rather than
+ * gathering interleaved coordinates, which is what the double and float kernels (recalculateNormals, calcCurvatures)
+ * rely on.
+ */
+template<typename S>
+class CompactCurve {
+public:
+    using Buffer = std::vector<S, Eigen::aligned_allocator<S>>;
+
+    CompactCurve() = default;
+
+    explicit CompactCurve(const Curve &curve) { assign(curve); }
+
+    /**
+     * @brief Replaces the contents of this curve by the (converted) vertices and normals of the given curve.
+     * @param curve The curve to copy.
+     */
+    void assign(const Curve &curve) {
+        closed_ = curve.isClosed();
+        const int n = curve.numPoints();
+        resize(n);
+        for (int i = 0; i < n; i++) {
+            setVertex(i, curve.getVertex(i).template cast<S>());
+            setNormal(i, curve.getNormal(i).template cast<S>());
+        }
+    }
+
+    /**
+     * @brief Converts this curve back to a regular curve.
+     * @return The converted curve.
+     */
+    [[nodiscard]] Curve toCurve() const {
+        Curve curve;
+        copyDataTo(curve);
+        return curve;
+    }
+
+    /**
+     * @brief Converts this curve into the given regular curve. Reuses the buffers of the curve.
+     * @param curve The curve to copy into.
+     */
+    void copyDataTo(Curve &curve) const {
+        const int n = numPoints();
+        curve.setClosed(closed_, false);
+        auto &verts = curve.getVertices();
+        auto &normals = curve.getNormals();
+        verts.resize(n);
+        normals.resize(n);
+        curve.getCustomNormals().assign(n, false);
+        for (int i = 0; i < n; i++) {
+            verts[i] = getVertex(i).template cast<real_t>();
+            normals[i] = getNormal(i).template cast<real_t>();
+        }
+    }
+
+    void copyDataTo(CompactCurve &other) const {
+        other.closed_ = closed_;
+        // Note that resize does not reduce capacity
+        other.resize(numPoints());
+        std::copy(x_.begin(), x_.end(), other.x_.begin());
+        std::copy(y_.begin(), y_.end(), other.y_.begin());
+        std::copy(normalX_.begin(), normalX_.end(), other.normalX_.begin());
+        std::copy(normalY_.begin(), normalY_.end(), other.normalY_.begin());
+    }
+
+    /**
+     * @brief Resizes all arrays to the given number of points. New points are zero-initialised.
+     * @param numPoints The new number of points.
+     */
+    void resize(const int numPoints) {
+        x_.resize(numPoints);
+        y_.resize(numPoints);
+        normalX_.resize(numPoints);
+        normalY_.resize(numPoints);
+    }
+
+    /**
+     * @brief Removes all points, but keeps the capacity of the arrays.
+     */
+    void clear() { resize(0); }
+
+    /**
+     * @brief Appends a point to the end of the curve.
+     * @param vertex The vertex of the point.
+     * @param normal The normal of the point.
+     */
+    void addPoint(const Vector2<S> &vertex, const Vector2<S> &normal) {
+        x_.push_back(vertex.x());
+        y_.push_back(vertex.y());
+        normalX_.push_back(normal.x());
+        normalY_.push_back(normal.y());
+    }
+
+    [[nodiscard]] Vector2<S> getVertex(const int idx) const { return {x_[idx], y_[idx]}; }
+    [[nodiscard]] Vector2<S> getNormal(const int idx) const { return {normalX_[idx], normalY_[idx]}; }
+
+    void setVertex(const int idx, const Vector2<S> &coord) {
+        x_[idx] = coord.x();
+        y_[idx] = coord.y();
+    }
+    void setNormal(const int idx, const Vector2<S> &normal) {
+        normalX_[idx] = normal.x();
+        normalY_[idx] = normal.y();
+    }
+
+    // Views of the coordinate arrays, which hold numPoints() elements each
+    [[nodiscard]] const S *getXs() const { return x_.data(); }
+    [[nodiscard]] const S *getYs() const { return y_.data(); }
+    [[nodiscard]] const S *getNormalXs() const { return normalX_.data(); }
+    [[nodiscard]] const S *getNormalYs() const { return normalY_.data(); }
+    [[nodiscard]] S *getXs() { return x_.data(); }
+    [[nodiscard]] S *getYs() { return y_.data(); }
+    [[nodiscard]] S *getNormalXs() { return normalX_.data(); }
+    [[nodiscard]] S *getNormalYs() { return normalY_.data(); }
+
+    /**
+     * @brief Recalculates all normals from the vertices, like Curve::recalculateNormals.
+     * Only available for double and float.
+     * @param areaWeightedNormals Whether to weigh the normals by the lengths of the adjacent edges.
+     * @param circleNormals Whether to use the normals of the osculating circles instead.
+     */
+    void recalculateNormals(bool areaWeightedNormals = false, bool circleNormals = false);
+
+    /**
+     * @brief Calculates the absolute curvature of the vertices [begin, end), like Curve::curvatureAtIdx.
+     * Only available for double and float.
+     * @param begin The first vertex.
+     * @param end One past the last vertex.
+     * @param curvatureType The curvature to compute.
+     * @param fastMath Whether to approximate the trigonometric functions.
+     * @param curvatures Receives the curvature of vertex i at curvatures[i].
+     */
+    void calcCurvatures(int begin, int end, CurvatureType curvatureType, bool fastMath, S *curvatures) const;
+
+    [[nodiscard]] int numPoints() const { return static_cast<int>(x_.size()); }
+    [[nodiscard]] bool isClosed() const { return closed_; }
+    void setClosed(const bool closed) { closed_ = closed; }
+
+    [[nodiscard]] int getNextIdx(const int idx) const {
+        const int n = numPoints();
+        if (closed_) {
+            return idx + 1 < n ? idx + 1 : 0;
+        }
+        return std::min(idx + 1, n - 1);
+    }
+
+    [[nodiscard]] int getPrevIdx(const int idx) const {
+        const int n = numPoints();
+        if (closed_) {
+            return idx - 1 >= 0 ? idx - 1 : n - 1;
+        }
+        return std::max(idx - 1, 0);
+    }
+
+private:
+    Buffer x_;
+    Buffer y_;
+    Buffer normalX_;
+    Buffer normalY_;
+    bool closed_ = true;
+};
+
+} // namespace conis::core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "conis/core/curve/compactcurve.hpp"
+#include "conis/core/curve/curvaturetype.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "conis/core/vector.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief Summary of the curvature along a curve. Only the vertices with a well-defined curvature are included: all
+ * vertices of a closed curve, and all vertices apart from the end points of an open curve.
+ */
+using CurvatureStats = struct CurvatureStats {
+    real_t max = 0;
+    real_t mean = 0;
+    // The sum of the curvature differences between consecutive vertices
+    real_t totalVariation = 0;
+    // The largest curvature difference between consecutive vertices, namely between maxJumpIdx and the vertex after it
+    real_t maxJump = 0;
+    int maxJumpIdx = -1;
+};
+
+using CurvatureProfile = struct CurvatureProfile {
+    CurvatureType curvatureType = AREA_INFLATION;
+    // The absolute curvature at every vertex, computed like Curve::curvatureAtIdx
+    std::vector<real_t> curvatures;
+    CurvatureStats stats;
+};
+
+/**
+ * @brief Computes the curvature at every vertex of the curve together with its statistics in a single pass. Large
+ * curves are processed in parallel blocks; the result does not depend on the number of threads.
+ * @param curve The curve.
+ * @param curvatureType The curvature to compute.
+ * @param profile Filled with the curvatures and their statistics. The buffer of the curvatures is reused.
+ * @param fastMath Whether to approximate the trigonometric functions (see Curve::curvatureAtIdx).
+ */
+void computeCurvatureProfile(const Curve &curve,
+                             CurvatureType curvatureType,
+                             CurvatureProfile &profile,
+                             bool fastMath = false);
+CurvatureProfile computeCurvatureProfile(const Curve &curve, CurvatureType curvatureType, bool fastMath = false);
+
+/**
+ * @brief Like computeCurvatureProfile, but computes the profiles of all curvature types in the same pass.
+ * @param curve The curve.
+ * @param fastMath Whether to approximate the trigonometric functions.
+ * @return The profiles, indexed by CurvatureType.
+ */
+std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const Curve &curve, bool fastMath = false);
+
+/**
+ * @brief Like computeCurvatureProfile for a regular curve, but computes the curvatures in the precision of the compact
+ * curve. Instantiated for double and float.
+ */
+template<typename S>
+void computeCurvatureProfile(const CompactCurve<S> &curve,
+                             CurvatureType curvatureType,
+                             CurvatureProfile &profile,
+                             bool fastMath = false);
+
+/**
+ * @brief Like computeCurvatureProfiles for a regular curve, but computes the curvatures in the precision of the compact
+ * curve. Instantiated for double and float.
+ */
+template<typename S>
+std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const CompactCurve<S> &curve,
+                                                                         bool fastMath = false);
+
+} // namespace conis::core
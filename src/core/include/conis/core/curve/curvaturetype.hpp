@@ -7,4 +7,6 @@ namespace conis::core {
  */
 enum CurvatureType { CIRCLE_RADIUS, DISCRETE_WINDING, GRADIENT_ARC_LENGTH, AREA_INFLATION };
 
+constexpr int numCurvatureTypes = 4;
+
 } // namespace conis::core
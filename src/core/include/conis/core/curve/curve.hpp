@@ -1,15 +1,29 @@
 #pragma once
 
+#include <cstdint>
 #include <set>
 #include <utility>
+#include <vector>
 
+#include "conis/core/chunkedsequence.hpp"
 #include "conis/core/curve/curvaturetype.hpp"
+#include "conis/core/curve/spatialgrid.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
 
 class Settings;
 
+/**
+ * @brief A point of a curve with everything that belongs to it, as stored in chunks by Curve (see
+ * Curve::setChunkedStorageEnabled) and PersistentCurve.
+ */
+using ControlPoint = struct ControlPoint {
+    Vector2DD vertex;
+    Vector2DD normal;
+    bool customNormal = false;
+};
+
 /**
  * @brief The Curve class is a basic representation of a 2D curve.
  */
@@ -29,25 +43,109 @@ public:
     void copyDataTo(Curve &other) const;
 
     // TODO: don't define these in the header files and add additional checks to them
-    [[nodiscard]] const std::vector<Vector2DD> &getVertices() const { return vertices_; }
-    [[nodiscard]] const std::vector<Vector2DD> &getNormals() const { return normals_; }
-    [[nodiscard]] const std::vector<bool> &getCustomNormals() const { return customNormals_; }
-    [[nodiscard]] const Vector2DD &getVertex(const int idx) const { return vertices_[idx]; }
-    [[nodiscard]] const Vector2DD &getNormal(const int idx) const { return normals_[idx]; }
-    [[nodiscard]] bool isCustomNormal(const int idx) const { return customNormals_[idx]; }
-
-    [[nodiscard]] std::vector<Vector2DD> &getVertices() { return vertices_; }
-    [[nodiscard]] std::vector<Vector2DD> &getNormals() { return normals_; }
-    [[nodiscard]] Vector2DD &getVertex(const int idx) { return vertices_[idx]; }
-    [[nodiscard]] Vector2DD &getNormal(const int idx) { return normals_[idx]; }
-    [[nodiscard]] std::vector<bool> &getCustomNormals() { return customNormals_; }
-
-    void setCoords(const std::vector<Vector2DD> &verts) { vertices_ = verts; }
-    void setNormals(const std::vector<Vector2DD> &normals) { normals_ = normals; }
+    // In chunked storage mode, the arrays are brought up to date first; see syncArrays
+    [[nodiscard]] const std::vector<Vector2DD> &getVertices() const {
+        syncArrays();
+        return vertices_;
+    }
+    [[nodiscard]] const std::vector<Vector2DD> &getNormals() const {
+        syncArrays();
+        return normals_;
+    }
+    [[nodiscard]] const std::vector<uint8_t> &getCustomNormals() const {
+        syncArrays();
+        return customNormals_;
+    }
+    [[nodiscard]] const Vector2DD &getVertex(const int idx) const { return vertexAt(idx); }
+    [[nodiscard]] const Vector2DD &getNormal(const int idx) const { return normalAt(idx); }
+    [[nodiscard]] bool isCustomNormal(const int idx) const { return customNormalAt(idx); }
+
+    // Modifications through these references are not tracked; see invalidateSpatialIndex. In chunked storage mode, the
+    // curve moves its points back into the arrays first, which costs O(n) once.
+    [[nodiscard]] std::vector<Vector2DD> &getVertices() {
+        useArrays();
+        return vertices_;
+    }
+    [[nodiscard]] std::vector<Vector2DD> &getNormals() {
+        useArrays();
+        return normals_;
+    }
+    [[nodiscard]] Vector2DD &getVertex(const int idx) {
+        useArrays();
+        return vertices_[idx];
+    }
+    [[nodiscard]] Vector2DD &getNormal(const int idx) {
+        useArrays();
+        return normals_[idx];
+    }
+    [[nodiscard]] std::vector<uint8_t> &getCustomNormals() {
+        useArrays();
+        return customNormals_;
+    }
+
+    void setCoords(const std::vector<Vector2DD> &verts) {
+        useArrays();
+        vertices_ = verts;
+        invalidateSpatialIndex();
+    }
+    void setNormals(const std::vector<Vector2DD> &normals) {
+        useArrays();
+        normals_ = normals;
+        invalidateSpatialIndex();
+    }
 
     void setVertex(int idx, const Vector2DD &coord);
     void setNormal(int idx, const Vector2DD &normal);
-    void setCustomNormals(std::vector<bool> customNormals) { customNormals_ = std::move(customNormals); }
+    void setCustomNormals(std::vector<uint8_t> customNormals) {
+        useArrays();
+        customNormals_ = std::move(customNormals);
+    }
+
+    /**
+     * @brief Enables or disables the chunked storage of the points, which is meant for editing very large curves. The
+     * points are then stored in a ChunkedSequence, so that addPoint and removePoint take O(log n) instead of shifting
+     * all points after the edited one, and the spatial index refers to the points by their ids in that sequence, so
+     * that it does not need to renumber them either. The contiguous arrays are kept as a copy that is brought up to
+     * date on demand (see syncArrays), e.g. once after a batch of edits before subdividing. Reading a point by index
+     * takes O(log n) while the copy is out of date.
+     *
+     * The curve switches to chunked storage on the first addPoint or removePoint. Modifications of all points at once
+     * (recalculateNormals, translate, the non-const accessors, ...) work on the arrays and switch back, both of which
+     * cost O(n). Note that, like the spatial index, the copy is updated by const functions, which are therefore not
+     * thread-safe while it is out of date.
+     * @param enabled Whether to use chunked storage.
+     */
+    void setChunkedStorageEnabled(bool enabled);
+    [[nodiscard]] bool isChunkedStorageEnabled() const { return chunkedStorageEnabled_; }
+    /**
+     * @brief In chunked storage mode, copies the points into the contiguous arrays if they were edited since the last
+     * copy, so that reading them by index takes O(1) again. Does nothing otherwise.
+     */
+    void syncArrays() const {
+        if (chunked_ && !arraysValid_) {
+            copyPointsToArrays();
+        }
+    }
+
+    /**
+     * @brief Enables or disables the spatial index used by the findClosest* functions and addPoint. The index is a
+     * uniform grid over the vertices and edges, which turns these linear scans into local searches. It is built on the
+     * first query and then updated incrementally by setVertex, setVertexPosition, addPoint and removePoint; other
+     * modifications cause a rebuild on the next query. Note that queries on a curve whose index is out of date are not
+     * thread-safe.
+     * @param enabled Whether to use the spatial index.
+     */
+    void setSpatialIndexEnabled(bool enabled);
+    [[nodiscard]] bool isSpatialIndexEnabled() const { return spatialIndexEnabled_; }
+    /**
+     * @brief Marks the spatial index as out of date, so that the next query rebuilds it. Call this after modifying the
+     * vertices or normals through the non-const accessors, as these modifications are not tracked.
+     */
+    void invalidateSpatialIndex() {
+        if (spatialIndexEnabled_) {
+            spatialIndexValid_ = false;
+        }
+    }
 
     [[nodiscard]] int findClosestEdge(const Vector2DD &p, double maxDist) const;
     [[nodiscard]] int findClosestVertex(const Vector2DD &p, double maxDist) const;
@@ -67,24 +165,98 @@ public:
 
     void recalculateNormals(bool areaWeightedNormals = false, bool circleNormals = false);
     void recalculateNormal(int idx);
+    /**
+     * @brief Recalculates the normals of the vertices [begin, end) in place, e.g. after moving a run of vertices. Like
+     * recalculateNormal, this resets the custom normal flags of these vertices. The normals just outside the range are
+     * not updated.
+     * @param begin The first vertex to recalculate.
+     * @param end One past the last vertex to recalculate.
+     */
+    void recalculateNormalRange(int begin, int end);
 
     void setClosed(bool closed, bool recalculate = true);
     void translate(const Vector2DD &translation);
     int numPoints() const;
-    real_t curvatureAtIdx(int idx, CurvatureType curvatureType) const;
+    real_t curvatureAtIdx(int idx, CurvatureType curvatureType, bool fastMath = false) const;
 
 private:
-    std::vector<Vector2DD> vertices_;
-    std::vector<Vector2DD> normals_;
-    std::vector<bool> customNormals_;
+    // In chunked storage mode, a copy of the points that is only valid if arraysValid_ is set
+    mutable std::vector<Vector2DD> vertices_;
+    mutable std::vector<Vector2DD> normals_;
+    // One byte per flag rather than std::vector<bool>, so that the flags can be copied and accessed without bit proxies
+    mutable std::vector<uint8_t> customNormals_;
+
+    bool chunkedStorageEnabled_ = false;
+    // Whether the points are stored in points_ rather than in the arrays, see setChunkedStorageEnabled. The spatial
+    // index then refers to the points by their ids in points_.
+    bool chunked_ = false;
+    mutable bool arraysValid_ = true;
+    ChunkedSequence<ControlPoint> points_;
 
     bool closed_ = true;
     bool areaWeightedNormals_ = true;
     bool circleNormals_ = false;
 
+    bool spatialIndexEnabled_ = false;
+    mutable bool spatialIndexValid_ = false;
+    // Edges are identified by their start vertex. The vertices are identified by their index, or by their id in chunked
+    // storage mode.
+    mutable SpatialGrid vertexGrid_;
+    mutable SpatialGrid edgeGrid_;
+    // An upper bound of the lengths of the normals, which determines how far a normal handle can be from its vertex
+    mutable real_t maxNormalLength_ = 0;
+
+    [[nodiscard]] bool readArrays() const { return !chunked_ || arraysValid_; }
+    // Like the const accessors, for use in non-const member functions
+    [[nodiscard]] const Vector2DD &vertexAt(const int idx) const {
+        return readArrays() ? vertices_[idx] : points_[idx].vertex;
+    }
+    [[nodiscard]] const Vector2DD &normalAt(const int idx) const {
+        return readArrays() ? normals_[idx] : points_[idx].normal;
+    }
+    [[nodiscard]] bool customNormalAt(const int idx) const {
+        return readArrays() ? customNormals_[idx] != 0 : points_[idx].customNormal;
+    }
+    void useArrays() {
+        if (chunked_) {
+            leaveChunkedStorage();
+        }
+    }
+    void enterChunkedStorage();
+    void leaveChunkedStorage();
+    void copyPointsToArrays() const;
+    // Setters of a single point that write to the points and to the arrays, as far as these are in use
+    void storeVertex(int idx, const Vector2DD &vertex);
+    void storeNormal(int idx, const Vector2DD &normal);
+    void storeCustomNormal(int idx, bool customNormal);
+
+    // The id of the vertex (or of the edge starting at it) in the spatial index
+    [[nodiscard]] int gridId(const int idx) const { return chunked_ ? points_.idAt(idx) : idx; }
+    [[nodiscard]] int gridIdToIdx(const int id) const { return chunked_ && id >= 0 ? points_.indexOf(id) : id; }
+    // Breaks ties in the spatial index by index, as the linear scans do
+    [[nodiscard]] auto gridOrder() const {
+        return [this](const int id) { return gridIdToIdx(id); };
+    }
+    [[nodiscard]] const Vector2DD &gridVertex(const int id) const {
+        return chunked_ ? points_.byId(id).vertex : vertices_[id];
+    }
+    [[nodiscard]] const Vector2DD &gridNormal(const int id) const {
+        return chunked_ ? points_.byId(id).normal : normals_[id];
+    }
+    // The end of the edge with the given id
+    [[nodiscard]] const Vector2DD &gridEdgeEnd(const int id) const {
+        return chunked_ ? points_.byId(points_.nextId(id)).vertex : vertices_[getNextIdx(id)];
+    }
+    [[nodiscard]] bool isSpatialIndexUpToDate() const { return spatialIndexEnabled_ && spatialIndexValid_; }
+    void buildSpatialIndex() const;
+    void updateSpatialIndex(int idx, bool insert) const;
+    void includeNormalLength(const Vector2DD &normal) const;
+
     Vector2DD getClosestPointOnLineSegment(const Vector2DD &start, const Vector2DD &end, const Vector2DD &point) const;
-    [[nodiscard]] std::vector<Vector2DD> calcNormals(const std::vector<Vector2DD> &verts) const;
-    [[nodiscard]] Vector2DD calcNormalAtIndex(const std::vector<Vector2DD> &verts, int i) const;
+    // Calculates the normals of the vertices [begin, end) into normals_, which should already have the right size
+    void calcNormals(int begin, int end);
+    // Calculates the normal of the vertex at idx
+    void calcNormal(int idx);
     [[nodiscard]] int findInsertIdx(const Vector2DD &p) const;
 };
 
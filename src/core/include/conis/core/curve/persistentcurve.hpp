@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "conis/core/curve/curve.hpp"
+#include "conis/core/fenwicktree.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief An immutable version of a control curve that shares its storage with other versions. The points are stored in
+ * chunks that are never modified once created. A version created from a previous one reuses the chunks that were not
+ * edited, so it only allocates new chunks for the edited part. This makes it cheap to keep many versions of a large
+ * curve, e.g. for an undo history.
+ */
+class PersistentCurve {
+public:
+    using ControlPoint = conis::core::ControlPoint;
+    using Chunk = std::vector<ControlPoint>;
+    // The preferred number of points per chunk
+    static constexpr int chunkSize = 512;
+
+    /**
+     * @brief Records which chunks of a version are affected by the edits made to the curve since it was stored. Every
+     * edit costs O(log n) plus the number of chunks a changed range covers, so that recording the edits keeps up with
+     * the chunked storage of Curve. Creating the next version from them does not need to compare the curves.
+     */
+    class Edits {
+    public:
+        Edits() = default;
+        /**
+         * @brief Starts recording the edits made to the curve stored in the given version.
+         * @param base The version the edits are relative to.
+         */
+        explicit Edits(const PersistentCurve &base);
+
+        /**
+         * @brief Marks the points in [begin, end) as changed.
+         */
+        void pointsChanged(int begin, int end);
+        /**
+         * @brief Records that a point was inserted at idx, after the points before it were edited as recorded.
+         */
+        void pointInserted(int idx);
+        /**
+         * @brief Records that the point at idx was removed, after the points before it were edited as recorded.
+         */
+        void pointRemoved(int idx);
+        /**
+         * @brief Marks the entire curve as changed, e.g. when it was replaced or its closedness changed.
+         */
+        void curveReplaced();
+        [[nodiscard]] bool empty() const { return !edited_; }
+
+    private:
+        friend class PersistentCurve;
+        // The number of points every chunk of the base version has in the edited curve
+        std::vector<int> chunkSizes_;
+        FenwickTree chunkSizeTree_;
+        std::vector<uint8_t> dirty_;
+        int numPoints_ = 0;
+        bool replaced_ = true;
+        bool edited_ = false;
+
+        // The chunk that contains the point at idx, or -1 if there is none
+        [[nodiscard]] int findChunk(int idx) const;
+    };
+
+    PersistentCurve() = default;
+    explicit PersistentCurve(const Curve &curve);
+    /**
+     * @brief Creates a version of the curve that shares the chunks that were not edited with a previous version. Only
+     * the edited chunks are copied from the curve.
+     * @param curve The curve to store.
+     * @param previous The previous version of the curve.
+     * @param edits The edits made to the curve since the previous version.
+     */
+    PersistentCurve(const Curve &curve, const PersistentCurve &previous, const Edits &edits);
+
+    [[nodiscard]] Curve toCurve() const;
+    /**
+     * @brief Copies the points into a regular curve. Reuses the buffers of the curve.
+     * @param curve The curve to copy into.
+     */
+    void copyDataTo(Curve &curve) const;
+    /**
+     * @brief Checks whether this version stores exactly the given curve.
+     * @param curve The curve to compare with.
+     * @return True if the points, normals, custom normal flags and closedness are the same.
+     */
+    [[nodiscard]] bool matches(const Curve &curve) const;
+
+    [[nodiscard]] int numPoints() const { return numPoints_; }
+    [[nodiscard]] bool isClosed() const { return closed_; }
+    [[nodiscard]] int numChunks() const { return static_cast<int>(chunks_.size()); }
+    [[nodiscard]] const std::vector<std::shared_ptr<const Chunk>> &getChunks() const { return chunks_; }
+    /**
+     * @brief Returns how many chunks of this version are shared with the other version.
+     * @param other The other version.
+     * @return The number of shared chunks.
+     */
+    [[nodiscard]] int numSharedChunks(const PersistentCurve &other) const;
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> chunks_;
+    int numPoints_ = 0;
+    bool closed_ = true;
+
+    // Appends the points [begin, end) of the curve in new chunks of at most chunkSize points
+    void appendChunks(const Curve &curve, int begin, int end);
+};
+
+} // namespace conis::core
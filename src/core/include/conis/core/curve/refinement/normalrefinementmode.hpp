@@ -0,0 +1,10 @@
+#pragma once
+
+namespace conis::core {
+
+/**
+ * @brief How the normal refinement optimises the normals of the control points
+ */
+enum NormalRefinementMode { SEQUENTIAL, GLOBAL };
+
+} // namespace conis::core
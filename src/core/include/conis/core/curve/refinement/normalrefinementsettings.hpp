@@ -1,13 +1,46 @@
 #pragma once
 
+#include "conis/core/curve/refinement/normalrefinementmode.hpp"
+#include "conis/core/curve/refinement/normalsearchmethod.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
 
 using NormalRefinementSettings = struct NormalRefinementSettings {
+    // SEQUENTIAL searches the best normal of one vertex at a time for at most maxRefinementIterations sweeps over the
+    // curve.
+    // GLOBAL minimises the smoothness energy of the entire curve over all normal angles at once using L-BFGS.
+    NormalRefinementMode mode = SEQUENTIAL;
     int maxRefinementIterations = 1;
+    // A sweep only visits the vertices whose influence window contains a normal that rotated by more than
+    // convergenceAngle (in radians) since the vertex was last refined, and the sequential refinement stops once there
+    // are none. A negative angle visits every vertex in every sweep.
+    real_t convergenceAngle = 1e-6;
+    // BISECTION halves the search angle until it is below angleLimit. BRENT minimises the smoothed penalty
+    // ((p - 1) / (p + 1))^2 and stops when the bracket of the optimal angle is smaller than angleLimit, or when the
+    // smoothed penalty improved by less than a relative penaltyTolerance in the last evaluations.
+    NormalSearchMethod searchMethod = BRENT;
     real_t angleLimit = 0.00001;
+    real_t penaltyTolerance = 1e-9;
     int testSubdivLevel = 6;
+    // Measures the smoothness using the exact curvature of the conics that the neighbours of the tested vertex were
+    // sampled from, instead of a discrete estimate of the requested curvature type. The penalty still depends on
+    // testSubdivLevel, as it compares the curvature at points 2^-testSubdivLevel of an edge away from the vertex.
+    bool analyticCurvature = false;
+    // Only subdivide the control points that influence the curvature around the tested vertex instead of the whole
+    // curve. This gives the same results, but makes the cost per step independent of the curve size.
+    bool windowedEvaluation = true;
+    // Evaluates both candidate normals of a search step concurrently. Combined with windowed evaluation, also refines
+    // vertices whose windows do not overlap concurrently. This changes the order in which the vertices are refined, so
+    // the result differs from the sequential one, but it does not depend on the number of threads. In the global mode,
+    // evaluates the finite differences of the gradient concurrently.
+    bool parallel = false;
+    // The global optimisation stops after maxGlobalIterations, when the largest gradient component drops below
+    // gradientTolerance or when the energy improved by less than a relative penaltyTolerance in the last iteration.
+    int maxGlobalIterations = 50;
+    real_t gradientTolerance = 1e-4;
+    // Angle (in radians) of the central finite differences that approximate the gradient of the global energy
+    real_t finiteDifferenceStep = 1e-6;
 };
 
 } // namespace conis::core
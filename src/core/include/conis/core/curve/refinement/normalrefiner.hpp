@@ -1,10 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
 #include "conis/core/curve/curvaturetype.hpp"
 #include "conis/core/curve/curve.hpp"
 #include "conis/core/curve/refinement/normalrefinementsettings.hpp"
 #include "conis/core/curve/subdivision/conicsubdivider.hpp"
 #include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/jobs/cancellationtoken.hpp"
+#include "conis/core/progress.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
@@ -13,16 +21,114 @@ class NormalRefiner {
 public:
     explicit NormalRefiner(const NormalRefinementSettings &normRefSettings, const SubdivisionSettings &subdivSettings);
 
-    void refine(Curve &curve, CurvatureType curvatureType);
+    /**
+     * @brief Refines all normals of the curve. Inserts the inflection points first.
+     * @param curve The curve to refine.
+     * @param curvatureType The curvature used to measure the smoothness.
+     * @param cancellation Checked after every vertex (or colour round) and global iteration. A cancelled refinement
+     * returns early and leaves the curve partially refined.
+     */
+    void refine(Curve &curve, CurvatureType curvatureType, const CancellationToken &cancellation = {});
     void refineSelected(Curve &curve, CurvatureType curvatureType, int idx);
 
+    /**
+     * @brief Returns the number of smoothness penalty evaluations (i.e. test subdivisions) since the last reset.
+     * @return The number of penalty evaluations.
+     */
+    [[nodiscard]] uint64_t getNumEvaluations() const { return numEvaluations_.load(std::memory_order_relaxed); }
+    void resetNumEvaluations() { numEvaluations_.store(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the callback that receives the progress of refine: the vertices processed in the current sweep, or
+     * the iterations of the global mode.
+     * @param callback The progress callback. An empty function disables progress reporting.
+     */
+    void setProgressCallback(ProgressCallback callback) { progressCallback_ = std::move(callback); }
+
+    /**
+     * @brief Sets the memory resource of the scratch buffers of the refinement and of the patch buffers of the test
+     * subdivisions. With NormalRefinementSettings::parallel, the resource is used from multiple threads, so it has to be
+     * thread-safe (e.g. std::pmr::synchronized_pool_resource). The test curves (the copied windows) are Curves, which
+     * always use the global heap. They are kept per workspace and only allocate when a window is larger than before.
+     * @param resource The memory resource. Must outlive the refiner.
+     */
+    void setMemoryResource(std::pmr::memory_resource *resource);
+
 private:
+    // The state needed to evaluate a single candidate normal. Concurrent evaluations each use their own workspace.
+    struct Workspace {
+        explicit Workspace(const SubdivisionSettings &subdivSettings) : subdivider(subdivSettings) {}
+
+        ConicSubdivider subdivider;
+        Curve testCurve;
+        // The analytic curvatures of the subdivided test curve (only with analytic curvature)
+        std::vector<real_t> curvatures;
+        // The smoothness energy of every control point (only in the global mode)
+        std::vector<real_t> energies;
+    };
+
     const NormalRefinementSettings &normRefSettings_;
+    const SubdivisionSettings &subdivSettings_;
     ConicSubdivider subdivider_;
-    Curve testCurve_;
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+    // Two per thread: one for each candidate normal
+    std::vector<Workspace> workspaces_;
+    std::atomic<uint64_t> numEvaluations_{0};
+    ProgressCallback progressCallback_;
+    // The token of the refinement in progress
+    CancellationToken cancellation_;
 
-    real_t smoothnessPenalty(const Curve &curve, int idx, CurvatureType curvatureType) const;
-    void binarySearchBestNormal(Curve &curve, int idx, bool inflectionPoint, CurvatureType curvatureType);
+    real_t smoothnessPenalty(const Curve &curve,
+                             int idx,
+                             CurvatureType curvatureType,
+                             const std::vector<real_t> *curvatures = nullptr) const;
+    [[nodiscard]] bool useAnalyticCurvature() const;
+    [[nodiscard]] int windowRadius() const;
+    int copyTestCurve(const Curve &curve, int idx, Curve &testCurve) const;
+    real_t candidatePenalty(const Curve &curve,
+                            int idx,
+                            const Vector2DD &candidate,
+                            CurvatureType curvatureType,
+                            Workspace &workspace);
+    Vector2DD bisectorNormal(const Curve &curve, int idx, real_t &cosAngle) const;
+    [[nodiscard]] Vector2DD rotate(const Vector2DD &normal, real_t radians) const;
+    void searchBestNormal(Curve &curve,
+                          int idx,
+                          bool inflectionPoint,
+                          CurvatureType curvatureType,
+                          Workspace *candidateWorkspaces);
+    Vector2DD bisectionSearch(const Curve &curve,
+                              int idx,
+                              Vector2DD normal,
+                              real_t angle,
+                              CurvatureType curvatureType,
+                              Workspace *candidateWorkspaces);
+    Vector2DD brentSearch(const Curve &curve,
+                          int idx,
+                          const Vector2DD &normal,
+                          real_t range,
+                          CurvatureType curvatureType,
+                          Workspace &workspace);
+    bool refineVertex(Curve &curve, int idx, CurvatureType curvatureType, Workspace *candidateWorkspaces);
+    void markWindowDirty(const Curve &curve, int idx, std::pmr::vector<uint8_t> &dirty) const;
+    int refineIteration(Curve &curve, CurvatureType curvatureType, std::pmr::vector<uint8_t> &dirty);
+    void evaluateEnergies(const Curve &curve,
+                          const std::pmr::vector<Vector2DD> &baseNormals,
+                          const VectorXDD &angles,
+                          CurvatureType curvatureType,
+                          Workspace &workspace);
+    real_t globalEnergy(const Curve &curve,
+                        const std::pmr::vector<Vector2DD> &baseNormals,
+                        const VectorXDD &angles,
+                        CurvatureType curvatureType);
+    void globalGradient(const Curve &curve,
+                        const std::pmr::vector<Vector2DD> &baseNormals,
+                        const VectorXDD &angles,
+                        CurvatureType curvatureType,
+                        VectorXDD &gradient);
+    void refineGlobal(Curve &curve, CurvatureType curvatureType);
+    void reserveWorkspaces(int numThreads);
+    void reportProgress(std::string_view task, int done, int total) const;
 };
 
 } // namespace conis::core
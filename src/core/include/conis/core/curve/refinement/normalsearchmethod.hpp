@@ -0,0 +1,10 @@
+#pragma once
+
+namespace conis::core {
+
+/**
+ * @brief The 1D optimisers the normal refinement can use to find the angle of a normal
+ */
+enum NormalSearchMethod { BISECTION, BRENT };
+
+} // namespace conis::core
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "conis/core/vector.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief Uniform grid over the bounding boxes of a set of items identified by (non-negative) integers, used to find
+ * the item closest to a point without visiting all items. Items are stored in every cell their bounding box overlaps;
+ * items overlapping many cells are stored in a separate list that is always visited instead.
+ */
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+
+    /**
+     * @brief Removes all items and sets the cell size.
+     * @param cellSize The width and height of the cells. Ideally in the order of the size of a single item.
+     */
+    void reset(double cellSize);
+
+    void insert(int id, const Vector2DD &min, const Vector2DD &max);
+    /**
+     * @brief Removes an item. The bounding box must be the one the item was inserted with.
+     */
+    void remove(int id, const Vector2DD &min, const Vector2DD &max);
+    /**
+     * @brief Adds delta to all ids greater than or equal to from. Used when items identified by their index are
+     * inserted or removed in the middle of a sequence, which takes O(n). Items with stable ids (see ChunkedSequence) do
+     * not need this.
+     */
+    void shiftIds(int from, int delta);
+
+    /**
+     * @brief Finds the item with the smallest distance to p, visiting the cells in rings of increasing distance around
+     * p. Ties are broken in favour of the item that comes first in the given order, so that the result is the same as
+     * that of a linear scan over the items in that order.
+     * @param p The query point.
+     * @param maxDist Items at a distance of maxDist or more are ignored.
+     * @param slack By how much the distance of an item may be smaller than the distance of p to its bounding box.
+     * @param distance Returns the distance of p to the item with the given id.
+     * @param order Returns the position of the item with the given id in the order of the linear scan, e.g. the id
+     * itself if the ids are indices. Only called for ties.
+     * @param minDist Is set to the distance of the item found.
+     * @return The id of the closest item, or -1 if there is no item closer than maxDist.
+     */
+    template<typename DistanceFn, typename OrderFn>
+    int findNearest(const Vector2DD &p,
+                    real_t maxDist,
+                    real_t slack,
+                    DistanceFn distance,
+                    OrderFn order,
+                    real_t &minDist) const;
+
+private:
+    // Items spanning more than this many cells are not stored in the cells
+    static constexpr int64_t maxCellsPerItem = 64;
+
+    double cellSize_ = 1.0;
+    std::unordered_map<int64_t, std::vector<int>> cells_;
+    std::vector<int> oversized_;
+    // Bounds of the cells that have ever been occupied
+    int minX_ = std::numeric_limits<int>::max();
+    int minY_ = std::numeric_limits<int>::max();
+    int maxX_ = std::numeric_limits<int>::min();
+    int maxY_ = std::numeric_limits<int>::min();
+
+    [[nodiscard]] int cellCoord(real_t coord) const;
+    [[nodiscard]] static int64_t cellKey(int x, int y);
+};
+
+template<typename DistanceFn, typename OrderFn>
+int SpatialGrid::findNearest(const Vector2DD &p,
+                             const real_t maxDist,
+                             const real_t slack,
+                             DistanceFn distance,
+                             OrderFn order,
+                             real_t &minDist) const {
+    int closest = -1;
+    minDist = std::numeric_limits<real_t>::infinity();
+    const auto visit = [&](const int id) {
+        const real_t dist = distance(id);
+        if (dist < minDist || (dist == minDist && closest >= 0 && order(id) < order(closest))) {
+            minDist = dist;
+            closest = id;
+        }
+    };
+    for (const int id: oversized_) {
+        visit(id);
+    }
+    if (minX_ > maxX_) {
+        return minDist < maxDist ? closest : -1;
+    }
+    const int cx = cellCoord(p.x());
+    const int cy = cellCoord(p.y());
+    // Rings closer than this do not overlap the occupied cells
+    const int firstRing = std::max({0, minX_ - cx, cx - maxX_, minY_ - cy, cy - maxY_});
+    const int lastRing = std::max({cx - minX_, maxX_ - cx, cy - minY_, maxY_ - cy});
+    const auto visitCell = [&](const int x, const int y) {
+        const auto it = cells_.find(cellKey(x, y));
+        if (it != cells_.end()) {
+            for (const int id: it->second) {
+                visit(id);
+            }
+        }
+    };
+    for (int r = firstRing; r <= lastRing; r++) {
+        // The cells in ring r, clipped to the occupied cells
+        const int x0 = std::max(cx - r, minX_);
+        const int x1 = std::min(cx + r, maxX_);
+        const int y0 = std::max(cy - r, minY_);
+        const int y1 = std::min(cy + r, maxY_);
+        if (r == 0) {
+            visitCell(cx, cy);
+        } else {
+            if (cy - r >= minY_) {
+                for (int x = x0; x <= x1; x++) {
+                    visitCell(x, cy - r);
+                }
+            }
+            if (cy + r <= maxY_) {
+                for (int x = x0; x <= x1; x++) {
+                    visitCell(x, cy + r);
+                }
+            }
+            for (int y = std::max(y0, cy - r + 1); y <= std::min(y1, cy + r - 1); y++) {
+                if (cx - r >= minX_) {
+                    visitCell(cx - r, y);
+                }
+                if (cx + r <= maxX_) {
+                    visitCell(cx + r, y);
+                }
+            }
+        }
+        // Every point closer to p than r cells has been visited by now
+        const real_t coveredDist = r * cellSize_ - slack;
+        if (minDist < coveredDist || maxDist <= coveredDist) {
+            break;
+        }
+    }
+    return minDist < maxDist ? closest : -1;
+}
+
+} // namespace conis::core
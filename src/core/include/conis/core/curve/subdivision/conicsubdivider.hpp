@@ -1,8 +1,16 @@
 #pragma once
 
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
 #include "conis/core/conics/conicfitter.hpp"
+#include "conis/core/curve/compactcurve.hpp"
 #include "conis/core/curve/curve.hpp"
 #include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/dual.hpp"
+#include "conis/core/progress.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::core {
@@ -18,6 +26,36 @@ public:
      */
     void subdivide(Curve &curve, int level);
 
+    /**
+     * Subdivides the curve in-place like subdivide(Curve&, int), but also stores the exact curvature of the fitted conic
+     * at every inserted point. This is more accurate than a discrete curvature estimate at the same level.
+     * @param curve The curve to subdivide.
+     * @param level The level to subdivide to.
+     * @param curvatures Filled with one value per vertex of the subdivided curve. Points inserted at earlier levels keep
+     * the curvature from the level they were inserted at, inserted inflection points have zero curvature and points
+     * that were not sampled from a conic (the original control points) are NaN.
+     */
+    void subdivide(Curve &curve, int level, std::vector<real_t> &curvatures);
+
+    /**
+     * Subdivides the curve to the given subdivision level using a mixed precision schedule.
+     * The first SubdivisionSettings::fullPrecisionLevels levels are computed in real_t, the remaining levels in S.
+     * @param curve The curve to subdivide.
+     * @param level The level to subdivide to.
+     * @param result The subdivided curve. Only supported for S = double and S = float.
+     */
+    template<typename S>
+    void subdivide(const Curve &curve, int level, CompactCurve<S> &result);
+
+    /**
+     * Subdivides a curve of dual numbers. The derivatives of the subdivided vertices and normals with respect to the
+     * inputs seeded in the control curve (see dualInput) are computed in the same pass as their values.
+     * @param curve The curve to subdivide.
+     * @param level The level to subdivide to.
+     * @param result The subdivided curve.
+     */
+    void subdivide(const CompactCurve<Dual> &curve, int level, CompactCurve<Dual> &result);
+
     /**
      * Returns a curve with the inflection points inserted such that the curve can be split into globally convex segments.
      * @param curve The curve that stores the information on the inflection point indices.
@@ -36,14 +74,80 @@ public:
      */
     std::vector<PatchPoint> extractPatch(const Curve &curve, int pIdx, int maxPatchSize) const;
 
+    /**
+     * @brief Sets the callback that receives the number of levels subdivided so far.
+     * @param callback The progress callback. An empty function disables progress reporting.
+     */
+    void setProgressCallback(ProgressCallback callback) { progressCallback_ = std::move(callback); }
+
+    /**
+     * @brief Sets the memory resource of the patch buffers. The buffers are reused for every edge, so after the first
+     * few edges the subdivision no longer allocates for them. Frees the current buffers.
+     * @param resource The memory resource. Must outlive the subdivider.
+     */
+    void setMemoryResource(std::pmr::memory_resource *resource);
+    [[nodiscard]] std::pmr::memory_resource *getMemoryResource() const { return resource_; }
+
+    /**
+     * @brief Returns the indices of the inflection points inserted by the last subdivision, in the index space of the
+     * subdivided curve.
+     */
+    [[nodiscard]] const std::vector<int> &getInflPointIndices() const { return inflPointIndices_; }
+
 private:
+    // One patch buffer per scalar type, like the fitters
+    struct PatchBuffers {
+        explicit PatchBuffers(std::pmr::memory_resource *resource)
+            : patch(resource),
+              doublePatch(resource),
+              floatPatch(resource),
+              dualPatch(resource) {}
+
+        PatchPoints<real_t> patch;
+        PatchPoints<double> doublePatch;
+        PatchPoints<float> floatPatch;
+        PatchPoints<Dual> dualPatch;
+    };
+
+    // The scalar type of the vertices of the given curve type
+    template<typename CurveT>
+    using CurveScalar = typename std::decay_t<decltype(std::declval<const CurveT &>().getVertex(0))>::Scalar;
+
     const SubdivisionSettings &settings_;
     ConicFitter fitter_;
+    BasicConicFitter<double> doubleFitter_;
+    BasicConicFitter<float> floatFitter_;
+    BasicConicFitter<Dual> dualFitter_;
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+    // Always engaged; only an optional so that setMemoryResource can rebuild the buffers with another resource
+    std::optional<PatchBuffers> patchBuffers_;
     std::vector<int> inflPointIndices_;
     // These buffers persist between subdivisions to prevent re-allocation
     Curve bufferCurve_;
+    Curve mixedCurve_;
+    // Set while subdivide records the analytic curvatures; double buffered like the curves
+    std::vector<real_t> *curvatures_ = nullptr;
+    std::vector<real_t> curvatureBuffer_;
+    ProgressCallback progressCallback_;
+    int completedLevels_ = 0;
+    int totalLevels_ = 0;
+
+    template<typename S>
+    BasicConicFitter<S> &fitter();
+    template<typename S>
+    PatchPoints<S> &patchBuffer();
 
-    void subdivideRecursive(Curve &controlCurve, Curve &subdivCurve, int level);
+    template<typename CurveT>
+    void subdivideRecursive(CurveT &controlCurve, CurveT &subdivCurve, int level);
+
+    /**
+     * Like extractPatch, but fills the given buffer rather than allocating a new collection.
+     */
+    template<typename CurveT>
+    void extractCurvePatch(const CurveT &curve,
+                           int pIdx,
+                           int maxPatchSize,
+                           PatchPoints<CurveScalar<CurveT>> &patchPoints) const;
 
     /**
      * Checks whether v0 and v3 reside in the same half plane with respect to the edge v1-v2.
@@ -53,18 +157,24 @@ private:
      * @param v3 Vertex 3.
      * @return True if v0 and v1 are in the same half plane. False otherwise.
      */
-    [[nodiscard]] bool areInSameHalfPlane(const Vector2DD &v0,
-                                          const Vector2DD &v1,
-                                          const Vector2DD &v2,
-                                          const Vector2DD &v3) const;
+    template<typename S>
+    [[nodiscard]] bool areInSameHalfPlane(const Vector2<S> &v0,
+                                          const Vector2<S> &v1,
+                                          const Vector2<S> &v2,
+                                          const Vector2<S> &v3) const;
 
     /**
      * Inserts an edge point/normal in the newPoints/newNormals collection.
      * @param controlCurve The control curve from which to extract patch data to construct the new edge point.
      * @param subdivCurve The curve where the calculated point-normal pair will be inserted.
      * @param i The index of the first vertex of the edge to find the patch for. That is, for the edge A-B, i denotes the index of A. This is the index with respect to the newPoints/nerNormals collection.
+     * @param curvature If not null, the curvature of the conic at the inserted point is stored here.
      */
-    void edgePoint(const Curve &controlCurve, Curve &subdivCurve, int i);
+    template<typename CurveT>
+    void edgePoint(const CurveT &controlCurve,
+                   CurveT &subdivCurve,
+                   int i,
+                   CurveScalar<CurveT> *curvature = nullptr);
 
     /**
      * For 3 vertices A-B-C, this calculates the normal of the inflection point on the edge B-C based only on the A, B and C.
@@ -73,11 +183,19 @@ private:
      * @param orthogonal A vector orthogonal to B-C.
      * @return The inflection point normal and the angle the normal makes with the orthogonal line.
      */
-    std::pair<Vector2DD, real_t> inflNormal(const Vector2DD &edgeAB,
-                                            const Vector2DD &edgeBC,
-                                            const Vector2DD &orthogonal) const;
+    template<typename S>
+    std::pair<Vector2<S>, S> inflNormal(const Vector2<S> &edgeAB,
+                                        const Vector2<S> &edgeBC,
+                                        const Vector2<S> &orthogonal) const;
+
+    template<typename CurveT>
+    void insertInflPoints(const CurveT &curve, CurveT &targetCurve);
 
-    void insertInflPoints(const Curve &curve, Curve &targetCurve);
+    /**
+     * Resets the recorded curvatures (if any) for a control curve with the given number of points.
+     * @param numPoints The number of points of the control curve, including the inserted inflection points.
+     */
+    void resetCurvatures(int numPoints);
 };
 
 } // namespace conis::core
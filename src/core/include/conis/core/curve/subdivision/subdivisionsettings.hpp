@@ -22,6 +22,15 @@ using SubdivisionSettings = struct SubdivisionSettings {
     real_t epsilon = 1e-40;
     bool dynamicPatchSize = true;
 
+    // Mixed precision: the first fullPrecisionLevels levels are computed in real_t and the remaining levels in double,
+    // or in float when floatPreview is set. A negative value computes all levels in real_t.
+    int fullPrecisionLevels = -1;
+    bool floatPreview = false;
+
+    // Replaces the libm transcendental functions in the inflection point insertion, curvature calculation and normal
+    // refinement by the polynomial approximations of util/fastmath.hpp. These are only accurate up to double precision.
+    bool fastMath = false;
+
     // For testing purposes
     bool testToggle = false;
 };
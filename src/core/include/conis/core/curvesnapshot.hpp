@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "conis/core/curve/curve.hpp"
+
+namespace conis::core {
+
+/**
+ * The result of a single subdivision of a ConisCurve: the control curve it was computed from and the subdivision curve.
+ * Snapshots are immutable once published (see ConisCurve::getSnapshot), so a reader holding one always sees a
+ * consistent pair of curves, regardless of any edits or subdivisions that happen afterwards.
+ */
+using CurveSnapshot = struct CurveSnapshot {
+    Curve controlCurve;
+    Curve subdivCurve;
+    int subdivLevel = 0;
+    // Increases by one with every published snapshot
+    uint64_t version = 0;
+};
+
+} // namespace conis::core
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+namespace conis::core {
+
+/**
+ * @brief Compensated (unevaluated) sum of two doubles: value = hi + lo with |lo| <= ulp(hi) / 2.
+ *
+ * Gives roughly 106 bits of mantissa using nothing but double precision operations, so unlike the x87 long double it
+ * runs on the SSE/AVX units. The arithmetic follows the algorithms of the QD library:
+ *
+ *  Yozo Hida, Xiaoye S. Li and David H. Bailey, "Library for Double-Double and Quad-Double Arithmetic", 2007.
+ *
+ * Addition, multiplication, division and the square root are carried out in full double-double precision.
+ * The transcendental functions are evaluated in long double precision, as they are only used for angle heuristics.
+ */
+class DoubleDouble {
+public:
+    constexpr DoubleDouble() = default;
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    constexpr DoubleDouble(const T value) // NOLINT(google-explicit-constructor): behaves like a builtin scalar
+        : hi_(static_cast<double>(value)),
+          lo_(static_cast<double>(value - static_cast<T>(static_cast<double>(value)))) {}
+
+    constexpr DoubleDouble(const double hi, const double lo) : hi_(hi), lo_(lo) {}
+
+    [[nodiscard]] constexpr double hi() const { return hi_; }
+    [[nodiscard]] constexpr double lo() const { return lo_; }
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    constexpr explicit operator T() const {
+        if constexpr (std::is_integral_v<T>) {
+            return static_cast<T>(hi_) + static_cast<T>(lo_);
+        } else {
+            return static_cast<T>(static_cast<T>(hi_) + static_cast<T>(lo_));
+        }
+    }
+
+    // Error-free transformations
+    static constexpr DoubleDouble quickTwoSum(const double a, const double b) {
+        const double s = a + b;
+        return {s, b - (s - a)};
+    }
+
+    static constexpr DoubleDouble twoSum(const double a, const double b) {
+        const double s = a + b;
+        const double bb = s - a;
+        return {s, (a - (s - bb)) + (b - bb)};
+    }
+
+    static DoubleDouble twoProd(const double a, const double b) {
+        const double p = a * b;
+        return {p, std::fma(a, b, -p)};
+    }
+
+    constexpr DoubleDouble operator-() const { return {-hi_, -lo_}; }
+
+    friend DoubleDouble operator+(const DoubleDouble &a, const DoubleDouble &b) {
+        DoubleDouble s = twoSum(a.hi_, b.hi_);
+        if (!std::isfinite(s.hi_)) {
+            // The error terms of infinities are NaN; propagate the infinity like the builtin types do
+            return {s.hi_, 0.0};
+        }
+        const DoubleDouble t = twoSum(a.lo_, b.lo_);
+        s = quickTwoSum(s.hi_, s.lo_ + t.hi_);
+        return quickTwoSum(s.hi_, s.lo_ + t.lo_);
+    }
+
+    friend DoubleDouble operator-(const DoubleDouble &a, const DoubleDouble &b) { return a + (-b); }
+
+    friend DoubleDouble operator*(const DoubleDouble &a, const DoubleDouble &b) {
+        const DoubleDouble p = twoProd(a.hi_, b.hi_);
+        if (!std::isfinite(p.hi_)) {
+            return {p.hi_, 0.0};
+        }
+        return quickTwoSum(p.hi_, p.lo_ + (a.hi_ * b.lo_ + a.lo_ * b.hi_));
+    }
+
+    friend DoubleDouble operator/(const DoubleDouble &a, const DoubleDouble &b) {
+        const double q1 = a.hi_ / b.hi_;
+        if (!std::isfinite(q1)) {
+            // Division by zero or overflow: behave like the builtin types instead of producing NaN
+            return {q1, 0.0};
+        }
+        DoubleDouble r = a - b * q1;
+        const double q2 = r.hi_ / b.hi_;
+        r = r - b * q2;
+        const double q3 = r.hi_ / b.hi_;
+        return quickTwoSum(q1, q2) + q3;
+    }
+
+    DoubleDouble &operator+=(const DoubleDouble &other) { return *this = *this + other; }
+    DoubleDouble &operator-=(const DoubleDouble &other) { return *this = *this - other; }
+    DoubleDouble &operator*=(const DoubleDouble &other) { return *this = *this * other; }
+    DoubleDouble &operator/=(const DoubleDouble &other) { return *this = *this / other; }
+
+    friend constexpr bool operator==(const DoubleDouble &a, const DoubleDouble &b) {
+        return a.hi_ == b.hi_ && a.lo_ == b.lo_;
+    }
+    friend constexpr bool operator!=(const DoubleDouble &a, const DoubleDouble &b) { return !(a == b); }
+    friend constexpr bool operator<(const DoubleDouble &a, const DoubleDouble &b) {
+        return a.hi_ < b.hi_ || (a.hi_ == b.hi_ && a.lo_ < b.lo_);
+    }
+    friend constexpr bool operator>(const DoubleDouble &a, const DoubleDouble &b) { return b < a; }
+    friend constexpr bool operator<=(const DoubleDouble &a, const DoubleDouble &b) { return !(b < a); }
+    friend constexpr bool operator>=(const DoubleDouble &a, const DoubleDouble &b) { return !(a < b); }
+
+    friend std::ostream &operator<<(std::ostream &os, const DoubleDouble &a) {
+        return os << static_cast<long double>(a);
+    }
+
+private:
+    double hi_ = 0.0;
+    double lo_ = 0.0;
+};
+
+// Mixed-mode operators. Needed because implicit conversions are not considered for template deduction in Eigen.
+#define CONIS_DD_MIXED_OP(OP)                                                                                          \
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>                                         \
+    auto operator OP(const DoubleDouble &a, const T b) {                                                               \
+        return a OP DoubleDouble(b);                                                                                   \
+    }                                                                                                                  \
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>                                         \
+    auto operator OP(const T a, const DoubleDouble &b) {                                                               \
+        return DoubleDouble(a) OP b;                                                                                   \
+    }
+CONIS_DD_MIXED_OP(+)
+CONIS_DD_MIXED_OP(-)
+CONIS_DD_MIXED_OP(*)
+CONIS_DD_MIXED_OP(/)
+CONIS_DD_MIXED_OP(==)
+CONIS_DD_MIXED_OP(!=)
+CONIS_DD_MIXED_OP(<)
+CONIS_DD_MIXED_OP(>)
+CONIS_DD_MIXED_OP(<=)
+CONIS_DD_MIXED_OP(>=)
+#undef CONIS_DD_MIXED_OP
+
+// Math functions. These are found through argument dependent lookup, which is also what Eigen relies on.
+inline bool isnan(const DoubleDouble &a) { return std::isnan(a.hi()); }
+inline bool isinf(const DoubleDouble &a) { return std::isinf(a.hi()); }
+inline bool isfinite(const DoubleDouble &a) { return std::isfinite(a.hi()); }
+inline bool signbit(const DoubleDouble &a) { return std::signbit(a.hi()); }
+
+inline DoubleDouble abs(const DoubleDouble &a) { return a.hi() < 0.0 ? -a : a; }
+inline DoubleDouble fabs(const DoubleDouble &a) { return abs(a); }
+inline DoubleDouble fma(const DoubleDouble &a, const DoubleDouble &b, const DoubleDouble &c) { return a * b + c; }
+
+inline DoubleDouble sqrt(const DoubleDouble &a) {
+    if (a.hi() <= 0.0 || !std::isfinite(a.hi())) {
+        return std::sqrt(a.hi());
+    }
+    // One Newton step on the double precision approximation (Karp's trick)
+    const double x = 1.0 / std::sqrt(a.hi());
+    const double ax = a.hi() * x;
+    const DoubleDouble axSquared = DoubleDouble::twoProd(ax, ax);
+    return DoubleDouble::twoSum(ax, (a - axSquared).hi() * (x * 0.5));
+}
+
+inline DoubleDouble hypot(const DoubleDouble &a, const DoubleDouble &b) {
+    const DoubleDouble absA = abs(a);
+    const DoubleDouble absB = abs(b);
+    const DoubleDouble big = absA > absB ? absA : absB;
+    const DoubleDouble small = absA > absB ? absB : absA;
+    if (big.hi() == 0.0 || !std::isfinite(big.hi())) {
+        return big;
+    }
+    const DoubleDouble ratio = small / big;
+    return big * sqrt(1.0 + ratio * ratio);
+}
+
+#define CONIS_DD_LONG_DOUBLE_FUNC(NAME)                                                                                \
+    inline DoubleDouble NAME(const DoubleDouble &a) { return std::NAME(static_cast<long double>(a)); }
+CONIS_DD_LONG_DOUBLE_FUNC(sin)
+CONIS_DD_LONG_DOUBLE_FUNC(cos)
+CONIS_DD_LONG_DOUBLE_FUNC(tan)
+CONIS_DD_LONG_DOUBLE_FUNC(asin)
+CONIS_DD_LONG_DOUBLE_FUNC(acos)
+CONIS_DD_LONG_DOUBLE_FUNC(atan)
+CONIS_DD_LONG_DOUBLE_FUNC(exp)
+CONIS_DD_LONG_DOUBLE_FUNC(log)
+CONIS_DD_LONG_DOUBLE_FUNC(floor)
+CONIS_DD_LONG_DOUBLE_FUNC(ceil)
+#undef CONIS_DD_LONG_DOUBLE_FUNC
+
+inline DoubleDouble atan2(const DoubleDouble &y, const DoubleDouble &x) {
+    return std::atan2(static_cast<long double>(y), static_cast<long double>(x));
+}
+
+inline DoubleDouble pow(const DoubleDouble &a, const DoubleDouble &b) {
+    return std::pow(static_cast<long double>(a), static_cast<long double>(b));
+}
+
+// Bring the standard overloads into this namespace, so that unqualified calls resolve for every real_t
+using std::abs;
+using std::acos;
+using std::asin;
+using std::atan;
+using std::atan2;
+using std::ceil;
+using std::cos;
+using std::exp;
+using std::fabs;
+using std::floor;
+using std::fma;
+using std::hypot;
+using std::isfinite;
+using std::isinf;
+using std::isnan;
+using std::log;
+using std::pow;
+using std::signbit;
+using std::sin;
+using std::sqrt;
+using std::tan;
+
+} // namespace conis::core
+
+namespace std {
+
+template<>
+class numeric_limits<conis::core::DoubleDouble> : public numeric_limits<double> {
+public:
+    using DD = conis::core::DoubleDouble;
+    static constexpr int digits = 106;
+    static constexpr int digits10 = 31;
+    static constexpr int max_digits10 = 33;
+
+    static constexpr DD min() noexcept { return 2.0041683600089728e-292; } // 2^-969, keeps lo a normal number
+    static constexpr DD max() noexcept { return {1.79769313486231570815e+308, 9.97920154767359795037e+291}; }
+    static constexpr DD lowest() noexcept { return -max(); }
+    static constexpr DD epsilon() noexcept { return 4.93038065763132e-32; } // 2^-104
+    static constexpr DD round_error() noexcept { return 0.5; }
+    static constexpr DD infinity() noexcept { return numeric_limits<double>::infinity(); }
+    static constexpr DD quiet_NaN() noexcept { return numeric_limits<double>::quiet_NaN(); }
+    static constexpr DD signaling_NaN() noexcept { return numeric_limits<double>::signaling_NaN(); }
+    static constexpr DD denorm_min() noexcept { return numeric_limits<double>::denorm_min(); }
+};
+
+} // namespace std
+
+namespace Eigen {
+
+template<>
+struct NumTraits<conis::core::DoubleDouble> : GenericNumTraits<conis::core::DoubleDouble> {
+    using Real = conis::core::DoubleDouble;
+    using NonInteger = conis::core::DoubleDouble;
+    using Nested = conis::core::DoubleDouble;
+    using Literal = conis::core::DoubleDouble;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 2,
+        AddCost = 20,
+        MulCost = 10,
+    };
+
+    static inline Real epsilon() { return std::numeric_limits<Real>::epsilon(); }
+    // Same as long double, so that Eigen's fuzzy comparisons (e.g. isZero) behave identically for both backends
+    static inline Real dummy_precision() { return 1e-15; }
+    static inline int digits10() { return std::numeric_limits<Real>::digits10; }
+    static inline int digits() { return std::numeric_limits<Real>::digits; }
+    static inline Real highest() { return std::numeric_limits<Real>::max(); }
+    static inline Real lowest() { return std::numeric_limits<Real>::lowest(); }
+    static inline Real infinity() { return std::numeric_limits<Real>::infinity(); }
+    static inline Real quiet_NaN() { return std::numeric_limits<Real>::quiet_NaN(); }
+};
+
+} // namespace Eigen
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/AutoDiff>
+
+namespace conis::core {
+
+/**
+ * @brief Forward-mode dual number: a double value together with its derivatives with respect to any number of inputs.
+ *
+ * Running the subdivision in Dual (see ConicSubdivider::subdivide) propagates the derivatives of every control point
+ * coordinate and normal through the conic fits, ray intersections and curvatures alongside their values. A single pass
+ * thus gives the derivatives with respect to all inputs, where finite differences need two subdivisions per input.
+ * Constants have an empty derivative vector, which Eigen treats as zero.
+ */
+using Dual = Eigen::AutoDiffScalar<Eigen::VectorXd>;
+
+/**
+ * @brief Creates an input variable.
+ * @param value The value of the input.
+ * @param numInputs The total number of inputs.
+ * @param input The index of this input.
+ * @return A dual number whose derivative with respect to itself is 1 and with respect to all other inputs is 0.
+ */
+inline Dual dualInput(const double value, const int numInputs, const int input) {
+    return {value, numInputs, input};
+}
+
+inline Dual fma(const Dual &a, const Dual &b, const Dual &c) {
+    // The derivative is that of a * b + c; only the value benefits from the single rounding
+    Dual result = a * b + c;
+    result.value() = std::fma(a.value(), b.value(), c.value());
+    return result;
+}
+
+// Not provided by Eigen's AutoDiff module
+inline Dual atan(const Dual &a) {
+    return {std::atan(a.value()), a.derivatives() / (1.0 + a.value() * a.value())};
+}
+
+// The value of any of the scalar types used by the library as a double
+template<typename S>
+double toDouble(const S &a) {
+    return static_cast<double>(a);
+}
+
+inline double toDouble(const Dual &a) { return a.value(); }
+
+inline bool isnan(const Dual &a) { return std::isnan(a.value()); }
+inline bool isinf(const Dual &a) { return std::isinf(a.value()); }
+inline bool isfinite(const Dual &a) { return std::isfinite(a.value()); }
+
+} // namespace conis::core
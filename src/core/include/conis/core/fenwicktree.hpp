@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+namespace conis::core {
+
+/**
+ * @brief A Fenwick tree (binary indexed tree) over a sequence of non-negative counts, e.g. the sizes of the chunks of a
+ * chunked container. Changing a count, summing a prefix and finding the element that contains a position all take
+ * O(log n).
+ */
+class FenwickTree {
+public:
+    FenwickTree() = default;
+
+    /**
+     * @brief Replaces the counts in O(n).
+     * @param n The number of counts.
+     * @param countAt Returns the count of element i.
+     */
+    template<typename CountFn>
+    void assign(const int n, CountFn countAt) {
+        tree_.assign(n + 1, 0);
+        for (int i = 1; i <= n; i++) {
+            tree_[i] += countAt(i - 1);
+            const int parent = i + (i & -i);
+            if (parent <= n) {
+                tree_[parent] += tree_[i];
+            }
+        }
+    }
+
+    void clear() { tree_.clear(); }
+    [[nodiscard]] int size() const { return static_cast<int>(tree_.size()) - (tree_.empty() ? 0 : 1); }
+
+    /**
+     * @brief Adds delta to the count of element i.
+     */
+    void add(const int i, const int delta) {
+        const int n = size();
+        for (int k = i + 1; k <= n; k += k & -k) {
+            tree_[k] += delta;
+        }
+    }
+
+    /**
+     * @brief Returns the sum of the counts of the elements [0, i).
+     */
+    [[nodiscard]] int prefixSum(const int i) const {
+        int sum = 0;
+        for (int k = i; k > 0; k -= k & -k) {
+            sum += tree_[k];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Finds the element that contains a position, when every element covers as many positions as its count.
+     * Elements with a count of zero never contain a position.
+     * @param pos The position, which must be smaller than the sum of all counts.
+     * @param offset Is set to the offset of the position in the element found.
+     * @return The element containing the position.
+     */
+    [[nodiscard]] int find(int pos, int &offset) const {
+        const int n = size();
+        int step = 1;
+        while (step * 2 <= n) {
+            step *= 2;
+        }
+        // Descend the tree to find the last element whose preceding elements count at most pos
+        int i = 0;
+        for (; step > 0; step /= 2) {
+            if (i + step <= n && tree_[i + step] <= pos) {
+                i += step;
+                pos -= tree_[i];
+            }
+        }
+        assert(i < n);
+        offset = pos;
+        return i;
+    }
+
+private:
+    // 1-based
+    std::vector<int> tree_;
+};
+
+} // namespace conis::core
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace conis::core {
+
+/**
+ * @brief Cooperative cancellation flag shared between the owner of a job and the job itself. Copies share the same flag.
+ * A default constructed token is never cancelled.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    /**
+     * @brief Creates a token that can be cancelled.
+     * @return The new token.
+     */
+    static CancellationToken create() {
+        CancellationToken token;
+        token.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    void cancel() const {
+        if (cancelled_) {
+            cancelled_->store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] bool isCancelled() const { return cancelled_ && cancelled_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+} // namespace conis::core
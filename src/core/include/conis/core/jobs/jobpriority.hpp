@@ -0,0 +1,10 @@
+#pragma once
+
+namespace conis::core {
+
+/**
+ * @brief The priority of a job. Pending interactive jobs always start before pending background jobs.
+ */
+enum JobPriority { PRIORITY_INTERACTIVE, PRIORITY_BACKGROUND };
+
+} // namespace conis::core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "conis/core/jobs/cancellationtoken.hpp"
+#include "conis/core/jobs/jobpriority.hpp"
+
+namespace conis::core {
+
+/**
+ * @brief A job receives the token through which its owner may ask it to stop early.
+ */
+using Job = std::function<void(const CancellationToken &token)>;
+
+/**
+ * @brief Called on the worker thread once a job has finished. cancelled is true if the job was cancelled before or
+ * while it ran.
+ */
+using JobCompletion = std::function<void(bool cancelled)>;
+
+/**
+ * @brief Refers to a submitted job. Copies refer to the same job; a default constructed handle refers to none.
+ */
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    void cancel() const;
+    [[nodiscard]] bool isCancelled() const;
+    [[nodiscard]] bool isDone() const;
+    /**
+     * @brief Blocks until the job (including its completion callback) has finished or was discarded after a
+     * cancellation.
+     */
+    void wait() const;
+
+private:
+    friend class JobSystem;
+
+    struct State {
+        CancellationToken token = CancellationToken::create();
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+    };
+
+    explicit JobHandle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief A pool of persistent worker threads that run jobs in order of priority and, within a priority, in order of
+ * submission. Running jobs are never interrupted: a job should check its cancellation token regularly.
+ */
+class JobSystem {
+public:
+    explicit JobSystem(int numThreads);
+    /**
+     * @brief Cancels all jobs and waits for the running ones to return.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+     * @brief Queues a job. A job submitted while the job system is being destroyed is discarded as cancelled, without
+     * calling onComplete.
+     * @param job The job to run.
+     * @param priority The priority of the job.
+     * @param onComplete Optional callback that is called on the worker thread after the job has finished.
+     * @return A handle to wait for or cancel the job.
+     */
+    JobHandle submit(Job job, JobPriority priority = PRIORITY_BACKGROUND, JobCompletion onComplete = {});
+
+    [[nodiscard]] int numThreads() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCompletion onComplete;
+        std::shared_ptr<JobHandle::State> state;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable jobAdded_;
+    // One queue per priority, in the order of JobPriority
+    std::deque<QueuedJob> queues_[2];
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+
+    void run();
+};
+
+/**
+ * @brief Returns the job system shared by the library. It has at least two workers, so that a single long-running
+ * background job does not hold up the interactive jobs.
+ * @return The shared job system.
+ */
+JobSystem &jobSystem();
+
+} // namespace conis::core
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "conis/core/changeset.hpp"
+
 namespace conis::core {
 
 class Listener {
 public:
-    virtual void onListenerUpdated() = 0;
+    /**
+     * @brief Called when the curves have changed.
+     * @param changes The changes since the previous call. May describe multiple coalesced edits.
+     */
+    virtual void onListenerUpdated(const ChangeSet &changes) = 0;
 };
 
 } // namespace conis::core
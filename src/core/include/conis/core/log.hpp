@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <sstream>
+#include <string>
+
+#include "conis/core/loglevel.hpp"
+
+// Messages below this level are removed at compile time (see CONIS_MIN_LOG_LEVEL in src/core/CMakeLists.txt)
+#ifndef CONIS_MIN_LOG_LEVEL
+#define CONIS_MIN_LOG_LEVEL 0
+#endif
+
+/**
+ * Logs a message that is formatted using operator<<, e.g. CONIS_LOG(LOG_DEBUG, "Refined idx: " << idx). The message is
+ * only formatted if the level is enabled at runtime, and the entire statement is compiled out if the level lies below
+ * CONIS_MIN_LOG_LEVEL.
+ */
+#define CONIS_LOG(level, message)                                                                                      \
+    do {                                                                                                               \
+        if constexpr (static_cast<int>(level) >= CONIS_MIN_LOG_LEVEL) {                                                \
+            if (::conis::core::logEnabled(level)) {                                                                    \
+                std::ostringstream conisLogStream;                                                                     \
+                conisLogStream << message;                                                                             \
+                ::conis::core::logMessage(level, conisLogStream.str());                                                \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (false)
+
+namespace conis::core {
+
+/**
+ * @brief Receives the log messages. Sinks are called from a background thread, one message at a time and in the order
+ * in which the messages were logged.
+ */
+using LogSink = std::function<void(LogLevel level, const std::string &message)>;
+
+/**
+ * @brief Sets the minimum level of the messages that are logged. Defaults to LOG_INFO.
+ * @param level The minimum level.
+ */
+void setLogLevel(LogLevel level);
+
+[[nodiscard]] LogLevel logLevel();
+
+[[nodiscard]] bool logEnabled(LogLevel level);
+
+/**
+ * @brief Replaces the sink that receives the log messages. The default sink writes to std::clog without flushing every
+ * message.
+ * @param sink The new sink. An empty function restores the default sink.
+ */
+void setLogSink(LogSink sink);
+
+/**
+ * @brief Queues a message for the sink and returns without waiting for it to be written. Prefer CONIS_LOG, which does
+ * not format messages that are not logged.
+ * @param level The level of the message.
+ * @param message The message.
+ */
+void logMessage(LogLevel level, std::string message);
+
+/**
+ * @brief Blocks until the sink has received all messages logged so far and flushes the default sink.
+ */
+void flushLog();
+
+} // namespace conis::core
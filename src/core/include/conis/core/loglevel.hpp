@@ -0,0 +1,10 @@
+#pragma once
+
+namespace conis::core {
+
+/**
+ * @brief The severity of a log message, from the most verbose to the most severe. LOG_OFF disables all messages.
+ */
+enum LogLevel { LOG_TRACE, LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERROR, LOG_OFF };
+
+} // namespace conis::core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+namespace conis::core {
+
+using AllocationStats = struct AllocationStats {
+    uint64_t numAllocations = 0;
+    uint64_t numDeallocations = 0;
+    uint64_t bytesAllocated = 0;
+    uint64_t bytesInUse = 0;
+    uint64_t peakBytesInUse = 0;
+};
+
+std::ostream &operator<<(std::ostream &os, const AllocationStats &stats);
+
+/**
+ * @brief A memory resource that forwards all allocations to an upstream resource and counts them. Thread-safe if the
+ * upstream resource is.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : upstream_(upstream) {}
+
+    [[nodiscard]] std::pmr::memory_resource *upstream() const { return upstream_; }
+
+    [[nodiscard]] AllocationStats stats() const;
+    /**
+     * @brief Resets the counters. The bytes in use are kept, since those allocations are still outstanding.
+     */
+    void resetStats();
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    std::pmr::memory_resource *upstream_;
+    std::atomic<uint64_t> numAllocations_{0};
+    std::atomic<uint64_t> numDeallocations_{0};
+    std::atomic<uint64_t> bytesAllocated_{0};
+    std::atomic<uint64_t> bytesInUse_{0};
+    std::atomic<uint64_t> peakBytesInUse_{0};
+};
+
+} // namespace conis::core
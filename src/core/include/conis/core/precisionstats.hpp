@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace conis::core {
+
+/**
+ * Counts how often the filtered predicates could be decided in double precision and how often they had to fall back to
+ * a full real_t evaluation. The counters are shared by all subdividers and may be updated from multiple threads.
+ */
+using PrecisionStats = struct PrecisionStats {
+    // ConicSubdivider::areInSameHalfPlane
+    std::atomic<uint64_t> halfPlaneFast{0};
+    std::atomic<uint64_t> halfPlaneFallback{0};
+    // Conic::intersects
+    std::atomic<uint64_t> intersectFast{0};
+    std::atomic<uint64_t> intersectFallback{0};
+
+    void reset();
+};
+
+/**
+ * @brief Returns the global precision statistics.
+ * @return The global precision statistics.
+ */
+PrecisionStats &precisionStats();
+
+} // namespace conis::core
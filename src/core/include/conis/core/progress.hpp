@@ -0,0 +1,14 @@
+#pragma once
+
+#include <functional>
+#include <string_view>
+
+namespace conis::core {
+
+/**
+ * @brief Reports the progress of a long-running operation: done out of total steps of the given task have completed.
+ * Called on the thread that completed the step, but never concurrently for the same operation.
+ */
+using ProgressCallback = std::function<void(std::string_view task, int done, int total)>;
+
+} // namespace conis::core
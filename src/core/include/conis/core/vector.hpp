@@ -1,39 +1,67 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory_resource>
+#include <vector>
+
+#include "conis/core/doubledouble.hpp"
 
 namespace conis::core {
 
 #define EXTRA_CONIC_PRECISION
+// Decide the geometric predicates in double precision when possible and only fall back to real_t if uncertain
+#define FILTERED_CONIC_PRECISION
 // #define NORMALIZE_CONIC_NORMALS
+
+// The scalar type used throughout the library. Selected at build time through the CONIS_SCALAR CMake option.
+#if defined(CONIS_SCALAR_DOUBLE_DOUBLE)
+using real_t = DoubleDouble;
+#elif defined(CONIS_SCALAR_DOUBLE)
+using real_t = double;
+#else
 using real_t = long double;
+#endif
 
 // Apparently Eigen will crash if there is even the slightest thing wrong with alignment
 // (even though this should be supported)
 // So we disable the alignment for now
-using Matrix3DD = Eigen::Matrix<real_t, 3, 3, Eigen::DontAlign>;
+template<typename S>
+using Matrix3 = Eigen::Matrix<S, 3, 3, Eigen::DontAlign>;
+template<typename S>
+using Vector2 = Eigen::Matrix<S, 2, 1, Eigen::DontAlign>;
+template<typename S>
+using Vector3 = Eigen::Matrix<S, 3, 1, Eigen::DontAlign>;
+
+using Matrix3DD = Matrix3<real_t>;
 using Matrix4DD = Eigen::Matrix<real_t, 4, 4, Eigen::DontAlign>;
 
-using Vector2DD = Eigen::Matrix<real_t, 2, 1, Eigen::DontAlign>;
-using Vector3DD = Eigen::Matrix<real_t, 3, 1, Eigen::DontAlign>;
+using Vector2DD = Vector2<real_t>;
+using Vector3DD = Vector3<real_t>;
 using Vector4DD = Eigen::Matrix<real_t, 4, 1, Eigen::DontAlign>;
+using VectorXDD = Eigen::Matrix<real_t, Eigen::Dynamic, 1>;
 
+template<typename S>
+struct BasicPatchPoint {
+    Vector2<S> vertex;
+    Vector2<S> normal;
+    S pointWeight;
+    S normWeight;
 
-using PatchPoint = struct PatchPoint {
-    Vector2DD vertex;
-    Vector2DD normal;
-    real_t pointWeight;
-    real_t normWeight;
-
-    PatchPoint(const Vector2DD &vertex, const Vector2DD &normal, const real_t pointWeight, const real_t normWeight)
-        : vertex(Vector2DD(vertex)),
-          normal(Vector2DD(normal)),
+    BasicPatchPoint(const Vector2<S> &vertex, const Vector2<S> &normal, const S pointWeight, const S normWeight)
+        : vertex(Vector2<S>(vertex)),
+          normal(Vector2<S>(normal)),
           pointWeight(pointWeight),
           normWeight(normWeight) {}
 };
 
+using PatchPoint = BasicPatchPoint<real_t>;
+
+// Patch buffers that take their memory from a (possibly user supplied) memory resource
+template<typename S>
+using PatchPoints = std::pmr::vector<BasicPatchPoint<S>>;
+
 template<typename T>
-T mix(const T &a, const T &b, real_t w) {
+T mix(const T &a, const T &b, const typename T::Scalar w) {
     return (1.0 - w) * a + w * b;
 }
 
@@ -0,0 +1,42 @@
+#include "conis/core/changeset.hpp"
+
+#include <algorithm>
+
+namespace conis::core {
+
+void CurveChanges::add(const IndexRange range) {
+    if (range.begin >= range.end) {
+        return;
+    }
+    // The first range that ends at or after the start of the new one; everything before it is unaffected
+    auto first = std::lower_bound(ranges.begin(), ranges.end(), range.begin, [](const IndexRange &r, const int begin) {
+        return r.end < begin;
+    });
+    IndexRange merged = range;
+    auto last = first;
+    while (last != ranges.end() && last->begin <= merged.end) {
+        merged.begin = std::min(merged.begin, last->begin);
+        merged.end = std::max(merged.end, last->end);
+        ++last;
+    }
+    first = ranges.erase(first, last);
+    ranges.insert(first, merged);
+}
+
+void CurveChanges::merge(const CurveChanges &other) {
+    resized |= other.resized;
+    if (ranges.empty()) {
+        ranges = other.ranges;
+        return;
+    }
+    for (const IndexRange &range: other.ranges) {
+        add(range);
+    }
+}
+
+void ChangeSet::merge(const ChangeSet &other) {
+    control.merge(other.control);
+    subdiv.merge(other.subdiv);
+}
+
+} // namespace conis::core
@@ -2,53 +2,77 @@
 
 #include <cmath>
 #include <iostream>
+#include <optional>
 #include <utility>
 
 #include "conis/core/conics/conicfitter.hpp"
+#include "conis/core/dual.hpp"
+#include "conis/core/precisionstats.hpp"
+#include "util/cpudispatch.hpp"
+#include "util/filteredvalue.hpp"
 
 namespace conis::core {
 
-Conic::Conic(const real_t a,
-             const real_t b,
-             const real_t c,
-             const real_t d,
-             const real_t e,
-             const real_t f,
-             const real_t epsilon)
+template<typename S>
+BasicConic<S>::BasicConic(const S a, const S b, const S c, const S d, const S e, const S f, const S epsilon)
     : epsilon_(epsilon) {
     Q_ << a, b, d, b, c, e, d, e, f;
     valid_ = !Q_.isZero() && Q_.allFinite(); // No fully zero matrix and no invalid values
 }
-Conic::Conic(const Matrix3DD &Q, const real_t epsilon) : Q_(Q), epsilon_(epsilon) {}
+template<typename S>
+BasicConic<S>::BasicConic(const Matrix3<S> &Q, const S epsilon) : Q_(Q), epsilon_(epsilon) {}
 
-Vector2DD Conic::conicNormal(const Vector2DD &p, const Vector2DD &rd) const {
-    Vector2DD normal = conicNormal(p);
+template<typename S>
+Vector2<S> BasicConic<S>::conicNormal(const Vector2<S> &p, const Vector2<S> &rd) const {
+    Vector2<S> normal = conicNormal(p);
     if (normal.dot(rd) < 0.0) {
         normal *= -1;
     }
     return normal;
 }
 
-Vector2DD Conic::conicNormal(const Vector2DD &p) const {
+template<typename S>
+Vector2<S> BasicConic<S>::conicNormal(const Vector2<S> &p) const {
     if (!valid_) {
         return {0, 0};
     }
 #ifdef EXTRA_CONIC_PRECISION
-    real_t xn = fmal(Q_(0, 0), p.x(), fmal(Q_(0, 1), p.y(), Q_(0, 2)));
-    real_t yn = fmal(Q_(1, 0), p.x(), fmal(Q_(1, 1), p.y(), Q_(1, 2)));
+    S xn = fma(Q_(0, 0), p.x(), fma(Q_(0, 1), p.y(), Q_(0, 2)));
+    S yn = fma(Q_(1, 0), p.x(), fma(Q_(1, 1), p.y(), Q_(1, 2)));
 #else
-    Vector3DD p3(p.x(), p.y(), 1);
-    real_t xn = Q_.row(0).dot(p3);
-    real_t yn = Q_.row(1).dot(p3);
+    Vector3<S> p3(p.x(), p.y(), 1);
+    S xn = Q_.row(0).dot(p3);
+    S yn = Q_.row(1).dot(p3);
 #endif
     return {xn, yn};
 }
 
-bool Conic::sample(const Vector2DD &origin, const Vector2DD &direction, Vector2DD &point, Vector2DD &normal) const {
+template<typename S>
+S BasicConic<S>::curvature(const Vector2<S> &p) const {
+    if (!valid_) {
+        return 0;
+    }
+    // The gradient and the Hessian are 2 * (xn, yn) and 2 * Q_.topLeftCorner(2, 2), so the factors 2 cancel out
+    const Vector2<S> n = conicNormal(p);
+    const S xn = n.x();
+    const S yn = n.y();
+    const S gradNormSq = xn * xn + yn * yn;
+    if (gradNormSq == 0.0) {
+        return 0;
+    }
+    const S numerator = Q_(0, 0) * yn * yn - 2 * Q_(0, 1) * xn * yn + Q_(1, 1) * xn * xn;
+    return abs(numerator) / (gradNormSq * sqrt(gradNormSq));
+}
+
+template<typename S>
+bool BasicConic<S>::sample(const Vector2<S> &origin,
+                           const Vector2<S> &direction,
+                           Vector2<S> &point,
+                           Vector2<S> &normal) const {
     if (!valid_) {
         return false;
     }
-    real_t t;
+    S t;
     if (intersects(origin, direction, t)) {
         point = origin + t * direction;
         normal = conicNormal(point, direction);
@@ -73,40 +97,113 @@ bool Conic::sample(const Vector2DD &origin, const Vector2DD &direction, Vector2D
  *  of 2x2 Determinants". Mathematics of Computation, Vol. 82, No. 284,
  *  Oct. 2013, pp. 2245-2264
  */
-static real_t diffOfProducts(const real_t a, const real_t b, const real_t c, const real_t d) {
-    const real_t w = d * c;
-    const real_t e = fmal(-d, c, w);
-    const real_t f = fmal(a, b, -w);
+template<typename S>
+static S diffOfProducts(const S a, const S b, const S c, const S d) {
+    const S w = d * c;
+    const S e = fma(-d, c, w);
+    const S f = fma(a, b, -w);
     return f + e;
 }
 
-bool Conic::intersects(const Vector2DD &ro, const Vector2DD &rd, real_t &t) const {
-    const Vector3DD p(ro.x(), ro.y(), 1);
-    const Vector3DD u(rd.x(), rd.y(), 0);
+/*
+ * Double precision version of the EXTRA_CONIC_PRECISION branch of Conic::intersects.
+ * Returns whether the ray intersects the conic if this can be decided with certainty and the resulting t has an error
+ * below maxError. Returns an empty optional otherwise, in which case the computation has to be redone in real_t.
+ */
+CONIS_DISPATCH static std::optional<bool> filteredIntersects(const Matrix3DD &Q,
+                                                             const Vector2DD &ro,
+                                                             const Vector2DD &rd,
+                                                             const real_t epsilon,
+                                                             real_t &t) {
+    // The direction is not normalized, so t is measured in multiples of its length
+    constexpr double maxError = 1e-13;
+    const FilteredValue px(ro.x());
+    const FilteredValue py(ro.y());
+    const FilteredValue ux(rd.x());
+    const FilteredValue uy(rd.y());
+    const FilteredValue q00(Q(0, 0)), q01(Q(0, 1)), q02(Q(0, 2));
+    const FilteredValue q10(Q(1, 0)), q11(Q(1, 1)), q12(Q(1, 2));
+    const FilteredValue q20(Q(2, 0)), q21(Q(2, 1)), q22(Q(2, 2));
+
+    // Q * p and Q * u, with p = (px, py, 1) and u = (ux, uy, 0)
+    const FilteredValue qp0 = q00 * px + q01 * py + q02;
+    const FilteredValue qp1 = q10 * px + q11 * py + q12;
+    const FilteredValue qp2 = q20 * px + q21 * py + q22;
+    const FilteredValue qu0 = q00 * ux + q01 * uy;
+    const FilteredValue qu1 = q10 * ux + q11 * uy;
+
+    const FilteredValue a = ux * qu0 + uy * qu1;
+    const FilteredValue b = ux * qp0 + uy * qp1;
+    const FilteredValue c = px * qp0 + py * qp1 + qp2;
+
+    // The (near) linear case is rare; leave it to real_t
+    if (!a.certainlyAbsAtLeast(FilteredValue(epsilon))) {
+        return std::nullopt;
+    }
+    const FilteredValue determinant = b * b - a * c;
+    if (determinant.certainlyNegative()) {
+        return false;
+    }
+    if (!determinant.certainlyPositive() || !(b.certainlyPositive() || b.certainlyNegative())) {
+        // The root selection is uncertain
+        return std::nullopt;
+    }
+    // sqrt(x * (1 + r)) = sqrt(x) * (1 + r / 2 + O(r^2)), so the relative error of the determinant bounds the root's
+    const double root = std::sqrt(determinant.value());
+    const FilteredValue rootValue(root,
+                                  root * (determinant.error() / determinant.value() +
+                                          std::numeric_limits<double>::epsilon()));
+    // (-b -/+ root) / a is rewritten as -c / (b +/- root), which selects the same root without cancellation
+    const FilteredValue denom = b.certainlyNegative() ? b - rootValue : b + rootValue;
+    const double tValue = -c.value() / denom.value();
+    // First order error of the division. c is close to zero when the ray origin lies close to the conic, which is the
+    // common case, so only the absolute error of t is meaningful.
+    const double tError = (c.error() + std::abs(tValue) * denom.error()) / std::abs(denom.value()) +
+                          std::abs(tValue) * std::numeric_limits<double>::epsilon();
+    if (!(tError <= maxError)) {
+        return std::nullopt;
+    }
+    t = tValue;
+    return true;
+}
+
+template<typename S>
+static bool intersectRay(const Matrix3<S> &Q, const S epsilon, const Vector2<S> &ro, const Vector2<S> &rd, S &t) {
+#if defined(FILTERED_CONIC_PRECISION) && defined(EXTRA_CONIC_PRECISION)
+    if constexpr (std::is_same_v<S, real_t> && useFilteredPrecision) {
+        if (const std::optional<bool> hit = filteredIntersects(Q, ro, rd, epsilon, t)) {
+            precisionStats().intersectFast.fetch_add(1, std::memory_order_relaxed);
+            return *hit;
+        }
+        precisionStats().intersectFallback.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    const Vector3<S> p(ro.x(), ro.y(), 1);
+    const Vector3<S> u(rd.x(), rd.y(), 0);
 #ifdef EXTRA_CONIC_PRECISION
-    // Technically, b = p.dot(Q_ * u) + u.dot(Q_ * p);
-    // However, since Q_ is symmetric, p.dot(Q_ * u) = u.dot(Q_ * p)
-    // As such, b = 2 * u.dot(Q_ * p)
+    // Technically, b = p.dot(Q * u) + u.dot(Q * p);
+    // However, since Q is symmetric, p.dot(Q * u) = u.dot(Q * p)
+    // As such, b = 2 * u.dot(Q * p)
     // Because of this, we can remove the 4 in the discriminant calculation ((2b)^2 - 4ac = b^2 - ac
     // And we can also remove the 2 from the "/2a" part of the quadratic formula:
     // -2b+-sqrt(disc)/2a = -b+-sqrt(disc)/a
-    const real_t a = u.dot(Q_ * u);
-    const real_t b = u.dot(Q_ * p);
-    const real_t c = p.dot(Q_ * p);
+    const S a = u.dot(Q * u);
+    const S b = u.dot(Q * p);
+    const S c = p.dot(Q * p);
 
-    if (std::abs(a) <= epsilon_) {
+    if (abs(a) <= epsilon) {
         t = -c / (2 * b);
-        if (std::isnan(t)) {
+        if (isnan(t)) {
             return false;
         }
         return true;
     }
-    const real_t determinant = diffOfProducts(b, b, a, c);
+    const S determinant = diffOfProducts(b, b, a, c);
     if (determinant < 0.0) {
         return false;
     }
-    const real_t root = std::sqrt(determinant);
-    if (std::isnan(root)) {
+    const S root = sqrt(determinant);
+    if (isnan(root)) {
         return false;
     }
     // If b is negative, then -b is positive, so `-b - root` will always be smaller than `-b + root`
@@ -117,34 +214,57 @@ bool Conic::intersects(const Vector2DD &ro, const Vector2DD &rd, real_t &t) cons
     }
     return true;
 #else
-    const real_t a = u.dot(Q_ * u);
-    const real_t b = 2 * u.dot(Q_ * p);
-    const real_t c = p.dot(Q_ * p);
-    if (std::abs(a) <= epsilon_) {
+    const S a = u.dot(Q * u);
+    const S b = 2 * u.dot(Q * p);
+    const S c = p.dot(Q * p);
+    if (abs(a) <= epsilon) {
         t = -c / b;
-        if (std::isnan(t)) {
+        if (isnan(t)) {
             return false;
         }
         return true;
     }
-    const real_t determinant = b * b - 4 * a * c;
+    const S determinant = b * b - 4 * a * c;
     if (determinant < 0.0)
         return false;
-    real_t t1 = (-b + std::sqrt(determinant)) / (2 * a);
-    real_t t2 = (-b - std::sqrt(determinant)) / (2 * a);
-    t = std::abs(t1) < std::abs(t2) ? t1 : t2;
+    S t1 = (-b + sqrt(determinant)) / (2 * a);
+    S t2 = (-b - sqrt(determinant)) / (2 * a);
+    t = abs(t1) < abs(t2) ? t1 : t2;
     return true;
 #endif
 }
 
-void Conic::printConic() const {
+// The extended precision types do not use SIMD, so only the double and float versions are dispatched per ISA level
+CONIS_DISPATCH static bool intersectRay(const Matrix3<double> &Q,
+                                        const double epsilon,
+                                        const Vector2<double> &ro,
+                                        const Vector2<double> &rd,
+                                        double &t) {
+    return intersectRay<double>(Q, epsilon, ro, rd, t);
+}
+
+CONIS_DISPATCH static bool intersectRay(const Matrix3<float> &Q,
+                                        const float epsilon,
+                                        const Vector2<float> &ro,
+                                        const Vector2<float> &rd,
+                                        float &t) {
+    return intersectRay<float>(Q, epsilon, ro, rd, t);
+}
+
+template<typename S>
+bool BasicConic<S>::intersects(const Vector2<S> &ro, const Vector2<S> &rd, S &t) const {
+    return intersectRay(Q_, epsilon_, ro, rd, t);
+}
+
+template<typename S>
+void BasicConic<S>::printConic() const {
     std::cout << "Conic:";
-    const double A = Q_(0, 0);
-    const double D = Q_(0, 1);
-    const double E = Q_(1, 1);
-    const double G = Q_(0, 2);
-    const double B = Q_(1, 2);
-    const double F = Q_(2, 2);
+    const double A = toDouble(Q_(0, 0));
+    const double D = toDouble(Q_(0, 1));
+    const double E = toDouble(Q_(1, 1));
+    const double G = toDouble(Q_(0, 2));
+    const double B = toDouble(Q_(1, 2));
+    const double F = toDouble(Q_(2, 2));
 
     // Print the conic formula in Geogebra-compatible format
     std::ostringstream oss;
@@ -152,4 +272,11 @@ void Conic::printConic() const {
     std::cout << oss.str() << std::endl;
 }
 
+template class BasicConic<real_t>;
+#ifndef CONIS_SCALAR_DOUBLE
+template class BasicConic<double>;
+#endif
+template class BasicConic<float>;
+template class BasicConic<Dual>;
+
 } // namespace conis::core
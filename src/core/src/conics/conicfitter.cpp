@@ -5,14 +5,19 @@
 #include <Eigen/SVD>
 #include <iostream>
 
+#include "conis/core/dual.hpp"
+#include "util/cpudispatch.hpp"
+
 namespace conis::core {
 
-ConicFitter::ConicFitter(const real_t epsilon) : epsilon_(epsilon) {};
+template<typename S>
+BasicConicFitter<S>::BasicConicFitter(const S epsilon) : epsilon_(epsilon) {}
 
-static void pointEqEigen(Eigen::RowVectorX<real_t> &row, const Vector2DD &vertex) {
+template<typename S>
+static void pointEqEigen(Eigen::RowVectorX<S> &row, const Vector2<S> &vertex) {
     row.setZero();
-    const real_t x = vertex.x();
-    const real_t y = vertex.y();
+    const S x = vertex.x();
+    const S y = vertex.y();
     row(0) = x * x;
     row(1) = y * y;
     row(2) = 2 * x * y;
@@ -21,13 +26,14 @@ static void pointEqEigen(Eigen::RowVectorX<real_t> &row, const Vector2DD &vertex
     row(5) = 1;
 }
 
-static void normEqXEigen(Eigen::RowVectorX<real_t> &row,
-                         const Vector2DD &vertex,
-                         const Vector2DD &normal,
+template<typename S>
+static void normEqXEigen(Eigen::RowVectorX<S> &row,
+                         const Vector2<S> &vertex,
+                         const Vector2<S> &normal,
                          int normIdx) {
     row.setZero();
-    const real_t x = vertex.x();
-    const real_t y = vertex.y();
+    const S x = vertex.x();
+    const S y = vertex.y();
     row(0) = 2 * x; // A
     // row(1) = 0;     // B
     row(2) = 2 * y; // C
@@ -37,13 +43,14 @@ static void normEqXEigen(Eigen::RowVectorX<real_t> &row,
     row(6 + normIdx) = -normal.x();
 }
 
-static void normEqYEigen(Eigen::RowVectorX<real_t> &row,
-                         const Vector2DD &vertex,
-                         const Vector2DD &normal,
+template<typename S>
+static void normEqYEigen(Eigen::RowVectorX<S> &row,
+                         const Vector2<S> &vertex,
+                         const Vector2<S> &normal,
                          int normIdx) {
     row.setZero();
-    const real_t x = vertex.x();
-    const real_t y = vertex.y();
+    const S x = vertex.x();
+    const S y = vertex.y();
     // row(0) = 0;     // A
     row(1) = 2 * y; // B
     row(2) = 2 * x; // C
@@ -53,19 +60,17 @@ static void normEqYEigen(Eigen::RowVectorX<real_t> &row,
     row(6 + normIdx) = -normal.y();
 }
 
-Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic> ConicFitter::initAEigen(
-    const std::vector<PatchPoint> &patchPoints) const {
-    Eigen::MatrixX<real_t> A(numEq_, numUnknowns_);
-
-    // Reuse this row buffer
-    Eigen::RowVectorX<real_t> row = Eigen::RowVectorX<real_t>::Zero(numUnknowns_);
-
+template<typename S>
+static void systemMatrix(const BasicPatchPoint<S> *patchPoints,
+                         const int numPoints,
+                         Eigen::RowVectorX<S> &row,
+                         Eigen::MatrixX<S> &A) {
     int rowIdx = 0;
-    for (int i = 0; i < patchPoints.size(); i++) {
+    for (int i = 0; i < numPoints; i++) {
         // Per point, add 3 equations: one for the point itself and two for the normal (x and y)
         auto &p = patchPoints[i];
-        const Vector2DD &vertex = p.vertex;
-        const Vector2DD &normal = p.normal;
+        const Vector2<S> &vertex = p.vertex;
+        const Vector2<S> &normal = p.normal;
         pointEqEigen(row, vertex);
         A.row(rowIdx++) = row * p.pointWeight;
         normEqXEigen(row, vertex, normal, i);
@@ -73,16 +78,126 @@ Eigen::Matrix<real_t, Eigen::Dynamic, Eigen::Dynamic> ConicFitter::initAEigen(
         normEqYEigen(row, vertex, normal, i);
         A.row(rowIdx++) = row * p.normWeight;
     }
-    return A;
 }
 
-Eigen::VectorX<real_t> ConicFitter::solveLinSystem(const Eigen::MatrixX<real_t> &A) {
-    const Eigen::JacobiSVD svd(A, Eigen::ComputeThinV);
-    return svd.matrixV().rightCols<1>();
+// The extended precision types do not use SIMD, so only the double and float versions are dispatched per ISA level
+CONIS_DISPATCH static void systemMatrix(const BasicPatchPoint<double> *patchPoints,
+                                        const int numPoints,
+                                        Eigen::RowVectorX<double> &row,
+                                        Eigen::MatrixX<double> &A) {
+    systemMatrix<double>(patchPoints, numPoints, row, A);
+}
+
+CONIS_DISPATCH static void systemMatrix(const BasicPatchPoint<float> *patchPoints,
+                                        const int numPoints,
+                                        Eigen::RowVectorX<float> &row,
+                                        Eigen::MatrixX<float> &A) {
+    systemMatrix<float>(patchPoints, numPoints, row, A);
+}
+
+template<typename S>
+void BasicConicFitter<S>::initAEigen(const BasicPatchPoint<S> *patchPoints, const int numPoints) {
+    // Resizing to the same size keeps the buffers
+    A_.resize(numEq_, numUnknowns_);
+    row_.resize(numUnknowns_);
+    systemMatrix(patchPoints, numPoints, row_, A_);
+}
+
+// The SVD keeps its buffers between calls as long as the size of A does not change
+template<typename S>
+static void nullVector(const Eigen::MatrixX<S> &A, Eigen::JacobiSVD<Eigen::MatrixX<S>> &svd, Eigen::VectorX<S> &v) {
+    svd.compute(A, Eigen::ComputeThinV);
+    v = svd.matrixV().template rightCols<1>();
+}
+
+// Flattened, so that Eigen's SVD is compiled for every ISA level as well
+CONIS_DISPATCH_FLATTEN static void nullVector(const Eigen::MatrixX<double> &A,
+                                              Eigen::JacobiSVD<Eigen::MatrixX<double>> &svd,
+                                              Eigen::VectorX<double> &v) {
+    nullVector<double>(A, svd, v);
+}
+
+CONIS_DISPATCH_FLATTEN static void nullVector(const Eigen::MatrixX<float> &A,
+                                              Eigen::JacobiSVD<Eigen::MatrixX<float>> &svd,
+                                              Eigen::VectorX<float> &v) {
+    nullVector<float>(A, svd, v);
+}
+
+/*
+ * The null vector is the right singular vector v of A with the smallest singular value. Running the SVD itself in dual
+ * numbers would differentiate every Jacobi rotation, so instead the SVD is computed on the values and the derivative is
+ * obtained by implicit differentiation. v is the eigenvector of M = A^T A with the smallest eigenvalue l, so for a
+ * change dA the normalised null vector changes by
+ *
+ *   dv = -(M - l I)^+ dM v = sum_{i != min} v_i (v_i^T dM v) / (l - l_i),   with dM v = dA^T (A v) + A^T (dA v),
+ *
+ * where v_i are the other right singular vectors and l_i the corresponding eigenvalues of M.
+ *
+ * J. R. Magnus, "On Differentiating Eigenvalues and Eigenvectors", Econometric Theory, Vol. 1, No. 2, 1985, pp. 179-191.
+ *
+ * The SVD of the fitter is not used, since this needs the full V of the values rather than the thin V of A.
+ */
+static void nullVector(const Eigen::MatrixX<Dual> &A,
+                       Eigen::JacobiSVD<Eigen::MatrixX<Dual>> &,
+                       Eigen::VectorX<Dual> &result) {
+    const int rows = static_cast<int>(A.rows());
+    const int cols = static_cast<int>(A.cols());
+    Eigen::MatrixXd values(rows, cols);
+    int numInputs = 0;
+    for (int c = 0; c < cols; c++) {
+        for (int r = 0; r < rows; r++) {
+            values(r, c) = A(r, c).value();
+            numInputs = std::max(numInputs, static_cast<int>(A(r, c).derivatives().size()));
+        }
+    }
+    const Eigen::JacobiSVD svd(values, Eigen::ComputeFullV);
+    const Eigen::MatrixXd &V = svd.matrixV();
+    const Eigen::VectorXd v = V.rightCols<1>();
+    const Eigen::VectorXd Av = values * v;
+    // The eigenvalues of M; those beyond the number of rows are zero
+    Eigen::VectorXd eigenvalues = Eigen::VectorXd::Zero(cols);
+    eigenvalues.head(svd.singularValues().size()) = svd.singularValues().cwiseAbs2();
+    const double minEigenvalue = eigenvalues[cols - 1];
+    // Eigenvalues this close to the smallest one make the null vector (nearly) non-unique; ignore their direction
+    const double minGap = std::numeric_limits<double>::epsilon() * std::max(eigenvalues[0], 1.0);
+
+    // Column j of dMv is dM v for input j
+    Eigen::MatrixXd dMv = Eigen::MatrixXd::Zero(cols, numInputs);
+    Eigen::MatrixXd dA = Eigen::MatrixXd::Zero(rows, cols);
+    for (int j = 0; j < numInputs; j++) {
+        bool nonZero = false;
+        for (int c = 0; c < cols; c++) {
+            for (int r = 0; r < rows; r++) {
+                const Eigen::VectorXd &derivatives = A(r, c).derivatives();
+                dA(r, c) = derivatives.size() > j ? derivatives[j] : 0.0;
+                nonZero = nonZero || dA(r, c) != 0.0;
+            }
+        }
+        if (nonZero) {
+            dMv.col(j) = dA.transpose() * Av + values.transpose() * (dA * v);
+        }
+    }
+    // Project onto the other singular vectors and scale by the eigenvalue gaps
+    Eigen::MatrixXd projected = V.transpose() * dMv;
+    for (int i = 0; i < cols; i++) {
+        const double gap = minEigenvalue - eigenvalues[i];
+        projected.row(i) *= i == cols - 1 || std::abs(gap) <= minGap ? 0.0 : 1.0 / gap;
+    }
+    const Eigen::MatrixXd dv = V * projected;
+
+    result.resize(cols);
+    for (int c = 0; c < cols; c++) {
+        result[c] = Dual(v[c], dv.row(c).transpose());
+    }
+}
+
+template<typename S>
+void BasicConicFitter<S>::solveLinSystem() {
+    nullVector(A_, svd_, coefs_);
 }
 
-Conic ConicFitter::fitConic(const std::vector<PatchPoint> &patchPoints) {
-    const int numPoints = static_cast<int>(patchPoints.size());
+template<typename S>
+BasicConic<S> BasicConicFitter<S>::fitConic(const BasicPatchPoint<S> *patchPoints, const int numPoints) {
     if (numPoints < 3) {
         return {};
     }
@@ -90,14 +205,22 @@ Conic ConicFitter::fitConic(const std::vector<PatchPoint> &patchPoints) {
     numUnknowns_ = 6 + numPoints;
     // 1 eq per coordinate + 2 per normal
     numEq_ = numPoints * 3;
-    Eigen::VectorX<real_t> coefs = solveLinSystem(initAEigen(patchPoints));
-    const real_t a = coefs[0]; // A - x*x
-    const real_t b = coefs[2]; // C - x*y
-    const real_t c = coefs[1]; // B - y*y
-    const real_t d = coefs[3]; // D - x
-    const real_t e = coefs[4]; // E - y
-    const real_t f = coefs[5]; // F - constant
-    return Conic(a, b, c, d, e, f, epsilon_);
+    initAEigen(patchPoints, numPoints);
+    solveLinSystem();
+    const S a = coefs_[0]; // A - x*x
+    const S b = coefs_[2]; // C - x*y
+    const S c = coefs_[1]; // B - y*y
+    const S d = coefs_[3]; // D - x
+    const S e = coefs_[4]; // E - y
+    const S f = coefs_[5]; // F - constant
+    return BasicConic<S>(a, b, c, d, e, f, epsilon_);
 }
 
+template class BasicConicFitter<real_t>;
+#ifndef CONIS_SCALAR_DOUBLE
+template class BasicConicFitter<double>;
+#endif
+template class BasicConicFitter<float>;
+template class BasicConicFitter<Dual>;
+
 } // namespace conis::core
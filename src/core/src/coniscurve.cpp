@@ -1,28 +1,276 @@
 
 #include "conis/core/coniscurve.hpp"
 
-#include <iostream>
-
 #include "conis/core/conics/conic.hpp"
 #include "conis/core/curve/subdivision/conicsubdivider.hpp"
+#include "conis/core/log.hpp"
 #include "conis/core/vector.hpp"
-#include "util/asyncrunner.hpp"
+
+#include <chrono>
+#include <utility>
 
 namespace conis::core {
 
-ConisCurve::ConisCurve(const SubdivisionSettings &subdivSettings, const NormalRefinementSettings &normRefSettings)
+namespace {
+
+// Adds the range [begin, end) of points of a curve with n points. The range may extend past either end of the curve:
+// it wraps around on closed curves and is clipped on open ones.
+void addWrappedRange(CurveChanges &changes, int begin, int end, const int n, const bool closed) {
+    if (n == 0) {
+        return;
+    }
+    if (!closed) {
+        changes.add({std::max(begin, 0), std::min(end, n)});
+        return;
+    }
+    if (end - begin >= n) {
+        changes.add({0, n});
+        return;
+    }
+    const int shift = (begin % n + n) % n - begin;
+    begin += shift;
+    end += shift;
+    if (end <= n) {
+        changes.add({begin, end});
+    } else {
+        changes.add({begin, n});
+        changes.add({0, end - n});
+    }
+}
+
+// Index of control point idx in the curve with the inflection points inserted, given the sorted indices of the
+// inflection points in that curve. Indices outside [0, n) continue periodically.
+int inflCurveIndex(const int idx, const std::vector<int> &inflPoints, const int n) {
+    const int numWraps = idx >= 0 ? idx / n : -((n - 1 - idx) / n);
+    const int i = idx - numWraps * n;
+    // Inflection point j lies right after control point inflPoints[j] - j - 1
+    int lo = 0;
+    int hi = static_cast<int>(inflPoints.size());
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (inflPoints[mid] - mid <= i) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return i + lo + numWraps * (n + static_cast<int>(inflPoints.size()));
+}
+
+/*
+ * Adds the points of the subdivision curve that depend on the control points in [begin, end). An inflection point
+ * depends on the vertices up to one edge away from the edge it is inserted on, and an edge point on the two vertices
+ * of its edge and at most maxPatchSize - 1 vertices on either side of it. At every level, vertex i ends up at index 2i
+ * and the point on edge j at index 2j + 1.
+ */
+void addSubdivRange(CurveChanges &changes,
+                    int begin,
+                    int end,
+                    const Curve &controlCurve,
+                    const std::vector<int> &inflPoints,
+                    const int level,
+                    const int maxPatchSize) {
+    const int n = controlCurve.numPoints();
+    const bool closed = controlCurve.isClosed();
+    begin -= 2;
+    end += 1;
+    if (!closed) {
+        begin = std::max(begin, 0);
+        end = std::min(end, n);
+    }
+    begin = inflCurveIndex(begin, inflPoints, n);
+    end = inflCurveIndex(end, inflPoints, n);
+    int numPoints = n + static_cast<int>(inflPoints.size());
+    for (int i = 0; i < level; i++) {
+        if (end - begin >= numPoints) {
+            // Everything changed already
+            begin = 0;
+            end = numPoints;
+        }
+        numPoints = closed ? 2 * numPoints : 2 * numPoints - 1;
+        // The edge points of the edges j with j + maxPatchSize >= begin and j - maxPatchSize + 1 < end
+        begin = 2 * (begin - maxPatchSize) + 1;
+        end = 2 * (end + maxPatchSize - 2) + 2;
+        if (!closed) {
+            begin = std::max(begin, 0);
+            end = std::min(end, numPoints);
+        }
+    }
+    addWrappedRange(changes, begin, end, numPoints, closed);
+}
+
+} // namespace
+
+ConisCurve::ConisCurve(const SubdivisionSettings &subdivSettings,
+                       const NormalRefinementSettings &normRefSettings,
+                       std::pmr::memory_resource *memoryResource)
     : subdivSettings_(subdivSettings),
       normRefSettings_(normRefSettings),
+      memoryResource_(memoryResource != nullptr ? memoryResource : &memoryPool_),
       subdivider_(subdivSettings_),
-      normalRefiner_(normRefSettings, subdivSettings) {}
+      normalRefiner_(normRefSettings, subdivSettings),
+      snapshot_(std::make_shared<CurveSnapshot>()) {
+    prepareControlCurve();
+    subdivider_.setMemoryResource(&memoryResource_);
+    normalRefiner_.setMemoryResource(&memoryResource_);
+}
+
+ConisCurve::~ConisCurve() {
+    // The refinement job publishes its normals to this curve
+    cancelRefinement();
+}
+
+/*
+ * The control curve is used for picking and edited point by point, which should stay interactive for large curves. A
+ * replaced control curve comes without the spatial index and the chunked storage, so this is called after every
+ * replacement.
+ */
+void ConisCurve::prepareControlCurve() {
+    controlCurve_.setSpatialIndexEnabled(true);
+    controlCurve_.setChunkedStorageEnabled(true);
+}
 
 void ConisCurve::subdivideCurve(const int level) {
+    // The level or the subdivision settings changed, either of which affects the entire subdivision curve
+    subdivInvalidated_ = true;
     lastSubdivLevel_ = level;
-    controlCurve_.copyDataTo(subdivCurve_);
-    subdivider_.subdivide(subdivCurve_, level);
+    updateSubdivision();
+}
+
+void ConisCurve::updateSubdivision() {
+    if (editDepth_ > 0) {
+        subdivisionPending_ = true;
+        return;
+    }
+    const int level = lastSubdivLevel_;
+    // Subdivide into a new snapshot; the previous one may still be in use by readers. The buffers of an earlier
+    // snapshot are reused once no reader holds it anymore.
+    std::shared_ptr<CurveSnapshot> snapshot = std::exchange(spareSnapshot_, nullptr);
+    if (!snapshot) {
+        snapshot = std::make_shared<CurveSnapshot>();
+    }
+    Curve &subdivCurve = snapshot->subdivCurve;
+    // The points inserted or removed since the last subdivision are only in the chunks of the control curve. Copy them
+    // into its arrays once, rather than letting the subdivider look up every point in the chunks.
+    controlCurve_.syncArrays();
+    if (subdivSettings_.fullPrecisionLevels >= 0 && level > subdivSettings_.fullPrecisionLevels) {
+        if (subdivSettings_.floatPreview) {
+            subdivideCompact<float>(level, subdivCurve);
+        } else {
+            subdivideCompact<double>(level, subdivCurve);
+        }
+    } else {
+        controlCurve_.copyDataTo(subdivCurve);
+        subdivider_.subdivide(subdivCurve, level);
+    }
+    // Copies only the data, not the spatial index
+    controlCurve_.copyDataTo(snapshot->controlCurve);
+    snapshot->subdivLevel = level;
+    snapshot->version = snapshot_->version + 1;
+    recordSubdivChanges(snapshot_->subdivCurve, subdivCurve);
+    std::shared_ptr<const CurveSnapshot> previous = std::atomic_exchange(&snapshot_,
+                                                                         std::shared_ptr<const CurveSnapshot>(snapshot));
+    snapshot.reset();
+    // Readers can no longer obtain the previous snapshot, so it is free if this is the last reference to it
+    if (previous.use_count() == 1) {
+        spareSnapshot_ = std::const_pointer_cast<CurveSnapshot>(std::move(previous));
+    }
     notifyListeners();
 }
 
+/*
+ * Derives the changes of the subdivision curve from the control points edited since the previous subdivision, rather
+ * than comparing both versions of the curves. Inserted or removed inflection points shift the subdivision curve, in
+ * which case it is reported as changed entirely.
+ */
+void ConisCurve::recordSubdivChanges(const Curve &previousSubdivCurve, const Curve &subdivCurve) {
+    const int level = lastSubdivLevel_;
+    const CurveChanges controlChanges = std::exchange(controlEdits_, {});
+    // The inflection points in the index space of the control curve with the inflection points inserted
+    std::vector<int> inflPoints = subdivider_.getInflPointIndices();
+    for (int &inflIdx: inflPoints) {
+        inflIdx >>= level;
+    }
+    CurveChanges subdivChanges;
+    if (controlChanges.resized || subdivCurve.numPoints() != previousSubdivCurve.numPoints() ||
+        subdivCurve.isClosed() != previousSubdivCurve.isClosed()) {
+        subdivChanges.resized = true;
+    } else if (subdivInvalidated_ || inflPoints != subdivInflPoints_) {
+        subdivChanges.add({0, subdivCurve.numPoints()});
+    } else if (level == 0) {
+        subdivChanges = controlChanges;
+    } else {
+        // An edge point is fitted through at most this many points on either side of its edge (see
+        // ConicSubdivider::edgePoint)
+        const int maxPatchSize = subdivSettings_.dynamicPatchSize ? std::max(subdivSettings_.patchSize, 4)
+                                                                  : subdivSettings_.patchSize;
+        for (const IndexRange &range: controlChanges.ranges) {
+            addSubdivRange(subdivChanges, range.begin, range.end, controlCurve_, inflPoints, level, maxPatchSize);
+        }
+    }
+    subdivInvalidated_ = false;
+    subdivInflPoints_ = std::move(inflPoints);
+    pendingChanges_.control.merge(controlChanges);
+    pendingChanges_.subdiv.merge(subdivChanges);
+}
+
+void ConisCurve::recordEdit(const int begin, const int end) {
+    CurveChanges edited;
+    addWrappedRange(edited, begin, end, controlCurve_.numPoints(), controlCurve_.isClosed());
+    for (const IndexRange &range: edited.ranges) {
+        historyEdits_.pointsChanged(range.begin, range.end);
+    }
+    controlEdits_.merge(edited);
+}
+
+void ConisCurve::recordInsert(const int idx) {
+    controlEdits_.resized = true;
+    historyEdits_.pointInserted(idx);
+    // The normals of the neighbours were recalculated as well
+    recordEdit(idx - 1, idx + 2);
+}
+
+void ConisCurve::recordRemove(const int idx) {
+    controlEdits_.resized = true;
+    historyEdits_.pointRemoved(idx);
+    recordEdit(idx - 1, idx + 1);
+}
+
+void ConisCurve::recordReplace() {
+    controlEdits_.resized = true;
+    historyEdits_.curveReplaced();
+}
+
+/*
+ * Subdivides the control curve with the mixed precision schedule (see SubdivisionSettings::fullPrecisionLevels). The
+ * subdivision curve is exposed as a regular curve, so the compact result is converted into it and released right away
+ * rather than kept alongside it.
+ */
+template<typename S>
+void ConisCurve::subdivideCompact(const int level, Curve &subdivCurve) {
+    CompactCurve<S> result;
+    subdivider_.subdivide(controlCurve_, level, result);
+    result.copyDataTo(subdivCurve);
+}
+
+std::shared_ptr<const CurveSnapshot> ConisCurve::getSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+void ConisCurve::beginEdit() {
+    editDepth_++;
+}
+
+void ConisCurve::commit() {
+    if (editDepth_ == 0 || --editDepth_ > 0) {
+        return;
+    }
+    if (subdivisionPending_) {
+        subdivisionPending_ = false;
+        updateSubdivision();
+    }
+}
+
 Conic ConisCurve::getConicAtIndex(const int idx) const {
     const std::vector<PatchPoint> patch = subdivider_.extractPatch(controlCurve_, idx, subdivSettings_.patchSize);
     ConicFitter fitter(subdivSettings_.epsilon);
@@ -31,15 +279,20 @@ Conic ConisCurve::getConicAtIndex(const int idx) const {
 
 void ConisCurve::insertInflectionPoints() {
     controlCurve_ = subdivider_.getInflPointCurve(controlCurve_);
-    const auto &customNorms = controlCurve_.getCustomNormals();
+    prepareControlCurve();
+    updateInflPointIndices();
+    recordReplace();
+    updateSubdivision();
+}
 
+void ConisCurve::updateInflPointIndices() {
+    const auto &customNorms = controlCurve_.getCustomNormals();
     inflPointIndices_.clear();
-    for (int i = 0; i < customNorms.size(); i++) {
+    for (int i = 0; i < static_cast<int>(customNorms.size()); i++) {
         if (customNorms[i]) {
             inflPointIndices_.insert(i);
         }
     }
-    resubdivide();
 }
 
 void ConisCurve::resubdivide() {
@@ -48,80 +301,209 @@ void ConisCurve::resubdivide() {
 
 void ConisCurve::setControlCurve(Curve controlCurve) {
     controlCurve_ = controlCurve;
-    lastSubdivLevel_ = 0;
-    resubdivide();
+    prepareControlCurve();
+    recordReplace();
+    subdivideCurve(0);
 }
 
 void ConisCurve::recalculateNormals() {
     controlCurve_.recalculateNormals(subdivSettings_.areaWeightedNormals, subdivSettings_.circleNormals);
-    resubdivide();
+    recordEdit(0, controlCurve_.numPoints());
+    updateSubdivision();
 }
 
 void ConisCurve::refineNormals(const CurvatureType curvatureType) {
-    // Note that this does not refine the inflection point normals unless they have been explicitly inserted by the user
+    const int numPoints = controlCurve_.numPoints();
     normalRefiner_.refine(controlCurve_, curvatureType);
-    resubdivide();
-    notifyListeners();
+    CONIS_LOG(LOG_DEBUG, "Refinement memory: " << memoryResource_.stats());
+    if (controlCurve_.numPoints() != numPoints) {
+        // The refinement inserted inflection points
+        updateInflPointIndices();
+        recordReplace();
+    } else {
+        recordEdit(0, numPoints);
+    }
+    updateSubdivision();
 }
 
 void ConisCurve::refineNormal(const int idx, const CurvatureType curvatureType) {
     normalRefiner_.refineSelected(controlCurve_, curvatureType, idx);
-    resubdivide();
-    notifyListeners();
+    recordEdit(idx, idx + 1);
+    updateSubdivision();
 }
 
-void ConisCurve::refineNormalsProgressively(CurvatureType curvatureType) {
-    // Note that this does not refine the inflection point normals unless they have been explicitly inserted by the user
-    const auto refineLambda = [this, curvatureType]() {
-        normalRefiner_.refine(controlCurve_, curvatureType);
-    };
-    const auto waitLambda = [this]() {
-        resubdivide();
-        notifyListeners();
+JobHandle ConisCurve::refineNormalsProgressively(const CurvatureType curvatureType) {
+    cancelRefinement();
+    // The refinement inserts the inflection points into the curve it refines. They are inserted into the control curve
+    // up front, so that the published normals belong to its vertices.
+    Curve inflCurve = subdivider_.getInflPointCurve(controlCurve_);
+    if (inflCurve.numPoints() != controlCurve_.numPoints()) {
+        controlCurve_ = std::move(inflCurve);
+        prepareControlCurve();
+        updateInflPointIndices();
+        recordReplace();
+        updateSubdivision();
+    }
+    // The settings are copied, since they may be changed on the calling thread while the refinement runs
+    const auto refineJob = [this, curve = controlCurve_, curvatureType, subdivSettings = subdivSettings_,
+                            normRefSettings = normRefSettings_](const CancellationToken &token) mutable {
+        // A refiner of its own, as its workspaces cannot be shared with refinements on the calling thread
+        NormalRefiner refiner(normRefSettings, subdivSettings);
+        // The progress is reported between vertices, when the copy is not being modified. Publishing after every
+        // vertex would copy all normals for every refined vertex, so the normals are published at most every
+        // publishInterval.
+        auto lastPublished = std::chrono::steady_clock::now();
+        refiner.setProgressCallback([&](std::string_view, int, int) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastPublished >= publishInterval) {
+                publishNormals(curve.getNormals());
+                lastPublished = now;
+            }
+        });
+        refiner.refine(curve, curvatureType, token);
+        publishNormals(curve.getNormals());
     };
-    AsyncRunner::runAndWait(refineLambda, waitLambda);
+    refinementJob_ = jobSystem().submit(refineJob, PRIORITY_BACKGROUND);
+    return refinementJob_;
 }
 
-void ConisCurve::refineNormalProgressively(int idx, CurvatureType curvatureType) {
-    const auto refineLambda = [this, idx, curvatureType]() {
-        normalRefiner_.refineSelected(controlCurve_, curvatureType, idx);
+JobHandle ConisCurve::refineNormalProgressively(const int idx, const CurvatureType curvatureType) {
+    cancelRefinement();
+    const auto refineJob = [this, curve = controlCurve_, idx, curvatureType, subdivSettings = subdivSettings_,
+                            normRefSettings = normRefSettings_](const CancellationToken &) mutable {
+        NormalRefiner refiner(normRefSettings, subdivSettings);
+        refiner.refineSelected(curve, curvatureType, idx);
+        publishNormals(curve.getNormals());
     };
-    const auto waitLambda = [this]() {
-        resubdivide();
-        notifyListeners();
-    };
-    AsyncRunner::runAndWait(refineLambda, waitLambda);
+    refinementJob_ = jobSystem().submit(refineJob, PRIORITY_INTERACTIVE);
+    return refinementJob_;
+}
+
+void ConisCurve::publishNormals(const std::vector<Vector2DD> &normals) {
+    std::lock_guard lock(snapshotMutex_);
+    refinedNormals_ = normals;
+}
+
+bool ConisCurve::applyRefinementSnapshot() {
+    std::optional<std::vector<Vector2DD>> normals;
+    {
+        std::lock_guard lock(snapshotMutex_);
+        normals.swap(refinedNormals_);
+    }
+    if (!normals) {
+        return false;
+    }
+    if (normals->size() != controlCurve_.getNormals().size()) {
+        // Points were added or removed since the refinement started, so the normals no longer belong to the vertices
+        return false;
+    }
+    controlCurve_.setNormals(*normals);
+    recordEdit(0, controlCurve_.numPoints());
+    updateSubdivision();
+    return true;
+}
+
+void ConisCurve::cancelRefinement() {
+    refinementJob_.cancel();
+    refinementJob_.wait();
+    refinementJob_ = {};
+    std::lock_guard lock(snapshotMutex_);
+    refinedNormals_.reset();
 }
 
 int ConisCurve::addPoint(const Vector2DD &p) {
     const int idx = controlCurve_.addPoint(p);
-    resubdivide();
+    recordInsert(idx);
+    updateSubdivision();
     return idx;
 }
 
 void ConisCurve::removePoint(const int idx) {
     controlCurve_.removePoint(idx);
-    resubdivide();
+    recordRemove(idx);
+    updateSubdivision();
+}
+
+void ConisCurve::checkpoint() {
+    if (historyIdx_ >= 0 && historyEdits_.empty()) {
+        return;
+    }
+    history_.resize(historyIdx_ + 1);
+    if (history_.empty()) {
+        history_.push_back({PersistentCurve(controlCurve_), inflPointIndices_});
+    } else {
+        history_.push_back(
+                {PersistentCurve(controlCurve_, history_.back().controlCurve, historyEdits_), inflPointIndices_});
+    }
+    historyIdx_++;
+    historyEdits_ = PersistentCurve::Edits(history_.back().controlCurve);
+}
+
+bool ConisCurve::undo() {
+    cancelRefinement();
+    checkpoint();
+    if (historyIdx_ <= 0) {
+        return false;
+    }
+    restoreHistoryStep(historyIdx_ - 1);
+    return true;
+}
+
+bool ConisCurve::redo() {
+    cancelRefinement();
+    // Unrecorded edits discard the undone steps, like any other edit
+    checkpoint();
+    if (historyIdx_ + 1 >= static_cast<int>(history_.size())) {
+        return false;
+    }
+    restoreHistoryStep(historyIdx_ + 1);
+    return true;
+}
+
+bool ConisCurve::canUndo() const {
+    return historyIdx_ > 0 || (historyIdx_ == 0 && !historyEdits_.empty());
+}
+
+bool ConisCurve::canRedo() const {
+    return historyIdx_ + 1 < static_cast<int>(history_.size()) && historyEdits_.empty();
+}
+
+void ConisCurve::clearHistory() {
+    history_.clear();
+    historyIdx_ = -1;
+    historyEdits_ = {};
+}
+
+void ConisCurve::restoreHistoryStep(const int idx) {
+    historyIdx_ = idx;
+    history_[idx].controlCurve.copyDataTo(controlCurve_);
+    inflPointIndices_ = history_[idx].inflPointIndices;
+    controlEdits_.resized = true;
+    historyEdits_ = PersistentCurve::Edits(history_[idx].controlCurve);
+    updateSubdivision();
 }
 
 void ConisCurve::setControlCurveClosed(const bool closed) {
     controlCurve_.setClosed(closed);
-    resubdivide();
+    recordReplace();
+    updateSubdivision();
 }
 
 void ConisCurve::recalculateNormal(const int idx) {
     controlCurve_.recalculateNormal(idx);
-    resubdivide();
+    recordEdit(idx, idx + 1);
+    updateSubdivision();
 }
 
 void ConisCurve::setVertexPosition(const int idx, const Vector2DD &p) {
     controlCurve_.setVertexPosition(idx, p);
-    resubdivide();
+    // The normals of the neighbours are recalculated as well
+    recordEdit(idx - 1, idx + 2);
+    updateSubdivision();
 }
 
 void ConisCurve::redirectNormalToPoint(const int idx, const Vector2DD &p, const bool constrain) {
-    Vector2DD &normal = controlCurve_.getNormal(idx);
-    normal = (p - controlCurve_.getVertex(idx)).normalized();
+    Vector2DD normal = (p - std::as_const(controlCurve_).getVertex(idx)).normalized();
     // Always allow free movement of the inflection point indices
     if (constrain && inflPointIndices_.count(idx) == 0) {
         int n = controlCurve_.numPoints();
@@ -149,12 +531,15 @@ void ConisCurve::redirectNormalToPoint(const int idx, const Vector2DD &p, const
             normal = cross < 0 ? -1 * normal : normal;
         }
     }
-    resubdivide();
+    controlCurve_.setNormal(idx, normal);
+    recordEdit(idx, idx + 1);
+    updateSubdivision();
 }
 
 void ConisCurve::translate(const Vector2DD &d) {
     controlCurve_.translate(d);
-    resubdivide();
+    recordEdit(0, controlCurve_.numPoints());
+    updateSubdivision();
 }
 
 void ConisCurve::addListener(Listener *listener) {
@@ -175,11 +560,33 @@ void ConisCurve::removeListener(Listener *listener) {
     }
 }
 void ConisCurve::notifyListeners() {
+    if (!notificationScheduler_) {
+        flushNotifications();
+        return;
+    }
+    if (!notificationScheduled_) {
+        notificationScheduled_ = true;
+        notificationScheduler_();
+    }
+}
+
+void ConisCurve::flushNotifications() {
+    notificationScheduled_ = false;
+    if (pendingChanges_.empty()) {
+        return;
+    }
+    // Listeners may edit the curve, which starts a new set of changes
+    const ChangeSet changes = std::exchange(pendingChanges_, {});
     for (auto *listener: listeners) {
         if (listener) {
-            listener->onListenerUpdated();
+            listener->onListenerUpdated(changes);
         }
     }
 }
 
+void ConisCurve::setNotificationScheduler(std::function<void()> scheduler) {
+    notificationScheduler_ = std::move(scheduler);
+    notificationScheduled_ = false;
+}
+
 } // namespace conis::core
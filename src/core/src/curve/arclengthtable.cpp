@@ -0,0 +1,103 @@
+#include "conis/core/curve/arclengthtable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace conis::core {
+
+// Edges per block of the prefix sum. Fixed, so that the lengths are summed in the same order for any number of threads.
+constexpr int arcLengthBlockSize = 4096;
+
+ArcLengthTable::ArcLengthTable(const Curve &curve) : curve_(curve) {
+    const auto &verts = curve.getVertices();
+    const int n = curve.numPoints();
+    const int numEdges = n == 0 ? 0 : (curve.isClosed() ? n : n - 1);
+    lengths_.resize(numEdges + (n == 0 ? 0 : 1));
+    if (lengths_.empty()) {
+        return;
+    }
+    lengths_[0] = 0;
+    // Sum the edge lengths of every block, add up the block sums and then offset the blocks by these
+    const int numBlocks = (numEdges + arcLengthBlockSize - 1) / arcLengthBlockSize;
+    std::vector<real_t> blockOffsets(numBlocks + 1, 0);
+#pragma omp parallel for schedule(static) if (numBlocks > 1)
+    for (int block = 0; block < numBlocks; block++) {
+        const int begin = block * arcLengthBlockSize;
+        const int end = std::min(begin + arcLengthBlockSize, numEdges);
+        real_t sum = 0;
+        for (int i = begin; i < end; i++) {
+            const int next = i + 1 < n ? i + 1 : 0;
+            sum += (verts[next] - verts[i]).norm();
+            lengths_[i + 1] = sum;
+        }
+        blockOffsets[block + 1] = sum;
+    }
+    for (int block = 0; block < numBlocks; block++) {
+        blockOffsets[block + 1] += blockOffsets[block];
+    }
+#pragma omp parallel for schedule(static) if (numBlocks > 1)
+    for (int block = 1; block < numBlocks; block++) {
+        const int begin = block * arcLengthBlockSize;
+        const int end = std::min(begin + arcLengthBlockSize, numEdges);
+        for (int i = begin; i < end; i++) {
+            lengths_[i + 1] += blockOffsets[block];
+        }
+    }
+}
+
+std::pair<int, real_t> ArcLengthTable::locate(const real_t length) const {
+    const int numEdges = static_cast<int>(lengths_.size()) - 1;
+    if (numEdges <= 0) {
+        return {0, 0};
+    }
+    const real_t clamped = std::clamp(length, real_t(0), totalLength());
+    // The last edge whose start lies at or before the given length
+    const auto it = std::upper_bound(lengths_.begin(), lengths_.end(), clamped);
+    const int idx = std::clamp(static_cast<int>(it - lengths_.begin()) - 1, 0, numEdges - 1);
+    const real_t edgeLength = lengths_[idx + 1] - lengths_[idx];
+    const real_t t = edgeLength > 0 ? std::min((clamped - lengths_[idx]) / edgeLength, real_t(1)) : real_t(0);
+    return {idx, t};
+}
+
+Vector2DD ArcLengthTable::positionAt(const real_t length) const {
+    if (curve_.numPoints() == 0) {
+        return {0, 0};
+    }
+    const auto [idx, t] = locate(length);
+    return mix(curve_.getVertex(idx), curve_.getVertex(curve_.getNextIdx(idx)), t);
+}
+
+int ArcLengthTable::numUniformSamples(const real_t spacing) const {
+    const int n = curve_.numPoints();
+    if (n <= 1 || totalLength() == 0) {
+        return n == 0 ? 0 : 1;
+    }
+    const real_t numSpaces = std::max(real_t(1), floor(totalLength() / spacing + real_t(0.5)));
+    // Closed curves do not repeat the first point at the end
+    return static_cast<int>(numSpaces) + (curve_.isClosed() ? 0 : 1);
+}
+
+void ArcLengthTable::uniformSamples(const real_t spacing, std::vector<Vector2DD> &points) const {
+    const int numSamples = numUniformSamples(spacing);
+    points.resize(numSamples);
+    if (numSamples == 1) {
+        points[0] = curve_.getVertex(0);
+        return;
+    }
+    const int numSpaces = curve_.isClosed() ? numSamples : numSamples - 1;
+    const real_t step = totalLength() / numSpaces;
+    // Every sample is located independently, which keeps the parallel loop free of dependencies
+#pragma omp parallel for schedule(static) if (numSamples > arcLengthBlockSize)
+    for (int i = 0; i < numSamples; i++) {
+        points[i] = positionAt(i == numSpaces ? totalLength() : step * i);
+    }
+}
+
+Curve ArcLengthTable::resample(const real_t spacing) const {
+    std::vector<Vector2DD> points;
+    uniformSamples(spacing, points);
+    return Curve(std::move(points), curve_.isClosed());
+}
+
+} // namespace conis::core
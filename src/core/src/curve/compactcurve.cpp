@@ -0,0 +1,35 @@
+#include "conis/core/curve/compactcurve.hpp"
+
+#include "curveutils.hpp"
+
+namespace conis::core {
+
+template<typename S>
+void CompactCurve<S>::recalculateNormals(const bool areaWeightedNormals, const bool circleNormals) {
+    const int n = numPoints();
+    CurveUtils::calcNormals(getXs(),
+                            getYs(),
+                            n,
+                            closed_,
+                            0,
+                            n,
+                            areaWeightedNormals,
+                            circleNormals,
+                            getNormalXs(),
+                            getNormalYs());
+}
+
+template<typename S>
+void CompactCurve<S>::calcCurvatures(const int begin,
+                                     const int end,
+                                     const CurvatureType curvatureType,
+                                     const bool fastMath,
+                                     S *curvatures) const {
+    CurveUtils::calcCurvatures(getXs(), getYs(), numPoints(), closed_, begin, end, curvatureType, fastMath, curvatures);
+}
+
+// The kernels are only vectorised for these types
+template class CompactCurve<double>;
+template class CompactCurve<float>;
+
+} // namespace conis::core
@@ -0,0 +1,193 @@
+#include "conis/core/curve/curvatureprofile.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "curveutils.hpp"
+
+namespace conis::core {
+
+// Vertices per block. Fixed, so that the statistics are summed in the same order for any number of threads.
+constexpr int curvatureBlockSize = 4096;
+
+using BlockStats = struct BlockStats {
+    real_t max = 0;
+    real_t sum = 0;
+    real_t totalVariation = 0;
+    real_t maxJump = 0;
+    int maxJumpIdx = -1;
+};
+
+// Includes the jump between vertex idx and the next vertex
+static void addJump(const real_t jump, const int idx, real_t &totalVariation, real_t &maxJump, int &maxJumpIdx) {
+    totalVariation += jump;
+    // Ties go to the first jump, since the jumps are added in order
+    if (jump > maxJump || maxJumpIdx < 0) {
+        maxJump = jump;
+        maxJumpIdx = idx;
+    }
+}
+
+static void blockCurvatures(const Curve &curve,
+                            const int begin,
+                            const int end,
+                            const CurvatureType curvatureType,
+                            const bool fastMath,
+                            real_t *curvatures,
+                            std::vector<real_t> & /*scratch*/) {
+    CurveUtils::calcCurvatures(curve.getVertices(), curve.isClosed(), begin, end, curvatureType, fastMath, curvatures);
+}
+
+// Compact curves compute the curvatures in their own precision, in the scratch buffer unless that is real_t
+template<typename S>
+static void blockCurvatures(const CompactCurve<S> &curve,
+                            const int begin,
+                            const int end,
+                            const CurvatureType curvatureType,
+                            const bool fastMath,
+                            real_t *curvatures,
+                            std::vector<S> &scratch) {
+    if constexpr (std::is_same_v<S, real_t>) {
+        curve.calcCurvatures(begin, end, curvatureType, fastMath, curvatures);
+    } else {
+        curve.calcCurvatures(begin, end, curvatureType, fastMath, scratch.data());
+        std::copy(scratch.begin() + begin, scratch.begin() + end, curvatures + begin);
+    }
+}
+
+template<typename CurveT>
+static void computeProfiles(const CurveT &curve,
+                            CurvatureProfile *profiles,
+                            const int numProfiles,
+                            const bool fastMath) {
+    using S = typename std::decay_t<decltype(curve.getVertex(0))>::Scalar;
+    const bool closed = curve.isClosed();
+    const int n = curve.numPoints();
+    std::vector<S> scratch(std::is_same_v<S, real_t> ? 0 : n);
+    // The end points of open curves have no well-defined curvature, so they are excluded from the statistics
+    const int first = closed ? 0 : 1;
+    const int last = closed ? n - 1 : n - 2;
+    const int numBlocks = (n + curvatureBlockSize - 1) / curvatureBlockSize;
+    std::vector<BlockStats> blockStats(static_cast<size_t>(numBlocks) * numProfiles);
+    for (int p = 0; p < numProfiles; p++) {
+        profiles[p].curvatures.resize(n);
+    }
+
+#pragma omp parallel for schedule(static) if (numBlocks > 1)
+    for (int block = 0; block < numBlocks; block++) {
+        const int begin = block * curvatureBlockSize;
+        const int end = std::min(begin + curvatureBlockSize, n);
+        const int lo = std::max(begin, first);
+        const int hi = std::min(end, last + 1);
+        for (int p = 0; p < numProfiles; p++) {
+            real_t *curvatures = profiles[p].curvatures.data();
+            // Computing the statistics right after the curvatures of a block keeps these in the cache
+            blockCurvatures(curve, begin, end, profiles[p].curvatureType, fastMath, curvatures, scratch);
+            BlockStats &stats = blockStats[block * numProfiles + p];
+            for (int i = lo; i < hi; i++) {
+                stats.max = std::max(stats.max, curvatures[i]);
+                stats.sum += curvatures[i];
+                if (i > lo) {
+                    addJump(abs(curvatures[i] - curvatures[i - 1]),
+                            i - 1,
+                            stats.totalVariation,
+                            stats.maxJump,
+                            stats.maxJumpIdx);
+                }
+            }
+        }
+    }
+
+    const int numDefined = std::max(last - first + 1, 0);
+    for (int p = 0; p < numProfiles; p++) {
+        const std::vector<real_t> &curvatures = profiles[p].curvatures;
+        CurvatureStats &stats = profiles[p].stats;
+        stats = {};
+        real_t sum = 0;
+        for (int block = 0; block < numBlocks; block++) {
+            const BlockStats &partial = blockStats[block * numProfiles + p];
+            const int begin = block * curvatureBlockSize;
+            // The jump from the last vertex of the previous block
+            if (begin > first && begin <= last) {
+                addJump(abs(curvatures[begin] - curvatures[begin - 1]),
+                        begin - 1,
+                        stats.totalVariation,
+                        stats.maxJump,
+                        stats.maxJumpIdx);
+            }
+            stats.max = std::max(stats.max, partial.max);
+            sum += partial.sum;
+            stats.totalVariation += partial.totalVariation;
+            if (partial.maxJumpIdx >= 0 && (partial.maxJump > stats.maxJump || stats.maxJumpIdx < 0)) {
+                stats.maxJump = partial.maxJump;
+                stats.maxJumpIdx = partial.maxJumpIdx;
+            }
+        }
+        if (closed && n > 1) {
+            addJump(abs(curvatures[0] - curvatures[n - 1]),
+                    n - 1,
+                    stats.totalVariation,
+                    stats.maxJump,
+                    stats.maxJumpIdx);
+        }
+        stats.mean = numDefined > 0 ? sum / static_cast<real_t>(numDefined) : real_t(0);
+    }
+}
+
+void computeCurvatureProfile(const Curve &curve,
+                             const CurvatureType curvatureType,
+                             CurvatureProfile &profile,
+                             const bool fastMath) {
+    profile.curvatureType = curvatureType;
+    computeProfiles(curve, &profile, 1, fastMath);
+}
+
+CurvatureProfile computeCurvatureProfile(const Curve &curve, const CurvatureType curvatureType, const bool fastMath) {
+    CurvatureProfile profile;
+    computeCurvatureProfile(curve, curvatureType, profile, fastMath);
+    return profile;
+}
+
+std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const Curve &curve, const bool fastMath) {
+    std::array<CurvatureProfile, numCurvatureTypes> profiles;
+    for (int type = 0; type < numCurvatureTypes; type++) {
+        profiles[type].curvatureType = static_cast<CurvatureType>(type);
+    }
+    computeProfiles(curve, profiles.data(), numCurvatureTypes, fastMath);
+    return profiles;
+}
+
+template<typename S>
+void computeCurvatureProfile(const CompactCurve<S> &curve,
+                             const CurvatureType curvatureType,
+                             CurvatureProfile &profile,
+                             const bool fastMath) {
+    profile.curvatureType = curvatureType;
+    computeProfiles(curve, &profile, 1, fastMath);
+}
+
+template<typename S>
+std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const CompactCurve<S> &curve,
+                                                                         const bool fastMath) {
+    std::array<CurvatureProfile, numCurvatureTypes> profiles;
+    for (int type = 0; type < numCurvatureTypes; type++) {
+        profiles[type].curvatureType = static_cast<CurvatureType>(type);
+    }
+    computeProfiles(curve, profiles.data(), numCurvatureTypes, fastMath);
+    return profiles;
+}
+
+template void computeCurvatureProfile(const CompactCurve<double> &curve,
+                                      CurvatureType curvatureType,
+                                      CurvatureProfile &profile,
+                                      bool fastMath);
+template void computeCurvatureProfile(const CompactCurve<float> &curve,
+                                      CurvatureType curvatureType,
+                                      CurvatureProfile &profile,
+                                      bool fastMath);
+template std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const CompactCurve<double> &curve,
+                                                                                  bool fastMath);
+template std::array<CurvatureProfile, numCurvatureTypes> computeCurvatureProfiles(const CompactCurve<float> &curve,
+                                                                                  bool fastMath);
+
+} // namespace conis::core
@@ -9,6 +9,9 @@
 
 namespace conis::core {
 
+// Vertices per block when recalculating the normals in parallel
+constexpr int normalBlockSize = 4096;
+
 Curve::Curve() : Curve({}, {}, false) {}
 
 Curve::Curve(const bool closed) : Curve({}, {}, closed) {}
@@ -19,110 +22,349 @@ Curve::Curve(std::vector<Vector2DD> verts, std::vector<Vector2DD> normals, const
     : closed_(closed),
       vertices_(std::move(verts)),
       normals_(std::move(normals)) {
-    customNormals_.resize(vertices_.size());
-    std::fill(customNormals_.begin(), customNormals_.end(), false);
+    customNormals_.assign(vertices_.size(), false);
     if (normals_.size() != vertices_.size()) {
-        normals_ = calcNormals(vertices_);
+        normals_.resize(vertices_.size());
+        calcNormals(0, numPoints());
     }
 }
 
 void Curve::setVertex(const int idx, const Vector2DD &coord) {
-    if (idx < 0 || idx >= static_cast<int>(vertices_.size())) {
+    if (idx < 0 || idx >= numPoints()) {
         throw std::out_of_range("Index out of bounds in setVertex");
     }
-    vertices_[idx] = coord;
+    const bool updateIndex = isSpatialIndexUpToDate();
+    if (updateIndex) {
+        updateSpatialIndex(idx, false);
+    }
+    storeVertex(idx, coord);
+    if (updateIndex) {
+        updateSpatialIndex(idx, true);
+    }
 }
 
 void Curve::setNormal(const int idx, const Vector2DD &normal) {
-    if (idx < 0 || idx >= static_cast<int>(normals_.size())) {
+    if (idx < 0 || idx >= numPoints()) {
         throw std::out_of_range("Index out of bounds in setNormal");
     }
+    storeNormal(idx, normal);
+    includeNormalLength(normal);
+}
+
+void Curve::calcNormals(const int begin, const int end) {
+    const int numBlocks = (end - begin + normalBlockSize - 1) / normalBlockSize;
+#pragma omp parallel for schedule(static) if (numBlocks > 1)
+    for (int block = 0; block < numBlocks; block++) {
+        const int blockBegin = begin + block * normalBlockSize;
+        const int blockEnd = std::min(blockBegin + normalBlockSize, end);
+        CurveUtils::calcNormals(vertices_,
+                                closed_,
+                                blockBegin,
+                                blockEnd,
+                                areaWeightedNormals_,
+                                circleNormals_,
+                                normals_.data());
+    }
+}
+
+void Curve::calcNormal(const int idx) {
+    if (chunked_) {
+        // The same functions as the kernel for a range, but on the neighbours looked up in the chunks
+        const Vector2DD &a = points_[getPrevIdx(idx)].vertex;
+        const Vector2DD &b = points_[idx].vertex;
+        const Vector2DD &c = points_[getNextIdx(idx)].vertex;
+        storeNormal(idx,
+                    circleNormals_ ? CurveUtils::calcNormalOscCircles(a, b, c)
+                                   : CurveUtils::calcNormal(a, b, c, areaWeightedNormals_));
+        return;
+    }
+    // The same kernel as for a range, so that a normal does not depend on how it was recalculated
+    CurveUtils::calcNormals(vertices_, closed_, idx, idx + 1, areaWeightedNormals_, circleNormals_, normals_.data());
+}
+
+void Curve::storeVertex(const int idx, const Vector2DD &vertex) {
+    if (chunked_) {
+        points_[idx].vertex = vertex;
+        if (!arraysValid_) {
+            return;
+        }
+    }
+    vertices_[idx] = vertex;
+}
+
+void Curve::storeNormal(const int idx, const Vector2DD &normal) {
+    if (chunked_) {
+        points_[idx].normal = normal;
+        if (!arraysValid_) {
+            return;
+        }
+    }
     normals_[idx] = normal;
 }
 
-std::vector<Vector2DD> Curve::calcNormals(const std::vector<Vector2DD> &verts) const {
-    std::vector<Vector2DD> normals;
-    const int n = static_cast<int>(verts.size());
-    normals.resize(n);
-    for (int i = 0; i < n; i++) {
-        normals[i] = calcNormalAtIndex(verts, i);
+void Curve::storeCustomNormal(const int idx, const bool customNormal) {
+    if (chunked_) {
+        points_[idx].customNormal = customNormal;
+        if (!arraysValid_) {
+            return;
+        }
+    }
+    customNormals_[idx] = customNormal;
+}
+
+void Curve::setChunkedStorageEnabled(const bool enabled) {
+    chunkedStorageEnabled_ = enabled;
+    if (!enabled) {
+        useArrays();
+    }
+}
+
+void Curve::enterChunkedStorage() {
+    std::vector<ControlPoint> points(vertices_.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i] = {vertices_[i], normals_[i], customNormals_[i] != 0};
     }
+    // The ids are assigned in order, so they equal the indices the spatial index refers to so far
+    points_.assign(points.begin(), points.end());
+    chunked_ = true;
+    arraysValid_ = true;
+}
 
-    return normals;
+void Curve::leaveChunkedStorage() {
+    syncArrays();
+    chunked_ = false;
+    points_.clear();
+    // The ids of the points no longer match their indices
+    invalidateSpatialIndex();
 }
 
-Vector2DD Curve::calcNormalAtIndex(const std::vector<Vector2DD> &verts, const int i) const {
-    const Vector2DD &a = verts[getPrevIdx(i)];
-    const Vector2DD &b = verts[i];
-    const Vector2DD &c = verts[getNextIdx(i)];
-    if (circleNormals_) {
-        return CurveUtils::calcNormalOscCircles(a, b, c);
+void Curve::copyPointsToArrays() const {
+    const int n = points_.size();
+    vertices_.resize(n);
+    normals_.resize(n);
+    customNormals_.resize(n);
+    int i = 0;
+    for (const ControlPoint &point: points_) {
+        vertices_[i] = point.vertex;
+        normals_[i] = point.normal;
+        customNormals_[i] = point.customNormal;
+        i++;
     }
-    return CurveUtils::calcNormal(a, b, c, areaWeightedNormals_);
+    arraysValid_ = true;
 }
 
-real_t Curve::curvatureAtIdx(int idx, const CurvatureType curvatureType) const {
-    const auto &p_1 = vertices_[getPrevIdx(idx)];
-    const auto &p0 = vertices_[idx];
-    const auto &p1 = vertices_[getNextIdx(idx)];
-    return std::abs(CurveUtils::calcCurvature(p_1, p0, p1, curvatureType));
+real_t Curve::curvatureAtIdx(int idx, const CurvatureType curvatureType, const bool fastMath) const {
+    const auto &p_1 = vertexAt(getPrevIdx(idx));
+    const auto &p0 = vertexAt(idx);
+    const auto &p1 = vertexAt(getNextIdx(idx));
+    return abs(CurveUtils::calcCurvature(p_1, p0, p1, curvatureType, fastMath));
 }
 
 int Curve::addPoint(const Vector2DD &p) {
+    if (chunkedStorageEnabled_ && !chunked_) {
+        enterChunkedStorage();
+    }
     const int idx = findInsertIdx(p);
-    vertices_.insert(vertices_.begin() + idx, p);
-    customNormals_.insert(customNormals_.begin() + idx, false);
-    normals_.insert(normals_.begin() + idx, calcNormalAtIndex(vertices_, idx));
-    normals_[getNextIdx(idx)] = calcNormalAtIndex(vertices_, getNextIdx(idx));
-    normals_[getPrevIdx(idx)] = calcNormalAtIndex(vertices_, getPrevIdx(idx));
+    const bool updateIndex = isSpatialIndexUpToDate();
+    if (updateIndex) {
+        const int n = numPoints();
+        // The edge the point is inserted in is split in two. An empty curve has no edges yet.
+        if (n > 0 && (closed_ || idx > 0)) {
+            const int splitEdge = (idx - 1 + n) % n;
+            const Vector2DD &start = vertexAt(splitEdge);
+            const Vector2DD &end = vertexAt(idx % n);
+            edgeGrid_.remove(gridId(splitEdge), start.cwiseMin(end), start.cwiseMax(end));
+        }
+        // Chunked points keep their ids
+        if (!chunked_) {
+            vertexGrid_.shiftIds(idx, 1);
+            edgeGrid_.shiftIds(idx, 1);
+        }
+    }
+    if (chunked_) {
+        points_.insert(idx, {p, Vector2DD(), false});
+        arraysValid_ = false;
+    } else {
+        vertices_.insert(vertices_.begin() + idx, p);
+        customNormals_.insert(customNormals_.begin() + idx, false);
+        normals_.insert(normals_.begin() + idx, Vector2DD());
+    }
+    calcNormal(idx);
+    calcNormal(getNextIdx(idx));
+    calcNormal(getPrevIdx(idx));
+    includeNormalLength(normalAt(getPrevIdx(idx)));
+    includeNormalLength(normalAt(idx));
+    includeNormalLength(normalAt(getNextIdx(idx)));
+    if (updateIndex) {
+        updateSpatialIndex(idx, true);
+    }
     return idx;
 }
 
 void Curve::setVertexPosition(const int idx, const Vector2DD &p) {
-    vertices_[idx] = p;
-    if (!customNormals_[idx]) {
+    const bool updateIndex = isSpatialIndexUpToDate();
+    if (updateIndex) {
+        updateSpatialIndex(idx, false);
+    }
+    storeVertex(idx, p);
+    if (updateIndex) {
+        updateSpatialIndex(idx, true);
+    }
+    if (!customNormalAt(idx)) {
         recalculateNormal(idx);
     }
     const int nextIdx = getNextIdx(idx);
-    if (!customNormals_[nextIdx]) {
+    if (!customNormalAt(nextIdx)) {
         recalculateNormal(nextIdx);
     }
     const int prevIdx = getPrevIdx(idx);
-    if (!customNormals_[prevIdx]) {
+    if (!customNormalAt(prevIdx)) {
         recalculateNormal(prevIdx);
     }
 }
 
 void Curve::setCustomNormal(const int idx, const Vector2DD &normal) {
-    normals_[idx] = normal;
-    customNormals_[idx] = true;
+    storeNormal(idx, normal);
+    includeNormalLength(normal);
+    storeCustomNormal(idx, true);
 }
 
 void Curve::removePoint(int idx) {
-    if (idx < 0 || idx > numPoints()) {
+    if (idx < 0 || idx >= numPoints()) {
         return;
     }
-    vertices_.erase(vertices_.begin() + idx);
-    normals_.erase(normals_.begin() + idx);
-    customNormals_.erase(customNormals_.begin() + idx);
+    if (chunkedStorageEnabled_ && !chunked_) {
+        enterChunkedStorage();
+    }
+    const bool updateIndex = isSpatialIndexUpToDate();
+    if (updateIndex) {
+        updateSpatialIndex(idx, false);
+        if (!chunked_) {
+            vertexGrid_.shiftIds(idx + 1, -1);
+            edgeGrid_.shiftIds(idx + 1, -1);
+        }
+    }
+    if (chunked_) {
+        points_.erase(idx);
+        arraysValid_ = false;
+    } else {
+        vertices_.erase(vertices_.begin() + idx);
+        normals_.erase(normals_.begin() + idx);
+        customNormals_.erase(customNormals_.begin() + idx);
+    }
+    const int m = numPoints();
+    if (m == 0) {
+        return;
+    }
+    // The neighbours of the removed point are now connected by an edge
+    if (updateIndex && (closed_ || (idx > 0 && idx < m))) {
+        const int joinEdge = (idx - 1 + m) % m;
+        const Vector2DD &start = vertexAt(joinEdge);
+        const Vector2DD &end = vertexAt(idx % m);
+        edgeGrid_.insert(gridId(joinEdge), start.cwiseMin(end), start.cwiseMax(end));
+    }
     const int prevIdx = getPrevIdx(idx);
-    if (!customNormals_[prevIdx]) {
+    if (!customNormalAt(prevIdx)) {
         recalculateNormal(prevIdx);
     }
-    if (idx == customNormals_.size()) {
+    if (idx == m) {
         idx = 0;
     }
-    if (!customNormals_[idx]) {
+    if (!customNormalAt(idx)) {
         recalculateNormal(idx);
     }
 }
 
+void Curve::setSpatialIndexEnabled(const bool enabled) {
+    spatialIndexEnabled_ = enabled;
+    spatialIndexValid_ = false;
+    if (!enabled) {
+        // Release the memory
+        vertexGrid_ = {};
+        edgeGrid_ = {};
+    }
+}
+
+void Curve::buildSpatialIndex() const {
+    syncArrays();
+    const int n = numPoints();
+    // The ids of the points in chunked storage mode, in order
+    std::vector<int> ids;
+    if (chunked_) {
+        ids.reserve(n);
+        for (auto it = points_.begin(); it != points_.end(); ++it) {
+            ids.push_back(it.id());
+        }
+    }
+    const auto id = [&](const int k) { return chunked_ ? ids[k] : k; };
+    const int numEdges = closed_ ? n : std::max(n - 1, 0);
+    // Cells in the order of the average edge length, so that most edges cover only a few cells
+    real_t totalLength = 0;
+    for (int k = 0; k < numEdges; k++) {
+        totalLength += (vertices_[getNextIdx(k)] - vertices_[k]).norm();
+    }
+    double cellSize = numEdges > 0 ? static_cast<double>(totalLength / numEdges) : 1.0;
+    if (!std::isfinite(cellSize) || cellSize <= 0) {
+        cellSize = 1.0;
+    }
+    vertexGrid_.reset(cellSize);
+    edgeGrid_.reset(cellSize);
+    maxNormalLength_ = 0;
+    for (int k = 0; k < n; k++) {
+        vertexGrid_.insert(id(k), vertices_[k], vertices_[k]);
+        maxNormalLength_ = std::max(maxNormalLength_, normals_[k].norm());
+    }
+    for (int k = 0; k < numEdges; k++) {
+        const Vector2DD &start = vertices_[k];
+        const Vector2DD &end = vertices_[getNextIdx(k)];
+        edgeGrid_.insert(id(k), start.cwiseMin(end), start.cwiseMax(end));
+    }
+    spatialIndexValid_ = true;
+}
+
+// Inserts or removes a vertex and its adjacent edges
+void Curve::updateSpatialIndex(const int idx, const bool insert) const {
+    const auto update = [insert](SpatialGrid &grid, const int id, const Vector2DD &a, const Vector2DD &b) {
+        if (insert) {
+            grid.insert(id, a.cwiseMin(b), a.cwiseMax(b));
+        } else {
+            grid.remove(id, a.cwiseMin(b), a.cwiseMax(b));
+        }
+    };
+    const int n = numPoints();
+    const Vector2DD &vertex = vertexAt(idx);
+    update(vertexGrid_, gridId(idx), vertex, vertex);
+    const int incoming = closed_ || idx > 0 ? (idx - 1 + n) % n : -1;
+    const int outgoing = closed_ || idx < n - 1 ? idx : -1;
+    if (incoming >= 0) {
+        update(edgeGrid_, gridId(incoming), vertexAt(incoming), vertex);
+    }
+    if (outgoing >= 0 && outgoing != incoming) {
+        update(edgeGrid_, gridId(outgoing), vertex, vertexAt(getNextIdx(idx)));
+    }
+}
+
+void Curve::includeNormalLength(const Vector2DD &normal) const {
+    if (isSpatialIndexUpToDate()) {
+        maxNormalLength_ = std::max(maxNormalLength_, normal.norm());
+    }
+}
+
 int Curve::findClosestVertex(const Vector2DD &p, const double maxDist) const {
+    if (spatialIndexEnabled_) {
+        if (!spatialIndexValid_) {
+            buildSpatialIndex();
+        }
+        real_t minDist;
+        return gridIdToIdx(vertexGrid_.findNearest(
+                p, maxDist, 0, [&](const int id) { return (gridVertex(id) - p).norm(); }, gridOrder(), minDist));
+    }
+    syncArrays();
     int ptIndex = -1;
-    double minDist = std::numeric_limits<double>::infinity();
+    real_t minDist = std::numeric_limits<real_t>::infinity();
 
     for (int k = 0; k < vertices_.size(); k++) {
-        double currentDist = (vertices_[k] - p).norm();
+        real_t currentDist = (vertices_[k] - p).norm();
         if (currentDist < minDist) {
             minDist = currentDist;
             ptIndex = k;
@@ -137,11 +379,26 @@ int Curve::findClosestVertex(const Vector2DD &p, const double maxDist) const {
 
 // Returns index of the point normal handle
 int Curve::findClosestNormal(const Vector2DD &p, const double maxDist, const double normalLength) const {
+    if (spatialIndexEnabled_) {
+        if (!spatialIndexValid_) {
+            buildSpatialIndex();
+        }
+        real_t minDist;
+        // A normal handle can be up to the length of the normal closer to p than its vertex
+        return gridIdToIdx(vertexGrid_.findNearest(
+                p,
+                maxDist,
+                normalLength * maxNormalLength_,
+                [&](const int id) { return (gridVertex(id) + normalLength * gridNormal(id) - p).norm(); },
+                gridOrder(),
+                minDist));
+    }
+    syncArrays();
     int ptIndex = -1;
-    double minDist = std::numeric_limits<double>::infinity();
+    real_t minDist = std::numeric_limits<real_t>::infinity();
     for (int k = 0; k < vertices_.size(); k++) {
         Vector2DD normPos = vertices_[k] + normalLength * normals_[k];
-        double currentDist = (normPos - p).norm();
+        real_t currentDist = (normPos - p).norm();
         if (currentDist < minDist) {
             minDist = currentDist;
             ptIndex = k;
@@ -155,15 +412,26 @@ int Curve::findClosestNormal(const Vector2DD &p, const double maxDist, const dou
 }
 
 int Curve::findClosestEdge(const Vector2DD &p, const double maxDist) const {
+    if (spatialIndexEnabled_) {
+        if (!spatialIndexValid_) {
+            buildSpatialIndex();
+        }
+        real_t minDist;
+        const auto distance = [&](const int id) {
+            return (getClosestPointOnLineSegment(gridVertex(id), gridEdgeEnd(id), p) - p).norm();
+        };
+        return gridIdToIdx(edgeGrid_.findNearest(p, maxDist, 0, distance, gridOrder(), minDist));
+    }
+    syncArrays();
     int closestEdgeIndex = -1;
-    double minDist = std::numeric_limits<double>::infinity();
+    real_t minDist = std::numeric_limits<real_t>::infinity();
     const int n = vertices_.size();
     // Don't loop over the last edge if the curve is not closed
     for (int k = 0; k < n - !isClosed(); k++) {
         const Vector2DD &start = vertices_[k];
         const Vector2DD &end = vertices_[getNextIdx(k)];
         Vector2DD closestPoint = getClosestPointOnLineSegment(start, end, p);
-        const double currentDist = (closestPoint - p).norm();
+        const real_t currentDist = (closestPoint - p).norm();
         if (currentDist < minDist) {
             minDist = currentDist;
             closestEdgeIndex = k;
@@ -180,23 +448,46 @@ Vector2DD Curve::getClosestPointOnLineSegment(const Vector2DD &start,
                                               const Vector2DD &end,
                                               const Vector2DD &point) const {
     const Vector2DD lineDir = end - start;
-    const double lineLengthSquared = lineDir.dot(lineDir);
+    const real_t lineLengthSquared = lineDir.dot(lineDir);
     if (lineLengthSquared == 0)
         return start;
     // Project the point onto the line segment
-    double t = (point - start).dot(lineDir) / lineLengthSquared;
-    t = std::max(0.0, std::min(1.0, t)); // Clamp t to the segment [0, 1]
+    real_t t = (point - start).dot(lineDir) / lineLengthSquared;
+    t = std::max(static_cast<real_t>(0.0), std::min(static_cast<real_t>(1.0), t)); // Clamp t to the segment [0, 1]
     // Return the closest point on the line segment
     return start + t * lineDir;
 }
 
 int Curve::findInsertIdx(const Vector2DD &p) const {
-    if (vertices_.empty()) {
+    if (numPoints() == 0) {
         return 0;
     }
     int ptIndex = -1;
     real_t minDist = std::numeric_limits<real_t>::infinity();
+    if (spatialIndexEnabled_) {
+        if (!spatialIndexValid_) {
+            buildSpatialIndex();
+        }
+        // Inserting at k places the point on the edge ending at k
+        const auto distance = [&](const int id) {
+            return CurveUtils::distanceToEdge(gridEdgeEnd(id), gridVertex(id), p);
+        };
+        const int edge = edgeGrid_.findNearest(
+                p, std::numeric_limits<real_t>::infinity(), 0, distance, gridOrder(), minDist);
+        if (edge >= 0) {
+            ptIndex = getNextIdx(gridIdToIdx(edge));
+        }
+        // The start of an open curve has no incoming edge, so the distance to the first vertex is used instead
+        if (!closed_) {
+            const real_t firstDist = CurveUtils::distanceToEdge(vertexAt(0), vertexAt(0), p);
+            if (ptIndex < 0 || firstDist <= minDist) {
+                ptIndex = 0;
+            }
+        }
+        return ptIndex;
+    }
 
+    syncArrays();
     for (int k = 0; k < vertices_.size(); k++) {
         real_t currentDist = CurveUtils::distanceToEdge(vertices_[k], vertices_[getPrevIdx(k)], p);
         if (currentDist < minDist) {
@@ -208,7 +499,7 @@ int Curve::findInsertIdx(const Vector2DD &p) const {
 }
 
 int Curve::getNextIdx(const int idx) const {
-    const int n = static_cast<int>(vertices_.size());
+    const int n = numPoints();
     if (closed_) {
         return idx + 1 < n ? idx + 1 : 0;
     }
@@ -216,7 +507,7 @@ int Curve::getNextIdx(const int idx) const {
 }
 
 int Curve::getPrevIdx(const int idx) const {
-    const int n = static_cast<int>(vertices_.size());
+    const int n = numPoints();
     if (closed_) {
         return idx - 1 >= 0 ? idx - 1 : n - 1;
     }
@@ -224,17 +515,33 @@ int Curve::getPrevIdx(const int idx) const {
 }
 
 void Curve::recalculateNormals(const bool areaWeightedNormals, const bool circleNormals) {
+    useArrays();
     areaWeightedNormals_ = areaWeightedNormals;
     circleNormals_ = circleNormals;
-    normals_ = calcNormals(vertices_);
-    for (int i = 0; i < normals_.size(); i++) {
-        customNormals_[i] = false;
+    normals_.resize(vertices_.size());
+    calcNormals(0, numPoints());
+    invalidateSpatialIndex();
+    std::fill(customNormals_.begin(), customNormals_.end(), false);
+}
+
+void Curve::recalculateNormalRange(const int begin, const int end) {
+    if (begin < 0 || begin > end || end > numPoints()) {
+        throw std::out_of_range("Index out of bounds in recalculateNormalRange");
+    }
+    useArrays();
+    calcNormals(begin, end);
+    std::fill(customNormals_.begin() + begin, customNormals_.begin() + end, false);
+    if (isSpatialIndexUpToDate()) {
+        for (int i = begin; i < end; i++) {
+            includeNormalLength(normals_[i]);
+        }
     }
 }
 
 void Curve::recalculateNormal(const int idx) {
-    customNormals_[idx] = false;
-    normals_[idx] = calcNormalAtIndex(vertices_, idx);
+    storeCustomNormal(idx, false);
+    calcNormal(idx);
+    includeNormalLength(normalAt(idx));
 }
 
 bool Curve::isClosed() const {
@@ -243,32 +550,38 @@ bool Curve::isClosed() const {
 
 void Curve::setClosed(const bool closed, bool recalculate) {
     closed_ = closed;
-    if (vertices_.empty() || !recalculate) {
+    invalidateSpatialIndex();
+    const int n = numPoints();
+    if (n == 0 || !recalculate) {
         return;
     }
-    if (!customNormals_[0]) {
+    if (!customNormalAt(0)) {
         recalculateNormal(0);
     }
-    if (!customNormals_[customNormals_.size() - 1]) {
-        recalculateNormal(static_cast<int>(customNormals_.size()) - 1);
+    if (!customNormalAt(n - 1)) {
+        recalculateNormal(n - 1);
     }
 }
 
 void Curve::translate(const Vector2DD &translation) {
+    useArrays();
     for (auto &c: vertices_) {
         c += translation;
     }
+    invalidateSpatialIndex();
 }
 
 int Curve::numPoints() const {
-    return vertices_.size();
+    return chunked_ ? points_.size() : static_cast<int>(vertices_.size());
 }
 
 void Curve::copyDataTo(Curve &other) const {
+    syncArrays();
     auto &otherCoords = other.getVertices();
     auto &otherNormals = other.getNormals();
     auto &otherCustNormals = other.getCustomNormals();
     other.setClosed(isClosed(), false);
+    other.invalidateSpatialIndex();
     const int n = numPoints();
     // Prevent re-allocating the buffer, so copy it into existing buffer
     // Note that resize does not reduce capacity
@@ -281,10 +594,10 @@ void Curve::copyDataTo(Curve &other) const {
 }
 
 Vector2DD Curve::prevEdge(const int idx) const {
-    return vertices_[getPrevIdx(idx)] - vertices_[idx];
+    return vertexAt(getPrevIdx(idx)) - vertexAt(idx);
 }
 Vector2DD Curve::nextEdge(const int idx) const {
-    return vertices_[getNextIdx(idx)] - vertices_[idx];
+    return vertexAt(getNextIdx(idx)) - vertexAt(idx);
 }
 
 int Curve::edgePointingDir(const int idx) const {
@@ -1,12 +1,13 @@
 #include "conis/core/curve/curveloader.hpp"
 
 #include <fstream>
-#include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "conis/core/log.hpp"
+
 namespace conis::core {
 
 CurveLoader::CurveLoader() {}
@@ -16,7 +17,7 @@ Curve CurveLoader::loadCurveFromFile(const std::string &filePath) {
     std::setlocale(LC_NUMERIC, "C");
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << filePath << std::endl;
+        CONIS_LOG(LOG_ERROR, "Failed to open file: " << filePath);
         return {};
     }
 
@@ -53,7 +54,7 @@ Curve CurveLoader::loadCurveFromFile(const std::string &filePath) {
     bool closed = false;
 
     file.close();
-    std::cout << "Loaded curve with " << verts.size() << " vertices and " << normals.size() << " normals" << std::endl;
+    CONIS_LOG(LOG_DEBUG, "Loaded curve with " << verts.size() << " vertices and " << normals.size() << " normals");
 
     if (normals.empty()) {
         return Curve(verts, closed);
@@ -2,9 +2,10 @@
 
 #include <fstream>
 #include <iomanip>
-#include <iostream>
 #include <vector>
 
+#include "conis/core/log.hpp"
+
 namespace conis::core {
 
 CurveSaver::CurveSaver() = default;
@@ -14,7 +15,7 @@ bool CurveSaver::saveCurve(const std::string &fileName, const Curve &curve) cons
     constexpr int prec = 16; // Set precision for output
 
     if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << fileName << std::endl;
+        CONIS_LOG(LOG_ERROR, "Failed to open file: " << fileName);
         return false;
     }
 
@@ -42,7 +43,7 @@ bool CurveSaver::saveCurveWithNormals(const std::string &fileName, const Curve &
     constexpr int prec = 16; // Set precision for output
 
     if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << fileName << std::endl;
+        CONIS_LOG(LOG_ERROR, "Failed to open file: " << fileName);
         return false;
     }
 
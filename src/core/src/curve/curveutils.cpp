@@ -1,68 +1,227 @@
 #include "curveutils.hpp"
 
-#include <iostream>
+#include <algorithm>
 
+#include "conis/core/dual.hpp"
+#include "conis/core/log.hpp"
 #include "conis/core/vector.hpp"
+#include "util/cpudispatch.hpp"
+#include "util/fastmath.hpp"
 
 namespace conis::core {
 
-Vector2DD CurveUtils::calcNormal(const Vector2DD &a, const Vector2DD &b, const Vector2DD &c, bool areaWeighted) {
+// The normal of an end point of an open curve, which coincides with its previous or next vertex
+template<typename S>
+static inline Vector2<S> edgeNormal(const Vector2<S> &from, const Vector2<S> &to) {
+    Vector2<S> normal = to - from;
+    normal.x() *= -1;
+    return Vector2<S>(normal.y(), normal.x()).normalized();
+}
+
+template<bool AreaWeighted, typename S>
+static inline Vector2<S> normalOf(const Vector2<S> &a, const Vector2<S> &b, const Vector2<S> &c) {
     if (a == b) {
-        Vector2DD normal = c - b;
-        normal.x() *= -1;
-        return Vector2DD(normal.y(), normal.x()).normalized();
+        return edgeNormal(b, c);
     }
     if (b == c) {
-        Vector2DD normal = b - a;
-        normal.x() *= -1;
-        return Vector2DD(normal.y(), normal.x()).normalized();
+        return edgeNormal(a, b);
     }
-    Vector2DD t1 = (a - b);
+    Vector2<S> t1 = (a - b);
     t1 = {-t1.y(), t1.x()};
-    Vector2DD t2 = (b - c);
+    Vector2<S> t2 = (b - c);
     t2 = {-t2.y(), t2.x()};
-    if (!areaWeighted) {
+    if constexpr (!AreaWeighted) {
         t1.normalize();
         t2.normalize();
     }
-    Vector2DD normal = (t1 + t2).normalized();
+    Vector2<S> normal = (t1 + t2).normalized();
     // Ensure correct orientation; normal is always pointing outwards
-    const auto ab = a - b;
-    const auto cb = c - b;
-    const real_t cross = ab.x() * cb.y() - ab.y() * cb.x();
-    return cross > 0 ? -1 * normal : normal;
+    const Vector2<S> ab = a - b;
+    const Vector2<S> cb = c - b;
+    const S cross = ab.x() * cb.y() - ab.y() * cb.x();
+    return cross > 0 ? Vector2<S>(-normal) : normal;
 }
 
-Vector2DD CurveUtils::calcNormalOscCircles(const Vector2DD &a, const Vector2DD &b, const Vector2DD &c) {
+template<typename S>
+static inline Vector2<S> oscCircleNormalOf(const Vector2<S> &a, const Vector2<S> &b, const Vector2<S> &c) {
     if (a == b) {
-        Vector2DD normal = c - b;
-        normal.x() *= -1;
-        return Vector2DD(normal.y(), normal.x()).normalized();
+        return edgeNormal(b, c);
     }
     if (b == c) {
-        Vector2DD normal = b - a;
-        normal.x() *= -1;
-        return Vector2DD(normal.y(), normal.x()).normalized();
-    }
-    const real_t d = 2 * (a.x() * (b.y() - c.y()) + b.x() * (c.y() - a.y()) + c.x() * (a.y() - b.y()));
-    const real_t ux = ((a.x() * a.x() + a.y() * a.y()) * (b.y() - c.y()) +
-                       (b.x() * b.x() + b.y() * b.y()) * (c.y() - a.y()) +
-                       (c.x() * c.x() + c.y() * c.y()) * (a.y() - b.y())) /
-                      d;
-    const real_t uy = ((a.x() * a.x() + a.y() * a.y()) * (c.x() - b.x()) +
-                       (b.x() * b.x() + b.y() * b.y()) * (a.x() - c.x()) +
-                       (c.x() * c.x() + c.y() * c.y()) * (b.x() - a.x())) /
-                      d;
-    const Vector2DD oscCircleCenter = {ux, uy};
-    const Vector2DD norm = (oscCircleCenter - b).normalized();
-
-    const Vector2DD check = calcNormal(a, b, c, false);
+        return edgeNormal(a, b);
+    }
+    const S d = 2 * (a.x() * (b.y() - c.y()) + b.x() * (c.y() - a.y()) + c.x() * (a.y() - b.y()));
+    const S ux = ((a.x() * a.x() + a.y() * a.y()) * (b.y() - c.y()) +
+                  (b.x() * b.x() + b.y() * b.y()) * (c.y() - a.y()) +
+                  (c.x() * c.x() + c.y() * c.y()) * (a.y() - b.y())) /
+                 d;
+    const S uy = ((a.x() * a.x() + a.y() * a.y()) * (c.x() - b.x()) +
+                  (b.x() * b.x() + b.y() * b.y()) * (a.x() - c.x()) +
+                  (c.x() * c.x() + c.y() * c.y()) * (b.x() - a.x())) /
+                 d;
+    const Vector2<S> oscCircleCenter = {ux, uy};
+    const Vector2<S> norm = (oscCircleCenter - b).normalized();
+
+    const Vector2<S> check = normalOf<false>(a, b, c);
     if (check.dot(norm) < 0) {
-        return norm * -1;
+        return -norm;
     }
     return norm;
 }
 
+CONIS_DISPATCH_REAL Vector2DD CurveUtils::calcNormal(const Vector2DD &a,
+                                                     const Vector2DD &b,
+                                                     const Vector2DD &c,
+                                                     bool areaWeighted) {
+    return areaWeighted ? normalOf<true>(a, b, c) : normalOf<false>(a, b, c);
+}
+
+CONIS_DISPATCH_REAL Vector2DD CurveUtils::calcNormalOscCircles(const Vector2DD &a,
+                                                               const Vector2DD &b,
+                                                               const Vector2DD &c) {
+    return oscCircleNormalOf(a, b, c);
+}
+
+/*
+ * Calls at(prevIdx, idx, nextIdx) for the vertices [begin, end) of a curve with n vertices. Only the end points wrap
+ * around (or are clamped, for open curves), so that the interior loop only accesses consecutive vertices.
+ */
+template<typename Fn>
+static inline void stencilLoop(const int n, const bool closed, const int begin, const int end, const Fn &at) {
+    if (begin == 0 && end > 0) {
+        at(closed ? n - 1 : 0, 0, std::min(1, n - 1));
+    }
+    const int interiorEnd = std::min(end, n - 1);
+    for (int i = std::max(begin, 1); i < interiorEnd; i++) {
+        at(i - 1, i, i + 1);
+    }
+    if (end == n && n > 1) {
+        at(n - 2, n - 1, closed ? 0 : n - 1);
+    }
+}
+
+template<typename NormalFn>
+static void normalLoop(const std::vector<Vector2DD> &verts,
+                       const bool closed,
+                       const int begin,
+                       const int end,
+                       const NormalFn &normalAt,
+                       Vector2DD *normals) {
+    const auto normalAtIdx = [&](const int prevIdx, const int idx, const int nextIdx) {
+        normals[idx] = normalAt(verts[prevIdx], verts[idx], verts[nextIdx]);
+    };
+    stencilLoop(static_cast<int>(verts.size()), closed, begin, end, normalAtIdx);
+}
+
+/*
+ * Branch-free version of normalOf for the structure-of-arrays loops, so that these can be vectorised. It works on the
+ * coordinates rather than on Vector2, since Eigen would pack the double vectors into SIMD registers of its own. The
+ * perpendicular of a degenerate edge is zero, which leaves the normal of the other edge: the same result as edgeNormal.
+ */
+template<bool AreaWeighted, typename S>
+static inline void branchFreeNormalOf(const S ax,
+                                      const S ay,
+                                      const S bx,
+                                      const S by,
+                                      const S cx,
+                                      const S cy,
+                                      S &normalX,
+                                      S &normalY) {
+    // Like Eigen's normalized(), zero vectors are left as they are
+    const auto normalize = [](S &x, S &y) {
+        const S norm = std::sqrt(x * x + y * y);
+        const S divisor = norm > 0 ? norm : S(1);
+        x /= divisor;
+        y /= divisor;
+    };
+    const S abx = ax - bx;
+    const S aby = ay - by;
+    const S cbx = cx - bx;
+    const S cby = cy - by;
+    // The perpendiculars of a - b and b - c, as in normalOf
+    S t1x = -aby;
+    S t1y = abx;
+    S t2x = cby;
+    S t2y = -cbx;
+    if constexpr (!AreaWeighted) {
+        normalize(t1x, t1y);
+        normalize(t2x, t2y);
+    }
+    normalX = t1x + t2x;
+    normalY = t1y + t2y;
+    normalize(normalX, normalY);
+    // Ensure correct orientation; normal is always pointing outwards
+    const S cross = abx * cby - aby * cbx;
+    const S sign = cross > 0 ? S(-1) : S(1);
+    normalX *= sign;
+    normalY *= sign;
+}
+
+// Structure-of-arrays version of normalLoop. The interior loop only loads consecutive elements of each array.
+template<typename S, typename NormalFn>
+static void normalLoop(const S *x,
+                       const S *y,
+                       const int n,
+                       const bool closed,
+                       const int begin,
+                       const int end,
+                       const NormalFn &normalAt,
+                       S *normalX,
+                       S *normalY) {
+    const auto normalAtIdx = [&](const int prevIdx, const int idx, const int nextIdx) {
+        normalAt(x[prevIdx], y[prevIdx], x[idx], y[idx], x[nextIdx], y[nextIdx], normalX[idx], normalY[idx]);
+    };
+    stencilLoop(n, closed, begin, end, normalAtIdx);
+}
+
+// The osculating circle normals keep their branches, so only the other normals are vectorised
+template<typename S>
+static void calcNormalsSoA(const S *x,
+                           const S *y,
+                           const int n,
+                           const bool closed,
+                           const int begin,
+                           const int end,
+                           const bool areaWeighted,
+                           const bool circleNormals,
+                           S *normalX,
+                           S *normalY) {
+    if (circleNormals) {
+        normalLoop(x, y, n, closed, begin, end, [](S ax, S ay, S bx, S by, S cx, S cy, S &normalX, S &normalY) {
+            const Vector2<S> normal = oscCircleNormalOf<S>({ax, ay}, {bx, by}, {cx, cy});
+            normalX = normal.x();
+            normalY = normal.y();
+        }, normalX, normalY);
+    } else if (areaWeighted) {
+        normalLoop(x, y, n, closed, begin, end, branchFreeNormalOf<true, S>, normalX, normalY);
+    } else {
+        normalLoop(x, y, n, closed, begin, end, branchFreeNormalOf<false, S>, normalX, normalY);
+    }
+}
+
+CONIS_DISPATCH_REAL void CurveUtils::calcNormals(const std::vector<Vector2DD> &verts,
+                                                 const bool closed,
+                                                 const int begin,
+                                                 const int end,
+                                                 const bool areaWeighted,
+                                                 const bool circleNormals,
+                                                 Vector2DD *normals) {
+    // Lambdas rather than function pointers, so that each loop gets its own inlined instantiation
+    if (circleNormals) {
+        normalLoop(verts, closed, begin, end, [](const auto &a, const auto &b, const auto &c) {
+            return oscCircleNormalOf(a, b, c);
+        }, normals);
+    } else if (areaWeighted) {
+        normalLoop(verts, closed, begin, end, [](const auto &a, const auto &b, const auto &c) {
+            return normalOf<true>(a, b, c);
+        }, normals);
+    } else {
+        normalLoop(verts, closed, begin, end, [](const auto &a, const auto &b, const auto &c) {
+            return normalOf<false>(a, b, c);
+        }, normals);
+    }
+}
+
 real_t CurveUtils::distanceToEdge(const Vector2DD &a, const Vector2DD &b, const Vector2DD &p) {
     const Vector2DD ab = b - a;
     const Vector2DD ap = p - a;
@@ -70,48 +229,285 @@ real_t CurveUtils::distanceToEdge(const Vector2DD &a, const Vector2DD &b, const
     real_t t = ap.dot(ab) / ab_len2;
     t = std::max(static_cast<real_t>(0.0), std::min(static_cast<real_t>(1.0), t)); // clamp to [0, 1]
     Vector2DD q = a + t * ab;
-    return std::hypot(p.x() - q.x(), p.y() - q.y());
+    return hypot(p.x() - q.x(), p.y() - q.y());
+}
+
+// The fast math approximations are evaluated in double, so Dual always uses the exact functions
+template<typename S>
+static S curvatureAtan(const S &x, const bool fastMath) {
+    if constexpr (std::is_same_v<S, Dual>) {
+        return atan(x);
+    } else {
+        return fastMath ? fastmath::atan(x) : atan(x);
+    }
 }
 
-real_t CurveUtils::calcCurvature(const Vector2DD &a,
-                                 const Vector2DD &b,
-                                 const Vector2DD &c,
-                                 const CurvatureType curvatureType) {
-    if (curvatureType == CIRCLE_RADIUS) {
-        const Vector2DD ab = a - b;
-        const Vector2DD cb = c - b;
-        const Vector2DD ac = a - c;
+template<typename S>
+static S curvatureSin(const S &x, const bool fastMath) {
+    if constexpr (std::is_same_v<S, Dual>) {
+        return sin(x);
+    } else {
+        return fastMath ? fastmath::sin(x) : sin(x);
+    }
+}
+
+template<typename S>
+static S curvatureTan(const S &x, const bool fastMath) {
+    if constexpr (std::is_same_v<S, Dual>) {
+        return tan(x);
+    } else {
+        return fastMath ? fastmath::tan(x) : tan(x);
+    }
+}
+
+// The curvature of a single type, so that loops over many vertices can select the type once
+template<CurvatureType Type, typename S>
+static S curvatureOfType(const Vector2<S> &a, const Vector2<S> &b, const Vector2<S> &c, const bool fastMath) {
+    if constexpr (Type == CIRCLE_RADIUS) {
+        const Vector2<S> ab = a - b;
+        const Vector2<S> cb = c - b;
+        const Vector2<S> ac = a - c;
 
-        const real_t denom = ab.dot(ab) * cb.dot(cb) * ac.dot(ac);
+        const S denom = ab.dot(ab) * cb.dot(cb) * ac.dot(ac);
 
         // Avoid division by zero
         if (denom == 0.0)
-            return 0.0;
-        const real_t cross = ab.x() * cb.y() - ab.y() * cb.x();
+            return S(0.0);
+        const S cross = ab.x() * cb.y() - ab.y() * cb.x();
         return sqrt((cross * cross) / denom);
+    } else {
+        const Vector2<S> e1 = b - a;
+        const Vector2<S> e_1 = c - a;
+        const S cross = e_1.x() * e1.y() - e_1.y() * e1.x();
+        const S dot = e_1.x() * e1.x() + e_1.y() * e1.y();
+        const S v = curvatureAtan<S>(cross / dot, fastMath);
+
+        const S denom = e_1.norm() + e1.norm();
+        if (denom == 0.0)
+            return S(0.0);
+
+        if constexpr (Type == DISCRETE_WINDING) {
+            return 2.0 * v / denom;
+        } else if constexpr (Type == GRADIENT_ARC_LENGTH) {
+            return 4.0 * curvatureSin<S>(v / 2.0, fastMath) / denom;
+        } else {
+            static_assert(Type == AREA_INFLATION, "Unsupported curvature type");
+            return 4.0 * curvatureTan<S>(v / 2.0, fastMath) / denom;
+        }
+    }
+}
+
+template<typename S>
+S CurveUtils::calcCurvature(const Vector2<S> &a,
+                            const Vector2<S> &b,
+                            const Vector2<S> &c,
+                            const CurvatureType curvatureType,
+                            const bool fastMath) {
+    switch (curvatureType) {
+        case CIRCLE_RADIUS:
+            return curvatureOfType<CIRCLE_RADIUS>(a, b, c, fastMath);
+        case DISCRETE_WINDING:
+            return curvatureOfType<DISCRETE_WINDING>(a, b, c, fastMath);
+        case GRADIENT_ARC_LENGTH:
+            return curvatureOfType<GRADIENT_ARC_LENGTH>(a, b, c, fastMath);
+        case AREA_INFLATION:
+            return curvatureOfType<AREA_INFLATION>(a, b, c, fastMath);
+    }
+    CONIS_LOG(LOG_ERROR, "Unsupported curvature type: " << curvatureType);
+    return S(0); // Unsupported curvature type
+}
+
+template<CurvatureType Type>
+static void curvatureLoop(const std::vector<Vector2DD> &verts,
+                          const bool closed,
+                          const int begin,
+                          const int end,
+                          const bool fastMath,
+                          real_t *curvatures) {
+    const auto curvatureAtIdx = [&](const int prevIdx, const int idx, const int nextIdx) {
+        curvatures[idx] = abs(curvatureOfType<Type, real_t>(verts[prevIdx], verts[idx], verts[nextIdx], fastMath));
+    };
+    stencilLoop(static_cast<int>(verts.size()), closed, begin, end, curvatureAtIdx);
+}
+
+/*
+ * Branch-free version of curvatureOfType for the structure-of-arrays loops, on the coordinates like branchFreeNormalOf.
+ * The zero curvature of a degenerate segment is selected rather than returned early. With fastMath set at compile time,
+ * the trigonometric functions are polynomials as well, so that the loops can be vectorised.
+ */
+template<CurvatureType Type, bool FastMath, typename S>
+static inline S branchFreeCurvatureOf(const S ax, const S ay, const S bx, const S by, const S cx, const S cy) {
+    S curvature;
+    S denom;
+    if constexpr (Type == CIRCLE_RADIUS) {
+        const S abx = ax - bx;
+        const S aby = ay - by;
+        const S cbx = cx - bx;
+        const S cby = cy - by;
+        const S acx = ax - cx;
+        const S acy = ay - cy;
+        denom = (abx * abx + aby * aby) * (cbx * cbx + cby * cby) * (acx * acx + acy * acy);
+        const S cross = abx * cby - aby * cbx;
+        curvature = std::sqrt((cross * cross) / denom);
+    } else {
+        const S e1x = bx - ax;
+        const S e1y = by - ay;
+        const S e_1x = cx - ax;
+        const S e_1y = cy - ay;
+        const S cross = e_1x * e1y - e_1y * e1x;
+        const S dot = e_1x * e1x + e_1y * e1y;
+        const S v = curvatureAtan<S>(cross / dot, FastMath);
+        denom = std::sqrt(e_1x * e_1x + e_1y * e_1y) + std::sqrt(e1x * e1x + e1y * e1y);
+        if constexpr (Type == DISCRETE_WINDING) {
+            curvature = S(2) * v / denom;
+        } else if constexpr (Type == GRADIENT_ARC_LENGTH) {
+            curvature = S(4) * curvatureSin<S>(v / S(2), FastMath) / denom;
+        } else {
+            static_assert(Type == AREA_INFLATION, "Unsupported curvature type");
+            curvature = S(4) * curvatureTan<S>(v / S(2), FastMath) / denom;
+        }
     }
+    return denom == 0 ? S(0) : curvature;
+}
 
-    const auto e1 = b - a;
-    const auto e_1 = c - a;
-    const real_t cross = e_1.x() * e1.y() - e_1.y() * e1.x();
-    const real_t dot = e_1.x() * e1.x() + e_1.y() * e1.y();
-    const real_t v = atan(cross / dot);
+// Structure-of-arrays version of curvatureLoop, see the structure-of-arrays normalLoop
+template<CurvatureType Type, bool FastMath, typename S>
+static void curvatureLoop(const S *x,
+                          const S *y,
+                          const int n,
+                          const bool closed,
+                          const int begin,
+                          const int end,
+                          S *curvatures) {
+    const auto curvatureAtIdx = [&](const int prevIdx, const int idx, const int nextIdx) {
+        curvatures[idx] = std::abs(branchFreeCurvatureOf<Type, FastMath>(x[prevIdx],
+                                                                         y[prevIdx],
+                                                                         x[idx],
+                                                                         y[idx],
+                                                                         x[nextIdx],
+                                                                         y[nextIdx]));
+    };
+    stencilLoop(n, closed, begin, end, curvatureAtIdx);
+}
 
-    const real_t denom = e_1.norm() + e1.norm();
-    if (denom == 0.0)
-        return 0.0;
+template<bool FastMath, typename S>
+static void calcCurvaturesSoA(const S *x,
+                              const S *y,
+                              const int n,
+                              const bool closed,
+                              const int begin,
+                              const int end,
+                              const CurvatureType curvatureType,
+                              S *curvatures) {
+    switch (curvatureType) {
+        case CIRCLE_RADIUS:
+            curvatureLoop<CIRCLE_RADIUS, FastMath>(x, y, n, closed, begin, end, curvatures);
+            return;
+        case DISCRETE_WINDING:
+            curvatureLoop<DISCRETE_WINDING, FastMath>(x, y, n, closed, begin, end, curvatures);
+            return;
+        case GRADIENT_ARC_LENGTH:
+            curvatureLoop<GRADIENT_ARC_LENGTH, FastMath>(x, y, n, closed, begin, end, curvatures);
+            return;
+        case AREA_INFLATION:
+            curvatureLoop<AREA_INFLATION, FastMath>(x, y, n, closed, begin, end, curvatures);
+            return;
+    }
+    CONIS_LOG(LOG_ERROR, "Unsupported curvature type: " << curvatureType);
+}
 
-    if (curvatureType == DISCRETE_WINDING) {
-        return 2.0 * v / denom;
+CONIS_DISPATCH_REAL void CurveUtils::calcCurvatures(const std::vector<Vector2DD> &verts,
+                                                    const bool closed,
+                                                    const int begin,
+                                                    const int end,
+                                                    const CurvatureType curvatureType,
+                                                    const bool fastMath,
+                                                    real_t *curvatures) {
+    switch (curvatureType) {
+        case CIRCLE_RADIUS:
+            curvatureLoop<CIRCLE_RADIUS>(verts, closed, begin, end, fastMath, curvatures);
+            return;
+        case DISCRETE_WINDING:
+            curvatureLoop<DISCRETE_WINDING>(verts, closed, begin, end, fastMath, curvatures);
+            return;
+        case GRADIENT_ARC_LENGTH:
+            curvatureLoop<GRADIENT_ARC_LENGTH>(verts, closed, begin, end, fastMath, curvatures);
+            return;
+        case AREA_INFLATION:
+            curvatureLoop<AREA_INFLATION>(verts, closed, begin, end, fastMath, curvatures);
+            return;
     }
-    if (curvatureType == GRADIENT_ARC_LENGTH) {
-        return 4.0 * sin(v / 2.0) / denom;
+    CONIS_LOG(LOG_ERROR, "Unsupported curvature type: " << curvatureType);
+}
+
+// The structure-of-arrays kernels are only used for double and float, so these are always dispatched
+CONIS_DISPATCH_FLATTEN void CurveUtils::calcNormals(const double *x,
+                                            const double *y,
+                                            const int n,
+                                            const bool closed,
+                                            const int begin,
+                                            const int end,
+                                            const bool areaWeighted,
+                                            const bool circleNormals,
+                                            double *normalX,
+                                            double *normalY) {
+    calcNormalsSoA(x, y, n, closed, begin, end, areaWeighted, circleNormals, normalX, normalY);
+}
+
+CONIS_DISPATCH_FLATTEN void CurveUtils::calcNormals(const float *x,
+                                            const float *y,
+                                            const int n,
+                                            const bool closed,
+                                            const int begin,
+                                            const int end,
+                                            const bool areaWeighted,
+                                            const bool circleNormals,
+                                            float *normalX,
+                                            float *normalY) {
+    calcNormalsSoA(x, y, n, closed, begin, end, areaWeighted, circleNormals, normalX, normalY);
+}
+
+CONIS_DISPATCH_FLATTEN void CurveUtils::calcCurvatures(const double *x,
+                                               const double *y,
+                                               const int n,
+                                               const bool closed,
+                                               const int begin,
+                                               const int end,
+                                               const CurvatureType curvatureType,
+                                               const bool fastMath,
+                                               double *curvatures) {
+    if (fastMath) {
+        calcCurvaturesSoA<true>(x, y, n, closed, begin, end, curvatureType, curvatures);
+    } else {
+        calcCurvaturesSoA<false>(x, y, n, closed, begin, end, curvatureType, curvatures);
     }
-    if (curvatureType == AREA_INFLATION) {
-        return 4.0 * tan(v / 2.0) / denom;
+}
+
+CONIS_DISPATCH_FLATTEN void CurveUtils::calcCurvatures(const float *x,
+                                               const float *y,
+                                               const int n,
+                                               const bool closed,
+                                               const int begin,
+                                               const int end,
+                                               const CurvatureType curvatureType,
+                                               const bool fastMath,
+                                               float *curvatures) {
+    if (fastMath) {
+        calcCurvaturesSoA<true>(x, y, n, closed, begin, end, curvatureType, curvatures);
+    } else {
+        calcCurvaturesSoA<false>(x, y, n, closed, begin, end, curvatureType, curvatures);
     }
-    std::cerr << "Unsupported curvature type: " << curvatureType;
-    return 0; // Unsupported curvature type
 }
 
+template real_t CurveUtils::calcCurvature(const Vector2DD &a,
+                                          const Vector2DD &b,
+                                          const Vector2DD &c,
+                                          CurvatureType curvatureType,
+                                          bool fastMath);
+template Dual CurveUtils::calcCurvature(const Vector2<Dual> &a,
+                                        const Vector2<Dual> &b,
+                                        const Vector2<Dual> &c,
+                                        CurvatureType curvatureType,
+                                        bool fastMath);
+
 } // namespace conis::core
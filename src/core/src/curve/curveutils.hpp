@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+
 #include "conis/core/curve/curvaturetype.hpp"
 #include "conis/core/vector.hpp"
 
@@ -8,12 +10,75 @@ class CurveUtils {
 public:
     static Vector2DD calcNormal(const Vector2DD &a, const Vector2DD &b, const Vector2DD &c, bool areaWeighted = true);
     static Vector2DD calcNormalOscCircles(const Vector2DD &a, const Vector2DD &b, const Vector2DD &c);
+    // Calculates the normals of the vertices [begin, end) of a curve into normals[begin, end) in the way of calcNormal
+    // (or calcNormalOscCircles if circleNormals is set). The variant is only selected once for the entire range and
+    // only the end points of the curve need to wrap around. Curve uses this for single vertices as well.
+    static void calcNormals(const std::vector<Vector2DD> &verts,
+                            bool closed,
+                            int begin,
+                            int end,
+                            bool areaWeighted,
+                            bool circleNormals,
+                            Vector2DD *normals);
+    // Structure-of-arrays version of calcNormals for the n vertices (x[i], y[i]), used by CompactCurve
+    static void calcNormals(const double *x,
+                            const double *y,
+                            int n,
+                            bool closed,
+                            int begin,
+                            int end,
+                            bool areaWeighted,
+                            bool circleNormals,
+                            double *normalX,
+                            double *normalY);
+    static void calcNormals(const float *x,
+                            const float *y,
+                            int n,
+                            bool closed,
+                            int begin,
+                            int end,
+                            bool areaWeighted,
+                            bool circleNormals,
+                            float *normalX,
+                            float *normalY);
     static real_t distanceToEdge(const Vector2DD &a, const Vector2DD &b, const Vector2DD &p);
     // Calculates the curvature at point b for the segment a-b-c
-    static real_t calcCurvature(const Vector2DD &a,
-                                const Vector2DD &b,
-                                const Vector2DD &c,
-                                CurvatureType curvatureType);
+    // If fastMath is set, the trigonometric functions are approximated (see util/fastmath.hpp).
+    // Instantiated for real_t and Dual. The latter ignores fastMath.
+    template<typename S>
+    static S calcCurvature(const Vector2<S> &a,
+                           const Vector2<S> &b,
+                           const Vector2<S> &c,
+                           CurvatureType curvatureType,
+                           bool fastMath = false);
+    // Calculates the absolute curvature of the vertices [begin, end) of a curve into curvatures[begin, end), like
+    // Curve::curvatureAtIdx. The curvature type is only selected once for the entire range.
+    static void calcCurvatures(const std::vector<Vector2DD> &verts,
+                               bool closed,
+                               int begin,
+                               int end,
+                               CurvatureType curvatureType,
+                               bool fastMath,
+                               real_t *curvatures);
+    // Structure-of-arrays version of calcCurvatures for the n vertices (x[i], y[i]), used by CompactCurve
+    static void calcCurvatures(const double *x,
+                               const double *y,
+                               int n,
+                               bool closed,
+                               int begin,
+                               int end,
+                               CurvatureType curvatureType,
+                               bool fastMath,
+                               double *curvatures);
+    static void calcCurvatures(const float *x,
+                               const float *y,
+                               int n,
+                               bool closed,
+                               int begin,
+                               int end,
+                               CurvatureType curvatureType,
+                               bool fastMath,
+                               float *curvatures);
 };
 
 } // namespace conis::core
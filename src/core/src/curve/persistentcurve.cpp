@@ -0,0 +1,193 @@
+#include "conis/core/curve/persistentcurve.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+
+namespace conis::core {
+
+// Whether the chunk equals the points [begin, begin + chunk.size()) of the curve
+static bool chunkMatches(const PersistentCurve::Chunk &chunk, const Curve &curve, const int begin) {
+    const auto &verts = curve.getVertices();
+    const auto &normals = curve.getNormals();
+    const auto &customNormals = curve.getCustomNormals();
+    for (int i = 0; i < static_cast<int>(chunk.size()); i++) {
+        const PersistentCurve::ControlPoint &point = chunk[i];
+        if (point.vertex != verts[begin + i] || point.normal != normals[begin + i] ||
+            point.customNormal != static_cast<bool>(customNormals[begin + i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PersistentCurve::PersistentCurve(const Curve &curve) : numPoints_(curve.numPoints()), closed_(curve.isClosed()) {
+    appendChunks(curve, 0, numPoints_);
+}
+
+/*
+ * Reuses the chunks of the previous version that were not edited. The points in between are stored in new chunks, which
+ * also splits the chunks that grew beyond chunkSize and drops the ones that became empty.
+ */
+PersistentCurve::PersistentCurve(const Curve &curve, const PersistentCurve &previous, const Edits &edits)
+    : numPoints_(curve.numPoints()),
+      closed_(curve.isClosed()) {
+    if (edits.replaced_ || edits.chunkSizes_.size() != previous.chunks_.size() || edits.numPoints_ != numPoints_) {
+        appendChunks(curve, 0, numPoints_);
+        return;
+    }
+    chunks_.reserve(previous.chunks_.size() + 1);
+    // The first point that is not stored yet
+    int begin = 0;
+    // The end of the current chunk in the curve
+    int end = 0;
+    for (size_t c = 0; c < previous.chunks_.size(); c++) {
+        const int start = end;
+        end += edits.chunkSizes_[c];
+        // Repeated small edits would otherwise fragment the curve into ever smaller chunks, so a small number of new
+        // points is stored together with the chunk after it
+        if (edits.dirty_[c] || (start > begin && start - begin < chunkSize / 4)) {
+            continue;
+        }
+        appendChunks(curve, begin, start);
+        chunks_.push_back(previous.chunks_[c]);
+        begin = end;
+    }
+    appendChunks(curve, begin, numPoints_);
+}
+
+PersistentCurve::Edits::Edits(const PersistentCurve &base)
+    : chunkSizes_(base.chunks_.size()),
+      dirty_(base.chunks_.size(), 0),
+      numPoints_(base.numPoints_),
+      replaced_(false) {
+    for (size_t c = 0; c < base.chunks_.size(); c++) {
+        chunkSizes_[c] = static_cast<int>(base.chunks_[c]->size());
+    }
+    chunkSizeTree_.assign(static_cast<int>(chunkSizes_.size()), [this](const int c) { return chunkSizes_[c]; });
+}
+
+int PersistentCurve::Edits::findChunk(const int idx) const {
+    if (idx < 0 || idx >= numPoints_) {
+        return -1;
+    }
+    int offset;
+    return chunkSizeTree_.find(idx, offset);
+}
+
+void PersistentCurve::Edits::pointsChanged(const int begin, const int end) {
+    if (begin >= end) {
+        return;
+    }
+    edited_ = true;
+    int c = findChunk(std::max(begin, 0));
+    if (c < 0) {
+        return;
+    }
+    for (int chunkBegin = chunkSizeTree_.prefixSum(c); c < static_cast<int>(chunkSizes_.size()) && chunkBegin < end;
+         c++) {
+        dirty_[c] = 1;
+        chunkBegin += chunkSizes_[c];
+    }
+}
+
+void PersistentCurve::Edits::pointInserted(const int idx) {
+    edited_ = true;
+    // The point becomes part of the chunk of the point before it
+    int c = findChunk(std::max(idx - 1, 0));
+    if (c < 0 && !chunkSizes_.empty()) {
+        c = static_cast<int>(chunkSizes_.size()) - 1;
+    }
+    if (c < 0) {
+        replaced_ = true;
+        return;
+    }
+    chunkSizes_[c]++;
+    chunkSizeTree_.add(c, 1);
+    dirty_[c] = 1;
+    numPoints_++;
+}
+
+void PersistentCurve::Edits::pointRemoved(const int idx) {
+    edited_ = true;
+    const int c = findChunk(idx);
+    if (c < 0) {
+        replaced_ = true;
+        return;
+    }
+    chunkSizes_[c]--;
+    chunkSizeTree_.add(c, -1);
+    dirty_[c] = 1;
+    numPoints_--;
+}
+
+void PersistentCurve::Edits::curveReplaced() {
+    edited_ = true;
+    replaced_ = true;
+}
+
+void PersistentCurve::appendChunks(const Curve &curve, const int begin, const int end) {
+    const int numNew = (end - begin + chunkSize - 1) / chunkSize;
+    for (int c = 0; c < numNew; c++) {
+        // Spread the points evenly over the new chunks
+        const int chunkBegin = begin + static_cast<int>(static_cast<int64_t>(end - begin) * c / numNew);
+        const int chunkEnd = begin + static_cast<int>(static_cast<int64_t>(end - begin) * (c + 1) / numNew);
+        auto chunk = std::make_shared<Chunk>();
+        chunk->reserve(chunkEnd - chunkBegin);
+        for (int i = chunkBegin; i < chunkEnd; i++) {
+            chunk->push_back({curve.getVertex(i), curve.getNormal(i), curve.isCustomNormal(i)});
+        }
+        chunks_.push_back(std::move(chunk));
+    }
+}
+
+Curve PersistentCurve::toCurve() const {
+    Curve curve;
+    copyDataTo(curve);
+    return curve;
+}
+
+void PersistentCurve::copyDataTo(Curve &curve) const {
+    auto &verts = curve.getVertices();
+    auto &normals = curve.getNormals();
+    auto &customNormals = curve.getCustomNormals();
+    curve.setClosed(closed_, false);
+    verts.resize(numPoints_);
+    normals.resize(numPoints_);
+    customNormals.resize(numPoints_);
+    int i = 0;
+    for (const auto &chunk: chunks_) {
+        for (const ControlPoint &point: *chunk) {
+            verts[i] = point.vertex;
+            normals[i] = point.normal;
+            customNormals[i] = point.customNormal;
+            i++;
+        }
+    }
+}
+
+bool PersistentCurve::matches(const Curve &curve) const {
+    if (curve.numPoints() != numPoints_ || curve.isClosed() != closed_) {
+        return false;
+    }
+    int begin = 0;
+    for (const auto &chunk: chunks_) {
+        if (!chunkMatches(*chunk, curve, begin)) {
+            return false;
+        }
+        begin += static_cast<int>(chunk->size());
+    }
+    return true;
+}
+
+int PersistentCurve::numSharedChunks(const PersistentCurve &other) const {
+    std::unordered_set<const Chunk *> otherChunks;
+    for (const auto &chunk: other.chunks_) {
+        otherChunks.insert(chunk.get());
+    }
+    return static_cast<int>(std::count_if(chunks_.begin(), chunks_.end(), [&](const auto &chunk) {
+        return otherChunks.count(chunk.get()) > 0;
+    }));
+}
+
+} // namespace conis::core
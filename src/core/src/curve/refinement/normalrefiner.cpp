@@ -1,16 +1,35 @@
 #include "conis/core/curve/refinement/normalrefiner.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <omp.h>
+
+#include "conis/core/log.hpp"
+#include "util/fastmath.hpp"
 
 namespace conis::core {
 
 NormalRefiner::NormalRefiner(const NormalRefinementSettings &normRefSettings, const SubdivisionSettings &subdivSettings)
     : normRefSettings_(normRefSettings),
+      subdivSettings_(subdivSettings),
       subdivider_(subdivSettings) {}
 
-real_t NormalRefiner::smoothnessPenalty(const Curve &curve, const int idx, const CurvatureType curvatureType) const {
-    const real_t curvature_1 = curve.curvatureAtIdx(curve.getPrevIdx(idx), curvatureType);
-    const real_t curvature1 = curve.curvatureAtIdx(curve.getNextIdx(idx), curvatureType);
+/*
+ * The ratio between the curvatures at the neighbours of idx. Uses the given analytic curvatures if there are any and
+ * estimates the curvature of the given type otherwise.
+ */
+real_t NormalRefiner::smoothnessPenalty(const Curve &curve,
+                                        const int idx,
+                                        const CurvatureType curvatureType,
+                                        const std::vector<real_t> *curvatures) const {
+    const bool fastMath = subdivSettings_.fastMath;
+    const int prevIdx = curve.getPrevIdx(idx);
+    const int nextIdx = curve.getNextIdx(idx);
+    const real_t curvature_1 = curvatures != nullptr ? (*curvatures)[prevIdx]
+                                                     : curve.curvatureAtIdx(prevIdx, curvatureType, fastMath);
+    const real_t curvature1 = curvatures != nullptr ? (*curvatures)[nextIdx]
+                                                    : curve.curvatureAtIdx(nextIdx, curvatureType, fastMath);
     if (curvature1 > curvature_1) {
         return curvature1 / curvature_1;
     }
@@ -18,10 +37,107 @@ real_t NormalRefiner::smoothnessPenalty(const Curve &curve, const int idx, const
     // return std::abs(curvature_1 - curvature1);
 }
 
-void NormalRefiner::binarySearchBestNormal(Curve &curve,
-                                           const int idx,
-                                           const bool inflectionPoint,
-                                           const CurvatureType curvatureType) {
+bool NormalRefiner::useAnalyticCurvature() const {
+    // The neighbours of the tested vertex are only sampled from a conic if the curve is subdivided at least once
+    return normRefSettings_.analyticCurvature && normRefSettings_.testSubdivLevel > 0;
+}
+
+int NormalRefiner::windowRadius() const {
+    // An edge point depends on the two vertices of its edge and at most maxPatchSize - 1 vertices on either side of it.
+    // The dynamic patch size grows the patch up to a size of 4 (see ConicSubdivider::edgePoint).
+    const int maxPatchSize = subdivSettings_.dynamicPatchSize ? std::max(subdivSettings_.patchSize, 4)
+                                                              : subdivSettings_.patchSize;
+    // The smoothness penalty uses the curvature at both neighbours of the tested vertex. The discrete curvature in turn
+    // depends on their neighbours, the analytic curvature only on the conic the neighbour was sampled from.
+    int radius = useAnalyticCurvature() ? 1 : 2;
+    for (int i = 0; i < normRefSettings_.testSubdivLevel; i++) {
+        // Vertex i in the subdivided curve lies between vertices floor(i / 2) and ceil(i / 2) of the control curve
+        radius = (radius + 1) / 2 + maxPatchSize - 1;
+    }
+    // Inserting an inflection point on an edge depends on the vertex on either side of it
+    return radius + 2;
+}
+
+/*
+ * Copies the part of the curve that influences the smoothness penalty at idx into the test curve and returns the index
+ * of idx in the test curve. Copies the entire curve when it is not larger than this window.
+ */
+int NormalRefiner::copyTestCurve(const Curve &curve, const int idx, Curve &testCurve) const {
+    const int n = curve.numPoints();
+    const int radius = windowRadius();
+    if (!normRefSettings_.windowedEvaluation || 2 * radius + 1 >= n) {
+        curve.copyDataTo(testCurve);
+        return idx;
+    }
+    // Closed curves wrap around. The window itself is always open; its end points are far enough from idx to not
+    // influence the result.
+    const int start = curve.isClosed() ? idx - radius : std::max(idx - radius, 0);
+    const int end = curve.isClosed() ? idx + radius : std::min(idx + radius, n - 1);
+    const int size = end - start + 1;
+    auto &verts = testCurve.getVertices();
+    auto &normals = testCurve.getNormals();
+    auto &customNormals = testCurve.getCustomNormals();
+    verts.resize(size);
+    normals.resize(size);
+    customNormals.resize(size);
+    for (int i = 0; i < size; i++) {
+        const int curveIdx = (start + i + n) % n;
+        verts[i] = curve.getVertex(curveIdx);
+        normals[i] = curve.getNormal(curveIdx);
+        customNormals[i] = curve.isCustomNormal(curveIdx);
+    }
+    testCurve.setClosed(false, false);
+    return idx - start;
+}
+
+real_t NormalRefiner::candidatePenalty(const Curve &curve,
+                                       const int idx,
+                                       const Vector2DD &candidate,
+                                       const CurvatureType curvatureType,
+                                       Workspace &workspace) {
+    numEvaluations_.fetch_add(1, std::memory_order_relaxed);
+    // The candidate is only set in the test curve, so that both candidates can be evaluated at the same time
+    const int testCurveIdx = copyTestCurve(curve, idx, workspace.testCurve);
+    workspace.testCurve.setNormal(testCurveIdx, candidate);
+    // We need to calculate the smoothness at the given subdiv curve idx
+    const int testIdx = testCurveIdx * std::pow(2, normRefSettings_.testSubdivLevel);
+    if (useAnalyticCurvature()) {
+        workspace.subdivider.subdivide(workspace.testCurve, normRefSettings_.testSubdivLevel, workspace.curvatures);
+        return smoothnessPenalty(workspace.testCurve, testIdx, curvatureType, &workspace.curvatures);
+    }
+    workspace.subdivider.subdivide(workspace.testCurve, normRefSettings_.testSubdivLevel);
+    return smoothnessPenalty(workspace.testCurve, testIdx, curvatureType);
+}
+
+Vector2DD NormalRefiner::rotate(const Vector2DD &normal, const real_t radians) const {
+    const real_t cosRadians = subdivSettings_.fastMath ? fastmath::cos(radians) : cos(radians);
+    const real_t sinRadians = subdivSettings_.fastMath ? fastmath::sin(radians) : sin(radians);
+    return Vector2DD(cosRadians * normal.x() - sinRadians * normal.y(), sinRadians * normal.x() + cosRadians * normal.y())
+        .normalized();
+}
+
+/*
+ * Returns the normal halfway in between the normals of the two edges adjacent to idx and sets cosAngle to the cosine of
+ * the angle between these edge normals.
+ */
+Vector2DD NormalRefiner::bisectorNormal(const Curve &curve, const int idx, real_t &cosAngle) const {
+    // Find the normal of the line segment to the left
+    Vector2DD ab = curve.prevEdge(idx);
+    ab = {ab.y(), -ab.x()};
+    ab.normalize();
+    // Find the normal of the line segment to the right
+    Vector2DD cb = curve.nextEdge(idx);
+    cb = {-cb.y(), cb.x()};
+    cb.normalize();
+    cosAngle = ab.dot(cb);
+    return (ab + cb).normalized() * curve.vertexPointingDir(idx);
+}
+
+void NormalRefiner::searchBestNormal(Curve &curve,
+                                     const int idx,
+                                     const bool inflectionPoint,
+                                     const CurvatureType curvatureType,
+                                     Workspace *candidateWorkspaces) {
     auto &normal = curve.getNormal(idx);
     real_t angle;
     if (inflectionPoint) {
@@ -36,24 +152,31 @@ void NormalRefiner::binarySearchBestNormal(Curve &curve,
         normal = (edge.normalized() + edgeNormal.normalized()).normalized();
         angle = M_PI / 8.0; // Search 45 degrees on either side
     } else {
-        // Find the normal of the line segment to the left
-        Vector2DD ab = curve.prevEdge(idx);
-        ab = {ab.y(), -ab.x()};
-        ab.normalize();
-        // Find the normal of the line segment to the right
-        Vector2DD cb = curve.nextEdge(idx);
-        cb = {-cb.y(), cb.x()};
-        cb.normalize();
         // Put the normal halfway in between and set the search angle. This constrains the search
-        normal = (ab + cb).normalized() * curve.vertexPointingDir(idx);
+        real_t cosAngle;
+        normal = bisectorNormal(curve, idx, cosAngle);
         // divide by 4, because half the angle is the angle between the normal (which is in the middle) and its two bounds
         // Since we are doing binary search, we need to half that again to ensure we don't go out of bounds
-        angle = acos(ab.dot(cb)) / 4.0;
+        angle = (subdivSettings_.fastMath ? fastmath::acos(cosAngle) : acos(cosAngle)) / 4.0;
     }
 
+    if (normRefSettings_.searchMethod == BRENT) {
+        // The bisection search can reach up to twice the initial angle on either side
+        normal = brentSearch(curve, idx, normal, 2 * angle, curvatureType, candidateWorkspaces[0]);
+    } else {
+        normal = bisectionSearch(curve, idx, normal, angle, curvatureType, candidateWorkspaces);
+    }
+}
+
+Vector2DD NormalRefiner::bisectionSearch(const Curve &curve,
+                                         const int idx,
+                                         Vector2DD normal,
+                                         real_t angle,
+                                         const CurvatureType curvatureType,
+                                         Workspace *candidateWorkspaces) {
     Eigen::Matrix<real_t, 2, 2> rotationMatrix;
-    // We need to calculate the smoothness at the given subdiv curve idx
-    const int testIdx = idx * std::pow(2, normRefSettings_.testSubdivLevel);
+    Vector2DD candidates[2];
+    real_t penalties[2];
 
     // The idea is simple: we rotate both clockwise and counterclockwise by some angle
     // We pick whichever one results in a smoother curve
@@ -62,49 +185,543 @@ void NormalRefiner::binarySearchBestNormal(Curve &curve,
     while (angle > normRefSettings_.angleLimit) {
         // Set up the two normals we will test this iteration
         const real_t radians = angle;
-        rotationMatrix << std::cos(radians), std::sin(radians), -std::sin(radians), std::cos(radians);
-        const Vector2DD clockwiseNormal = (rotationMatrix * normal).normalized();
+        const real_t cosRadians = subdivSettings_.fastMath ? fastmath::cos(radians) : cos(radians);
+        const real_t sinRadians = subdivSettings_.fastMath ? fastmath::sin(radians) : sin(radians);
+        rotationMatrix << cosRadians, sinRadians, -sinRadians, cosRadians;
+        candidates[0] = (rotationMatrix * normal).normalized();
         rotationMatrix.transposeInPlace();
-        const Vector2DD counterclockwiseNormal = (rotationMatrix * normal).normalized();
-
-        // Calc curvature difference rotating clockwise
-        normal = clockwiseNormal;
-        curve.copyDataTo(testCurve_);
-        subdivider_.subdivide(testCurve_, normRefSettings_.testSubdivLevel);
-        const real_t clockwisePenalty = smoothnessPenalty(testCurve_, testIdx, curvatureType);
+        candidates[1] = (rotationMatrix * normal).normalized();
 
-        // Calc curvature difference rotating counterclockwise
-        normal = counterclockwiseNormal;
-        curve.copyDataTo(testCurve_);
-        subdivider_.subdivide(testCurve_, normRefSettings_.testSubdivLevel);
-        const real_t counterclockwisePenalty = smoothnessPenalty(testCurve_, testIdx, curvatureType);
+        // Calc curvature difference rotating clockwise (0) and counterclockwise (1)
+        // Does not spawn new threads when the vertices are already refined in parallel
+#pragma omp parallel for num_threads(2) if (normRefSettings_.parallel)
+        for (int i = 0; i < 2; i++) {
+            penalties[i] = candidatePenalty(curve, idx, candidates[i], curvatureType, candidateWorkspaces[i]);
+        }
 
         // We pick whichever one results in the lower curvature penalty
-        if (clockwisePenalty < counterclockwisePenalty) {
-            normal = clockwiseNormal;
-        }
+        normal = penalties[0] < penalties[1] ? candidates[0] : candidates[1];
         angle /= 2.0;
     }
+    return normal;
+}
+
+/*
+ * Brent's method: finds the angle in [-range, range] by which to rotate the normal to minimise the smoothness penalty.
+ * It combines parabolic interpolation through the three best evaluations with golden section steps whenever the
+ * parabola does not make enough progress. Every step costs a single penalty evaluation, and all previous evaluations
+ * in the bracket are reused.
+ *
+ * R. P. Brent, "Algorithms for Minimization without Derivatives", Prentice-Hall, 1973, chapter 5.
+ */
+Vector2DD NormalRefiner::brentSearch(const Curve &curve,
+                                     const int idx,
+                                     const Vector2DD &normal,
+                                     const real_t range,
+                                     const CurvatureType curvatureType,
+                                     Workspace &workspace) {
+    // (3 - sqrt(5)) / 2
+    constexpr real_t goldenSection = 0.381966011250105151795;
+    // Number of consecutive evaluations without a significant improvement after which the search is stopped
+    constexpr int maxStalledEvaluations = 3;
+    // The penalty p >= 1 has a kink at its minimum, where the parabolic steps would barely make progress. Minimise
+    // ((p - 1) / (p + 1))^2 instead, like the global refinement: it has the same minimum, but is smooth around it.
+    const auto penalty = [&](const real_t radians) {
+        const real_t p = candidatePenalty(curve, idx, rotate(normal, radians), curvatureType, workspace);
+        // A NaN or infinite penalty (e.g. zero curvature on either side) is as bad as it gets
+        const real_t t = isfinite(p) ? (p - 1) / (p + 1) : 1;
+        return t * t;
+    };
+    const real_t tol = normRefSettings_.angleLimit;
+    // The penalty is not necessarily unimodal over the entire range. Sample it coarsely first and bracket the best
+    // sample, so that the search does not get stuck in a worse local minimum.
+    constexpr int numSamples = 3;
+    real_t samples[numSamples];
+    real_t sampledPenalties[numSamples];
+    int best = 0;
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = -range + 2 * range * i / (numSamples - 1);
+        sampledPenalties[i] = penalty(samples[i]);
+        if (sampledPenalties[i] < sampledPenalties[best]) {
+            best = i;
+        }
+    }
+    // The minimum lies in [a, b]. x has the lowest penalty so far, w the second lowest and v the previous value of w
+    const int left = std::max(best - 1, 0);
+    const int right = std::min(best + 1, numSamples - 1);
+    real_t a = samples[left];
+    real_t b = samples[right];
+    real_t x = samples[best];
+    real_t fx = sampledPenalties[best];
+    // Reuse the neighbouring samples for the first parabolic step
+    const int second = sampledPenalties[left] <= sampledPenalties[right] ? left : right;
+    const int third = second == left ? right : left;
+    real_t w = samples[second], v = samples[third];
+    real_t fw = sampledPenalties[second], fv = sampledPenalties[third];
+    // d is the last step and e the one before it
+    real_t d = 0, e = b - a;
+    int stalledEvaluations = 0;
+
+    while (abs(x - (a + b) / 2) > 2 * tol - (b - a) / 2 && stalledEvaluations < maxStalledEvaluations) {
+        const real_t mid = (a + b) / 2;
+        bool parabolicStep = false;
+        if (abs(e) > tol) {
+            // Minimum of the parabola through x, w and v, relative to x: p / q
+            const real_t r = (x - w) * (fx - fv);
+            real_t q = (x - v) * (fx - fw);
+            real_t p = (x - v) * q - (x - w) * r;
+            q = 2 * (q - r);
+            if (q > 0) {
+                p = -p;
+            } else {
+                q = -q;
+            }
+            const real_t prevE = e;
+            e = d;
+            // Only accept a minimum inside the bracket that moves less than half the step before last
+            if (abs(p) < abs(q * prevE / 2) && p > q * (a - x) && p < q * (b - x)) {
+                d = p / q;
+                // Do not evaluate too close to the bracket
+                if ((x + d) - a < 2 * tol || b - (x + d) < 2 * tol) {
+                    d = x < mid ? tol : -tol;
+                }
+                parabolicStep = true;
+            }
+        }
+        if (!parabolicStep) {
+            // Golden section step into the larger part of the bracket
+            e = x < mid ? b - x : a - x;
+            d = goldenSection * e;
+        }
+        // Evaluations closer than tol to x are not meaningful
+        const real_t u = abs(d) >= tol ? x + d : x + (d > 0 ? tol : -tol);
+        const real_t fu = penalty(u);
+
+        // Evaluations that barely differ from the best penalty indicate the penalty has flattened out
+        if (abs(fu - fx) > normRefSettings_.penaltyTolerance * fx) {
+            stalledEvaluations = 0;
+        } else {
+            stalledEvaluations++;
+        }
+        if (fu <= fx) {
+            (u < x ? b : a) = x;
+            v = w;
+            fv = fw;
+            w = x;
+            fw = fx;
+            x = u;
+            fx = fu;
+        } else {
+            (u < x ? a : b) = u;
+            if (fu <= fw || w == x) {
+                v = w;
+                fv = fw;
+                w = u;
+                fw = fu;
+            } else if (fu <= fv || v == x || v == w) {
+                v = u;
+                fv = fu;
+            }
+        }
+    }
+    return rotate(normal, x);
+}
+
+void NormalRefiner::reserveWorkspaces(const int numThreads) {
+    // Workspaces are never removed, so references to them stay valid while refining
+    workspaces_.reserve(2 * numThreads);
+    while (workspaces_.size() < static_cast<size_t>(2 * numThreads)) {
+        workspaces_.emplace_back(subdivSettings_).subdivider.setMemoryResource(resource_);
+    }
+}
+
+void NormalRefiner::setMemoryResource(std::pmr::memory_resource *resource) {
+    resource_ = resource;
+    subdivider_.setMemoryResource(resource);
+    for (Workspace &workspace: workspaces_) {
+        workspace.subdivider.setMemoryResource(resource);
+    }
+}
+
+/*
+ * Refines the normal at idx and returns whether it rotated by more than the convergence angle. The search starts from
+ * the bisector of the adjacent edges rather than from the current normal, so its result only depends on the other
+ * normals in the window of idx.
+ */
+bool NormalRefiner::refineVertex(Curve &curve,
+                                 const int idx,
+                                 const CurvatureType curvatureType,
+                                 Workspace *candidateWorkspaces) {
+    const Vector2DD oldNormal = curve.getNormal(idx);
+    // The custom normal results correspond to the inflection points here
+    searchBestNormal(curve, idx, curve.isCustomNormal(idx), curvatureType, candidateWorkspaces);
+    const Vector2DD &newNormal = curve.getNormal(idx);
+    if (newNormal == oldNormal) {
+        return false;
+    }
+    const real_t cross = oldNormal.x() * newNormal.y() - oldNormal.y() * newNormal.x();
+    return atan2(abs(cross), oldNormal.dot(newNormal)) > normRefSettings_.convergenceAngle;
+}
+
+// Marks every vertex whose smoothness penalty depends on the normal at idx, apart from idx itself
+void NormalRefiner::markWindowDirty(const Curve &curve, const int idx, std::pmr::vector<uint8_t> &dirty) const {
+    const int n = curve.numPoints();
+    const int radius = std::min(windowRadius(), n);
+    for (int offset = -radius; offset <= radius; offset++) {
+        const int j = idx + offset;
+        if (offset == 0 || (!curve.isClosed() && (j < 0 || j >= n))) {
+            continue;
+        }
+        dirty[(j % n + n) % n] = 1;
+    }
+}
+
+void NormalRefiner::reportProgress(const std::string_view task, const int done, const int total) const {
+    if (progressCallback_) {
+        progressCallback_(task, done, total);
+    }
+}
+
+/*
+ * Refines the dirty vertices in order and returns how many were refined. A refined vertex is no longer dirty, unless a
+ * vertex in its window is refined afterwards and rotates by more than the convergence angle. Vertices later in the
+ * sweep are then refined in this sweep, earlier ones in the next. This gives the same result as refining every vertex
+ * in every sweep (up to the convergence angle), but the converged parts of the curve cost nothing.
+ */
+int NormalRefiner::refineIteration(Curve &curve, const CurvatureType curvatureType, std::pmr::vector<uint8_t> &dirty) {
+    const int n = curve.numPoints();
+    // Vertices that lie further apart than the window radius do not influence each other's smoothness penalty. Vertex j
+    // gets colour j % numColours, so vertices of the same colour can be refined at the same time. The colours are
+    // processed one after the other (Gauss-Seidel style), which makes the result independent of the thread scheduling.
+    const int numColours = windowRadius() + 1;
+    const int numBlocks = n / numColours;
+    const bool independent = normRefSettings_.parallel && normRefSettings_.windowedEvaluation &&
+                             2 * numColours - 1 < n && numBlocks > 1;
+    // The remaining vertices lie too close to the first block of closed curves, so these are refined sequentially
+    const int numColoured = independent ? numBlocks * numColours : 0;
+    reserveWorkspaces(independent ? omp_get_max_threads() : 1);
+
+    int numRefined = 0;
+    std::pmr::vector<uint8_t> changed(independent ? n : 0, resource_);
+    for (int colour = 0; colour < (independent ? numColours : 0); colour++) {
+        // The windows of vertices of the same colour overlap, so the dirty flags are only marked after the round. The
+        // windows never contain another vertex of the same colour, so this does not change which vertices are refined.
+#pragma omp parallel for schedule(dynamic) reduction(+ : numRefined)
+        for (int block = 0; block < numBlocks; block++) {
+            const int j = block * numColours + colour;
+            if (!dirty[j] || cancellation_.isCancelled()) {
+                continue;
+            }
+            dirty[j] = 0;
+            changed[j] = refineVertex(curve, j, curvatureType, &workspaces_[2 * omp_get_thread_num()]);
+            numRefined++;
+            CONIS_LOG(LOG_TRACE, "Refined idx: " << j);
+        }
+        for (int block = 0; block < numBlocks; block++) {
+            const int j = block * numColours + colour;
+            if (changed[j]) {
+                markWindowDirty(curve, j, dirty);
+                changed[j] = 0;
+            }
+        }
+        reportProgress("Refining normals", (colour + 1) * numBlocks, n);
+    }
+    for (int j = numColoured; j < n && !cancellation_.isCancelled(); j++) {
+        if (!dirty[j]) {
+            continue;
+        }
+        dirty[j] = 0;
+        if (refineVertex(curve, j, curvatureType, workspaces_.data())) {
+            markWindowDirty(curve, j, dirty);
+        }
+        numRefined++;
+        CONIS_LOG(LOG_TRACE, "Refined idx: " << j);
+        reportProgress("Refining normals", j + 1, n);
+    }
+    return numRefined;
+}
+
+/*
+ * Subdivides the curve with normal j rotated by angles[j] and stores the smoothness energy of every control point in
+ * the energies of the workspace. The penalty p >= 1 is mapped to ((p - 1) / (p + 1))^2. This has its minimum at the
+ * same normal as the penalty itself, but it is bounded and smooth around the minimum, which suits a quasi-Newton method
+ * better than the kink of the penalty.
+ */
+void NormalRefiner::evaluateEnergies(const Curve &curve,
+                                     const std::pmr::vector<Vector2DD> &baseNormals,
+                                     const VectorXDD &angles,
+                                     const CurvatureType curvatureType,
+                                     Workspace &workspace) {
+    numEvaluations_.fetch_add(1, std::memory_order_relaxed);
+    const int n = curve.numPoints();
+    Curve &testCurve = workspace.testCurve;
+    curve.copyDataTo(testCurve);
+    for (int j = 0; j < n; j++) {
+        testCurve.setNormal(j, rotate(baseNormals[j], angles[j]));
+    }
+    const int level = normRefSettings_.testSubdivLevel;
+    const std::vector<real_t> *curvatures = nullptr;
+    if (useAnalyticCurvature()) {
+        workspace.subdivider.subdivide(testCurve, level, workspace.curvatures);
+        curvatures = &workspace.curvatures;
+    } else {
+        workspace.subdivider.subdivide(testCurve, level);
+    }
+    workspace.energies.resize(n);
+    for (int i = 0; i < n; i++) {
+        // The end points of an open curve only have a neighbour on one side
+        if (!curve.isClosed() && (i == 0 || i == n - 1)) {
+            workspace.energies[i] = 0;
+            continue;
+        }
+        const real_t penalty = smoothnessPenalty(testCurve, i * (1 << level), curvatureType, curvatures);
+        // Zero curvature on either side is as bad as it gets
+        const real_t t = isfinite(penalty) ? (penalty - 1) / (penalty + 1) : 1;
+        workspace.energies[i] = t * t;
+    }
+}
+
+real_t NormalRefiner::globalEnergy(const Curve &curve,
+                                   const std::pmr::vector<Vector2DD> &baseNormals,
+                                   const VectorXDD &angles,
+                                   const CurvatureType curvatureType) {
+    Workspace &workspace = workspaces_[0];
+    evaluateEnergies(curve, baseNormals, angles, curvatureType, workspace);
+    real_t energy = 0;
+    for (const real_t e: workspace.energies) {
+        energy += e;
+    }
+    return energy;
+}
+
+/*
+ * Approximates the gradient of the global energy using central finite differences. The energy of vertex i only depends
+ * on the normals within windowRadius() of it, so the normals that lie more than twice this radius apart can be
+ * perturbed at the same time: the derivative with respect to each of them is the change in energy of the vertices
+ * around it. This needs 2 * (2 * windowRadius() + 1) subdivisions, independent of the curve size.
+ *
+ * A. R. Curtis, M. J. D. Powell and J. K. Reid, "On the Estimation of Sparse Jacobian Matrices", IMA Journal of
+ * Applied Mathematics, Vol. 13, No. 1, 1974, pp. 117-119.
+ */
+void NormalRefiner::globalGradient(const Curve &curve,
+                                   const std::pmr::vector<Vector2DD> &baseNormals,
+                                   const VectorXDD &angles,
+                                   const CurvatureType curvatureType,
+                                   VectorXDD &gradient) {
+    const int n = curve.numPoints();
+    const int radius = windowRadius();
+    const int numColours = 2 * radius + 1;
+    // Vertex j < numColoured gets colour j % numColours. On closed curves, the remaining vertices lie too close to the
+    // first vertices, so each of them is perturbed on its own.
+    const int numColoured = curve.isClosed() ? n / numColours * numColours : n;
+    std::pmr::vector<std::pmr::vector<int>> groups(resource_);
+    for (int colour = 0; colour < std::min(numColours, numColoured); colour++) {
+        groups.emplace_back();
+        for (int j = colour; j < numColoured; j += numColours) {
+            groups.back().push_back(j);
+        }
+    }
+    for (int j = numColoured; j < n; j++) {
+        groups.push_back({j});
+    }
+
+    const real_t h = normRefSettings_.finiteDifferenceStep;
+    const int numGroups = static_cast<int>(groups.size());
+    // The sum of the energies around every vertex, with its normal rotated forwards (0) and backwards (1)
+    std::pmr::vector<real_t> localEnergies[2] = {std::pmr::vector<real_t>(n, resource_),
+                                                 std::pmr::vector<real_t>(n, resource_)};
+#pragma omp parallel for schedule(dynamic) if (normRefSettings_.parallel)
+    for (int task = 0; task < 2 * numGroups; task++) {
+        const std::pmr::vector<int> &group = groups[task / 2];
+        const int direction = task % 2;
+        Workspace &workspace = workspaces_[omp_get_thread_num()];
+        VectorXDD perturbed = angles;
+        for (const int j: group) {
+            perturbed[j] += direction == 0 ? h : -h;
+        }
+        evaluateEnergies(curve, baseNormals, perturbed, curvatureType, workspace);
+        // Every vertex is in a single group, so the tasks write to different elements
+        for (const int j: group) {
+            real_t sum = 0;
+            if (2 * radius + 1 >= n) {
+                for (const real_t e: workspace.energies) {
+                    sum += e;
+                }
+            } else {
+                for (int k = -radius; k <= radius; k++) {
+                    const int i = curve.isClosed() ? (j + k + n) % n : j + k;
+                    if (i >= 0 && i < n) {
+                        sum += workspace.energies[i];
+                    }
+                }
+            }
+            localEnergies[direction][j] = sum;
+        }
+    }
+    gradient.resize(n);
+    for (int j = 0; j < n; j++) {
+        gradient[j] = (localEnergies[0][j] - localEnergies[1][j]) / (2 * h);
+    }
 }
 
-void NormalRefiner::refine(Curve &curve, const CurvatureType curvatureType) {
+/*
+ * Minimises the sum of the smoothness energies of all vertices over the angles by which each normal is rotated, using
+ * L-BFGS with a backtracking (Armijo) line search.
+ *
+ * J. Nocedal and S. J. Wright, "Numerical Optimization", 2nd edition, Springer, 2006, algorithms 7.4 and 7.5.
+ */
+void NormalRefiner::refineGlobal(Curve &curve, const CurvatureType curvatureType) {
+    // Number of correction pairs that approximate the inverse Hessian
+    constexpr int historySize = 7;
+    constexpr real_t sufficientDecrease = 1e-4;
+    constexpr int maxBacktracks = 20;
+    // No normal is rotated by more than this (in radians) in a single step
+    constexpr real_t maxAngleStep = 0.1;
+
     const int n = curve.numPoints();
+    reserveWorkspaces(normRefSettings_.parallel ? omp_get_max_threads() : 1);
+    // Start from either the current normals or, like the sequential refinement, from the bisector normals; whichever is
+    // smoother. The inflection points keep their normal in both cases.
+    std::pmr::vector<Vector2DD> baseNormals(n, resource_);
+    std::pmr::vector<Vector2DD> bisectorNormals(n, resource_);
+    for (int j = 0; j < n; j++) {
+        real_t cosAngle;
+        baseNormals[j] = curve.getNormal(j).normalized();
+        bisectorNormals[j] = curve.isCustomNormal(j) ? baseNormals[j] : bisectorNormal(curve, j, cosAngle);
+    }
+    VectorXDD angles = VectorXDD::Zero(n);
+    real_t energy = globalEnergy(curve, baseNormals, angles, curvatureType);
+    const real_t bisectorEnergy = globalEnergy(curve, bisectorNormals, angles, curvatureType);
+    if (bisectorEnergy < energy) {
+        baseNormals = std::move(bisectorNormals);
+        energy = bisectorEnergy;
+    }
+    VectorXDD gradient;
+    globalGradient(curve, baseNormals, angles, curvatureType, gradient);
+    std::pmr::vector<VectorXDD> steps(resource_);
+    std::pmr::vector<VectorXDD> gradientChanges(resource_);
+    std::pmr::vector<real_t> rhos(resource_);
+    CONIS_LOG(LOG_DEBUG, "Global refinement start: energy " << energy);
+
+    for (int iteration = 0; iteration < normRefSettings_.maxGlobalIterations && !cancellation_.isCancelled();
+         iteration++) {
+        if (gradient.lpNorm<Eigen::Infinity>() < normRefSettings_.gradientTolerance) {
+            break;
+        }
+        // Two-loop recursion: direction = -H * gradient
+        const int historyLength = static_cast<int>(steps.size());
+        std::pmr::vector<real_t> alphas(historyLength, resource_);
+        VectorXDD direction = -gradient;
+        for (int k = historyLength - 1; k >= 0; k--) {
+            alphas[k] = rhos[k] * steps[k].dot(direction);
+            direction -= alphas[k] * gradientChanges[k];
+        }
+        if (historyLength > 0) {
+            direction *= steps.back().dot(gradientChanges.back()) / gradientChanges.back().squaredNorm();
+        }
+        for (int k = 0; k < historyLength; k++) {
+            const real_t beta = rhos[k] * gradientChanges[k].dot(direction);
+            direction += (alphas[k] - beta) * steps[k];
+        }
+        real_t slope = gradient.dot(direction);
+        if (!(slope < 0)) {
+            // The approximation of the Hessian is not positive definite enough; fall back to steepest descent
+            direction = -gradient;
+            slope = gradient.dot(direction);
+        }
+
+        real_t stepLength = std::min(static_cast<real_t>(1), maxAngleStep / direction.lpNorm<Eigen::Infinity>());
+        VectorXDD trialAngles;
+        real_t trialEnergy = energy;
+        bool accepted = false;
+        for (int backtrack = 0; backtrack < maxBacktracks && !accepted; backtrack++) {
+            trialAngles = angles + stepLength * direction;
+            trialEnergy = globalEnergy(curve, baseNormals, trialAngles, curvatureType);
+            accepted = trialEnergy <= energy + sufficientDecrease * stepLength * slope;
+            if (!accepted) {
+                stepLength /= 2;
+            }
+        }
+        if (!accepted) {
+            if (steps.empty()) {
+                // Not even a steepest descent step decreases the energy
+                break;
+            }
+            // Retry from steepest descent
+            steps.clear();
+            gradientChanges.clear();
+            rhos.clear();
+            continue;
+        }
+
+        VectorXDD trialGradient;
+        globalGradient(curve, baseNormals, trialAngles, curvatureType, trialGradient);
+        VectorXDD step = trialAngles - angles;
+        VectorXDD gradientChange = trialGradient - gradient;
+        const real_t curvature = step.dot(gradientChange);
+        // Only keep pairs that keep the approximation of the inverse Hessian positive definite
+        if (curvature > std::numeric_limits<real_t>::epsilon() * step.norm() * gradientChange.norm()) {
+            if (static_cast<int>(steps.size()) == historySize) {
+                steps.erase(steps.begin());
+                gradientChanges.erase(gradientChanges.begin());
+                rhos.erase(rhos.begin());
+            }
+            steps.push_back(std::move(step));
+            gradientChanges.push_back(std::move(gradientChange));
+            rhos.push_back(1 / curvature);
+        }
+        const real_t decrease = energy - trialEnergy;
+        angles = std::move(trialAngles);
+        gradient = std::move(trialGradient);
+        energy = trialEnergy;
+        CONIS_LOG(LOG_DEBUG,
+                  "Global iteration done: " << iteration << " (energy " << energy << ", max gradient "
+                                            << gradient.lpNorm<Eigen::Infinity>() << ", " << getNumEvaluations()
+                                            << " penalty evaluations)");
+        reportProgress("Refining normals globally", iteration + 1, normRefSettings_.maxGlobalIterations);
+        if (decrease <= normRefSettings_.penaltyTolerance * energy) {
+            break;
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        curve.setNormal(j, rotate(baseNormals[j], angles[j]));
+    }
+}
+
+void NormalRefiner::refine(Curve &curve, const CurvatureType curvatureType, const CancellationToken &cancellation) {
     const Curve inflCurve = subdivider_.getInflPointCurve(curve);
     inflCurve.copyDataTo(curve);
+    // The normals are written directly from here on, also concurrently, so the spatial index is invalidated up front
+    curve.invalidateSpatialIndex();
 
-    // Eventually do this until convergence with a maxIter as a max bound
-    for (int i = 0; i < normRefSettings_.maxRefinementIterations; i++) {
-        for (int j = 0; j < n; j++) {
-            // The custom normal results correspond to the inflection points here
-            binarySearchBestNormal(curve, j, curve.isCustomNormal(j), curvatureType);
-            std::cout << "Refined idx: " << j << std::endl;
+    resetNumEvaluations();
+    cancellation_ = cancellation;
+    if (normRefSettings_.mode == GLOBAL) {
+        refineGlobal(curve, curvatureType);
+        cancellation_ = {};
+        return;
+    }
+    const bool trackConvergence = normRefSettings_.convergenceAngle >= 0;
+    std::pmr::vector<uint8_t> dirty(curve.numPoints(), 1, resource_);
+    for (int i = 0; i < normRefSettings_.maxRefinementIterations && !cancellation_.isCancelled(); i++) {
+        if (!trackConvergence) {
+            std::fill(dirty.begin(), dirty.end(), 1);
+        } else if (std::find(dirty.begin(), dirty.end(), 1) == dirty.end()) {
+            CONIS_LOG(LOG_DEBUG, "Converged after " << i << " iterations");
+            break;
         }
-        std::cout << "Iteration done: " << i << std::endl;
+        const int numRefined = refineIteration(curve, curvatureType, dirty);
+        CONIS_LOG(LOG_DEBUG,
+                  "Iteration done: " << i << " (" << numRefined << " vertices refined, " << getNumEvaluations()
+                                     << " penalty evaluations)");
     }
+    cancellation_ = {};
 }
 
 void NormalRefiner::refineSelected(Curve &curve, const CurvatureType curvatureType, const int idx) {
-    binarySearchBestNormal(curve, idx, false, curvatureType);
+    reserveWorkspaces(1);
+    curve.invalidateSpatialIndex();
+    searchBestNormal(curve, idx, false, curvatureType, workspaces_.data());
 }
 
 } // namespace conis::core
@@ -0,0 +1,88 @@
+#include "conis/core/curve/spatialgrid.hpp"
+
+namespace conis::core {
+
+void SpatialGrid::reset(const double cellSize) {
+    cellSize_ = cellSize;
+    cells_.clear();
+    oversized_.clear();
+    minX_ = minY_ = std::numeric_limits<int>::max();
+    maxX_ = maxY_ = std::numeric_limits<int>::min();
+}
+
+int SpatialGrid::cellCoord(const real_t coord) const {
+    // Clamped, so that far away (or non-finite) coordinates cannot overflow the cell coordinates
+    constexpr double limit = 1 << 30;
+    const double cell = std::floor(static_cast<double>(coord) / cellSize_);
+    return static_cast<int>(std::clamp(std::isnan(cell) ? 0.0 : cell, -limit, limit));
+}
+
+int64_t SpatialGrid::cellKey(const int x, const int y) {
+    return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(y);
+}
+
+void SpatialGrid::insert(const int id, const Vector2DD &min, const Vector2DD &max) {
+    const int x0 = cellCoord(min.x());
+    const int y0 = cellCoord(min.y());
+    const int x1 = cellCoord(max.x());
+    const int y1 = cellCoord(max.y());
+    if (static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) > maxCellsPerItem) {
+        oversized_.push_back(id);
+        return;
+    }
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            cells_[cellKey(x, y)].push_back(id);
+        }
+    }
+    minX_ = std::min(minX_, x0);
+    minY_ = std::min(minY_, y0);
+    maxX_ = std::max(maxX_, x1);
+    maxY_ = std::max(maxY_, y1);
+}
+
+void SpatialGrid::remove(const int id, const Vector2DD &min, const Vector2DD &max) {
+    const auto eraseId = [id](std::vector<int> &ids) {
+        const auto it = std::find(ids.begin(), ids.end(), id);
+        if (it != ids.end()) {
+            *it = ids.back();
+            ids.pop_back();
+        }
+    };
+    const int x0 = cellCoord(min.x());
+    const int y0 = cellCoord(min.y());
+    const int x1 = cellCoord(max.x());
+    const int y1 = cellCoord(max.y());
+    if (static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) > maxCellsPerItem) {
+        eraseId(oversized_);
+        return;
+    }
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            const auto it = cells_.find(cellKey(x, y));
+            if (it == cells_.end()) {
+                continue;
+            }
+            eraseId(it->second);
+            if (it->second.empty()) {
+                cells_.erase(it);
+            }
+        }
+    }
+}
+
+void SpatialGrid::shiftIds(const int from, const int delta) {
+    const auto shift = [from, delta](std::vector<int> &ids) {
+        for (int &id: ids) {
+            if (id >= from) {
+                id += delta;
+            }
+        }
+    };
+    for (auto &[key, ids]: cells_) {
+        shift(ids);
+    }
+    shift(oversized_);
+}
+
+} // namespace conis::core
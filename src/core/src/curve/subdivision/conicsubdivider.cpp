@@ -2,23 +2,93 @@
 
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <optional>
 
 #include "conis/core/conics/conic.hpp"
+#include "conis/core/precisionstats.hpp"
+#include "util/cpudispatch.hpp"
+#include "util/fastmath.hpp"
+#include "util/filteredvalue.hpp"
 
 namespace conis::core {
 
+// Converts a setting to the scalar type of the subdivision. Dual can only be constructed from a double, so a
+// DoubleDouble real_t has to be converted explicitly.
+template<typename S>
+static S settingAs(const real_t value) {
+    if constexpr (std::is_same_v<S, Dual>) {
+        return Dual(static_cast<double>(value));
+    } else {
+        return static_cast<S>(value);
+    }
+}
+
 ConicSubdivider::ConicSubdivider(const SubdivisionSettings &settings)
     : settings_(settings),
-      fitter_(settings.epsilon) {}
+      fitter_(settings.epsilon),
+      doubleFitter_(static_cast<double>(settings.epsilon)),
+      floatFitter_(static_cast<float>(settings.epsilon)),
+      dualFitter_(Dual(static_cast<double>(settings.epsilon))),
+      patchBuffers_(std::in_place, resource_) {}
+
+void ConicSubdivider::setMemoryResource(std::pmr::memory_resource *resource) {
+    resource_ = resource;
+    patchBuffers_.emplace(resource);
+}
+
+template<typename S>
+BasicConicFitter<S> &ConicSubdivider::fitter() {
+    if constexpr (std::is_same_v<S, real_t>) {
+        return fitter_;
+    } else if constexpr (std::is_same_v<S, double>) {
+        return doubleFitter_;
+    } else if constexpr (std::is_same_v<S, Dual>) {
+        return dualFitter_;
+    } else {
+        static_assert(std::is_same_v<S, float>, "Unsupported subdivision scalar type");
+        return floatFitter_;
+    }
+}
+
+template<typename S>
+PatchPoints<S> &ConicSubdivider::patchBuffer() {
+    if constexpr (std::is_same_v<S, real_t>) {
+        return patchBuffers_->patch;
+    } else if constexpr (std::is_same_v<S, double>) {
+        return patchBuffers_->doublePatch;
+    } else if constexpr (std::is_same_v<S, Dual>) {
+        return patchBuffers_->dualPatch;
+    } else {
+        static_assert(std::is_same_v<S, float>, "Unsupported subdivision scalar type");
+        return patchBuffers_->floatPatch;
+    }
+}
+
+// The fast approximation has no derivatives, so dual numbers always use the exact function
+template<typename S>
+static S inflAcos(const S &x, const bool fastMath) {
+    if constexpr (std::is_same_v<S, Dual>) {
+        return acos(x);
+    } else {
+        return fastMath ? fastmath::acos(x) : acos(x);
+    }
+}
 
 void ConicSubdivider::subdivide(Curve &curve, const int level) {
     if (curve.numPoints() == 0 || level == 0) {
+        inflPointIndices_.clear();
         return;
     }
+    // The subdivided points are not tracked by the spatial index of the curve (if any)
+    curve.invalidateSpatialIndex();
+    completedLevels_ = 0;
+    totalLevels_ = level;
     bufferCurve_.setClosed(curve.isClosed(), false);
     if (settings_.convexitySplit) {
         // Insert directly into the buffer curve to prevent re-allocations
         insertInflPoints(curve, bufferCurve_);
+        resetCurvatures(bufferCurve_.numPoints());
         // In this case the curve to subdivide is in the buffer, not in the curve
         if (level % 2 == 1) {
             subdivideRecursive(bufferCurve_, curve, level);
@@ -29,6 +99,7 @@ void ConicSubdivider::subdivide(Curve &curve, const int level) {
         }
     } else {
         inflPointIndices_.clear();
+        resetCurvatures(curve.numPoints());
         if (level % 2 == 1) {
             // Ensure the final result always ends up in the curve itself again
             curve.copyDataTo(bufferCurve_);
@@ -40,7 +111,80 @@ void ConicSubdivider::subdivide(Curve &curve, const int level) {
     curve.getCustomNormals().resize(curve.numPoints());
 }
 
-void ConicSubdivider::subdivideRecursive(Curve &controlCurve, Curve &subdivCurve, const int level) {
+void ConicSubdivider::subdivide(Curve &curve, const int level, std::vector<real_t> &curvatures) {
+    // Only the control points remain if nothing is subdivided
+    curvatures.assign(curve.numPoints(), std::numeric_limits<real_t>::quiet_NaN());
+    curvatures_ = &curvatures;
+    subdivide(curve, level);
+    curvatures_ = nullptr;
+}
+
+void ConicSubdivider::resetCurvatures(const int numPoints) {
+    if (curvatures_ == nullptr) {
+        return;
+    }
+    curvatures_->assign(numPoints, std::numeric_limits<real_t>::quiet_NaN());
+    for (const int inflIdx: inflPointIndices_) {
+        (*curvatures_)[inflIdx] = 0;
+    }
+}
+
+template<typename S>
+void ConicSubdivider::subdivide(const Curve &curve, const int level, CompactCurve<S> &result) {
+    if (curve.numPoints() == 0 || level == 0) {
+        inflPointIndices_.clear();
+        result.assign(curve);
+        return;
+    }
+    completedLevels_ = 0;
+    totalLevels_ = level;
+    const int fullLevels = settings_.fullPrecisionLevels < 0 ? level : std::min(level, settings_.fullPrecisionLevels);
+    bufferCurve_.setClosed(curve.isClosed(), false);
+    if (settings_.convexitySplit) {
+        insertInflPoints(curve, mixedCurve_);
+    } else {
+        inflPointIndices_.clear();
+        curve.copyDataTo(mixedCurve_);
+    }
+    // Double buffering: for an odd number of levels the result ends up in the buffer
+    subdivideRecursive(mixedCurve_, bufferCurve_, fullLevels);
+    result.assign(fullLevels % 2 == 0 ? mixedCurve_ : bufferCurve_);
+
+    const int compactLevels = level - fullLevels;
+    CompactCurve<S> compactBuffer;
+    compactBuffer.setClosed(curve.isClosed());
+    subdivideRecursive(result, compactBuffer, compactLevels);
+    if (compactLevels % 2 == 1) {
+        std::swap(result, compactBuffer);
+    }
+}
+
+void ConicSubdivider::subdivide(const CompactCurve<Dual> &curve, const int level, CompactCurve<Dual> &result) {
+    completedLevels_ = 0;
+    totalLevels_ = level;
+    CompactCurve<Dual> buffer;
+    if (settings_.convexitySplit) {
+        insertInflPoints(curve, result);
+    } else {
+        inflPointIndices_.clear();
+        curve.copyDataTo(result);
+    }
+    subdivideRecursive(result, buffer, level);
+    if (level % 2 == 1) {
+        std::swap(result, buffer);
+    }
+}
+
+// Copies the coordinates of the control points to the even indices [0, n) of the subdivision curve
+template<typename S>
+static void spreadCoords(const S *controlCoords, const int n, S *subdivCoords) {
+    for (int i = 0; i < n; i += 2) {
+        subdivCoords[i] = controlCoords[i / 2];
+    }
+}
+
+template<typename CurveT>
+void ConicSubdivider::subdivideRecursive(CurveT &controlCurve, CurveT &subdivCurve, const int level) {
     // base case
     if (level == 0) {
         return;
@@ -49,45 +193,107 @@ void ConicSubdivider::subdivideRecursive(Curve &controlCurve, Curve &subdivCurve
     if (controlCurve.isClosed()) {
         n += 1;
     }
-    subdivCurve.getVertices().resize(n);
-    subdivCurve.getNormals().resize(n);
-
     // set old vertex points
-    for (int i = 0; i < n; i += 2) {
-        subdivCurve.setVertex(i, controlCurve.getVertex(i / 2));
-        subdivCurve.setNormal(i, controlCurve.getNormal(i / 2));
+    if constexpr (std::is_same_v<CurveT, Curve>) {
+        subdivCurve.getVertices().resize(n);
+        subdivCurve.getNormals().resize(n);
+        for (int i = 0; i < n; i += 2) {
+            subdivCurve.setVertex(i, controlCurve.getVertex(i / 2));
+            subdivCurve.setNormal(i, controlCurve.getNormal(i / 2));
+        }
+    } else {
+        // One strided copy per coordinate array
+        subdivCurve.resize(n);
+        spreadCoords(controlCurve.getXs(), n, subdivCurve.getXs());
+        spreadCoords(controlCurve.getYs(), n, subdivCurve.getYs());
+        spreadCoords(controlCurve.getNormalXs(), n, subdivCurve.getNormalXs());
+        spreadCoords(controlCurve.getNormalYs(), n, subdivCurve.getNormalYs());
+    }
+    CurveScalar<CurveT> *curvatures = nullptr;
+    if constexpr (std::is_same_v<CurveT, Curve>) {
+        if (curvatures_ != nullptr) {
+            // Old vertex points keep their curvature
+            curvatureBuffer_.resize(n);
+            for (int i = 0; i < n; i += 2) {
+                curvatureBuffer_[i] = (*curvatures_)[i / 2];
+            }
+            curvatures = curvatureBuffer_.data();
+        }
     }
     // set new edge points
     for (int i = 1; i < n; i += 2) {
-        edgePoint(controlCurve, subdivCurve, i);
+        edgePoint(controlCurve, subdivCurve, i, curvatures == nullptr ? nullptr : curvatures + i);
+    }
+    if (curvatures != nullptr) {
+        curvatures_->swap(curvatureBuffer_);
     }
     // Update the indices of the inflection points
     for (int &inflIdx: inflPointIndices_) {
         inflIdx *= 2;
     }
+    if (progressCallback_) {
+        progressCallback_("Subdividing", ++completedLevels_, totalLevels_);
+    }
     // Double buffering: switch the curves
     subdivideRecursive(subdivCurve, controlCurve, level - 1);
 }
 
-void ConicSubdivider::edgePoint(const Curve &controlCurve, Curve &subdivCurve, const int i) {
+template<typename CurveT>
+void ConicSubdivider::edgePoint(const CurveT &controlCurve,
+                                CurveT &subdivCurve,
+                                const int i,
+                                CurveScalar<CurveT> *curvature) {
+    using S = CurveScalar<CurveT>;
     const int n = subdivCurve.numPoints();
     const int prevIdx = (i - 1 + n) % n;
     const int nextIdx = (i + 1) % n;
 
     // Construct origin and direction of the ray we use to intersect the found conic
-    const Vector2DD origin = (subdivCurve.getVertex(prevIdx) + subdivCurve.getVertex(nextIdx)) / 2.0;
-    Vector2DD dir = subdivCurve.getVertex(prevIdx) - subdivCurve.getVertex(nextIdx);
+    const Vector2<S> origin = (subdivCurve.getVertex(prevIdx) + subdivCurve.getVertex(nextIdx)) / S(2);
+    Vector2<S> dir = subdivCurve.getVertex(prevIdx) - subdivCurve.getVertex(nextIdx);
     // rotate the line segment counterclockwise 90 degree to get the normal of it
     // Note that dir is not normalized! This is to prevent introducing further rounding errors.
     // The conic solver finds a multiple of the normal, so the length does not matter
     dir = {dir.y(), -dir.x()};
 
+    // The lower precision levels fit the conic in local coordinates: centred at the edge midpoint and scaled to the
+    // edge length. This keeps the linear system well-conditioned, which float in particular needs. The fit is not
+    // invariant under this transformation, so dual numbers fit in global coordinates to differentiate the real_t result.
+    constexpr bool localFit = !std::is_same_v<S, real_t> && !std::is_same_v<S, Dual>;
+    const S edgeLength = dir.norm();
+    const S scale = edgeLength > 0 ? edgeLength : S(1);
+    const auto fitAndSample = [&](PatchPoints<S> &patch, Vector2<S> &point, Vector2<S> &normal) {
+        if constexpr (localFit) {
+            for (auto &p: patch) {
+                p.vertex = (p.vertex - origin) / scale;
+            }
+            const BasicConic<S> conic = fitter<S>().fitConic(patch);
+            if (!conic.sample(Vector2<S>::Zero(), dir / scale, point, normal)) {
+                return false;
+            }
+            if (curvature != nullptr) {
+                *curvature = conic.curvature(point) / scale;
+            }
+            point = point * scale + origin;
+            return true;
+        } else {
+            const BasicConic<S> conic = fitter<S>().fitConic(patch);
+            if (!conic.sample(origin, dir, point, normal)) {
+                return false;
+            }
+            if (curvature != nullptr) {
+                *curvature = conic.curvature(point);
+            }
+            return true;
+        }
+    };
+
     // i/2 as we extract the patch from the control curve (while we're currently in the index space of the subdiv curve)
-    std::vector<PatchPoint> patchPoints = extractPatch(controlCurve, i / 2, settings_.patchSize);
-    const Conic conic = fitter_.fitConic(patchPoints);
-    Vector2DD sampledPoint;
-    Vector2DD sampledNormal;
-    bool valid = conic.sample(origin, dir, sampledPoint, sampledNormal);
+    PatchPoints<S> &patchPoints = patchBuffer<S>();
+    extractCurvePatch(controlCurve, i / 2, settings_.patchSize, patchPoints);
+    Vector2<S> sampledPoint;
+    Vector2<S> sampledNormal;
+    bool valid = fitAndSample(patchPoints, sampledPoint, sampledNormal);
     if (!valid) {
         if (settings_.dynamicPatchSize) {
             // Keep growing the patch size until a solution is found
@@ -95,22 +301,27 @@ void ConicSubdivider::edgePoint(const Curve &controlCurve, Curve &subdivCurve, c
             int patchSize = settings_.patchSize + 1;
             int oldPatchSize = patchPoints.size();
             while (!valid) {
-                patchPoints = extractPatch(controlCurve, i / 2, patchSize);
+                extractCurvePatch(controlCurve, i / 2, patchSize, patchPoints);
                 // 4 is the absolute max patch size (number of points on either side, so 9 in total max)
                 if (patchSize > 4 || patchPoints.size() == oldPatchSize) {
                     sampledPoint = origin;
                     sampledNormal = dir;
+                    if (curvature != nullptr) {
+                        *curvature = 0;
+                    }
                     break;
                 }
                 oldPatchSize = patchPoints.size();
-                const Conic conic2 = fitter_.fitConic(patchPoints);
-                valid = conic2.sample(origin, dir, sampledPoint, sampledNormal);
+                valid = fitAndSample(patchPoints, sampledPoint, sampledNormal);
                 patchSize++;
             }
         } else {
             // No valid conic found, set to midpoint and its normal
             sampledPoint = origin;
             sampledNormal = dir;
+            if (curvature != nullptr) {
+                *curvature = 0;
+            }
         }
     }
 #ifdef NORMALIZE_CONIC_NORMALS
@@ -123,144 +334,232 @@ void ConicSubdivider::edgePoint(const Curve &controlCurve, Curve &subdivCurve, c
 std::vector<PatchPoint> ConicSubdivider::extractPatch(const Curve &curve,
                                                       const int pIdx,
                                                       const int maxPatchSize) const {
-    const auto &verts = curve.getVertices();
-    const auto &normals = curve.getNormals();
-    std::vector<PatchPoint> patchPoints;
-    patchPoints.reserve(4);
+    PatchPoints<real_t> patchPoints(resource_);
+    extractCurvePatch(curve, pIdx, maxPatchSize, patchPoints);
+    return {patchPoints.begin(), patchPoints.end()};
+}
+
+template<typename CurveT>
+void ConicSubdivider::extractCurvePatch(const CurveT &curve,
+                                        const int pIdx,
+                                        const int maxPatchSize,
+                                        PatchPoints<CurveScalar<CurveT>> &patchPoints) const {
+    using S = CurveScalar<CurveT>;
+    const S middlePointWeight = settingAs<S>(settings_.middlePointWeight);
+    const S middleNormalWeight = settingAs<S>(settings_.middleNormalWeight);
+    const S outerPointWeight = settingAs<S>(settings_.outerPointWeight);
+    const S outerNormalWeight = settingAs<S>(settings_.outerNormalWeight);
+    patchPoints.clear();
     const int n = curve.numPoints();
     // Left middle
     const int leftMiddleIdx = pIdx;
     const bool leftInflPoint = std::find(inflPointIndices_.begin(), inflPointIndices_.end(), leftMiddleIdx) !=
                                inflPointIndices_.end();
-    patchPoints.emplace_back(verts[leftMiddleIdx],
-                             normals[leftMiddleIdx],
-                             settings_.middlePointWeight,
-                             settings_.middleNormalWeight);
+    // Compact curves return their vertices by value, so the ones used for every outer point are kept here
+    const Vector2<S> leftMiddle = curve.getVertex(leftMiddleIdx);
+    patchPoints.emplace_back(leftMiddle,
+                             curve.getNormal(leftMiddleIdx),
+                             middlePointWeight,
+                             middleNormalWeight);
 
     // Right middle
     const int rightMiddleIdx = curve.getNextIdx(pIdx);
     const bool rightInflPoint = std::find(inflPointIndices_.begin(), inflPointIndices_.end(), rightMiddleIdx) !=
                                 inflPointIndices_.end();
-    patchPoints.emplace_back(verts[rightMiddleIdx],
-                             normals[rightMiddleIdx],
-                             settings_.middlePointWeight,
-                             settings_.middleNormalWeight);
+    const Vector2<S> rightMiddle = curve.getVertex(rightMiddleIdx);
+    patchPoints.emplace_back(rightMiddle,
+                             curve.getNormal(rightMiddleIdx),
+                             middlePointWeight,
+                             middleNormalWeight);
 
     if (curve.isClosed()) {
         if (!leftInflPoint) {
             const int leftOuterIdx = curve.getPrevIdx(leftMiddleIdx);
+            const Vector2<S> leftOuter = curve.getVertex(leftOuterIdx);
             for (int i = 1; i < maxPatchSize; ++i) {
                 const int idx = (leftMiddleIdx - i + n) % n;
-                if (!areInSameHalfPlane(verts[leftMiddleIdx], verts[rightMiddleIdx], verts[leftOuterIdx], verts[idx])) {
+                if (!areInSameHalfPlane(leftMiddle, rightMiddle, leftOuter, curve.getVertex(idx))) {
                     break;
                 }
-                patchPoints.emplace_back(verts[idx],
-                                         normals[idx],
-                                         settings_.outerPointWeight,
-                                         settings_.outerNormalWeight);
+                patchPoints.emplace_back(curve.getVertex(idx),
+                                         curve.getNormal(idx),
+                                         outerPointWeight,
+                                         outerNormalWeight);
             }
         }
         if (!rightInflPoint) {
-            int rightOuterIdx = curve.getNextIdx(rightMiddleIdx);
+            const int rightOuterIdx = curve.getNextIdx(rightMiddleIdx);
+            const Vector2<S> rightOuter = curve.getVertex(rightOuterIdx);
             for (int i = 1; i < maxPatchSize; ++i) {
                 const int idx = (rightMiddleIdx + i) % n;
-                if (!areInSameHalfPlane(verts[leftMiddleIdx],
-                                        verts[rightMiddleIdx],
-                                        verts[rightOuterIdx],
-                                        verts[idx])) {
+                if (!areInSameHalfPlane(leftMiddle, rightMiddle, rightOuter, curve.getVertex(idx))) {
                     break;
                 }
-                patchPoints.emplace_back(verts[idx],
-                                         normals[idx],
-                                         settings_.outerPointWeight,
-                                         settings_.outerNormalWeight);
+                patchPoints.emplace_back(curve.getVertex(idx),
+                                         curve.getNormal(idx),
+                                         outerPointWeight,
+                                         outerNormalWeight);
             }
         }
     } else {
         if (!leftInflPoint) {
             const int leftOuterIdx = curve.getPrevIdx(leftMiddleIdx);
+            const Vector2<S> leftOuter = curve.getVertex(leftOuterIdx);
             for (int i = 1; i < maxPatchSize; ++i) {
                 const int idx = leftMiddleIdx - i;
                 if (idx < 0 || leftOuterIdx < 0) {
                     break;
                 }
-                if (!areInSameHalfPlane(verts[leftMiddleIdx], verts[rightMiddleIdx], verts[leftOuterIdx], verts[idx])) {
+                if (!areInSameHalfPlane(leftMiddle, rightMiddle, leftOuter, curve.getVertex(idx))) {
                     break;
                 }
-                patchPoints.emplace_back(verts[idx],
-                                         normals[idx],
-                                         settings_.outerPointWeight,
-                                         settings_.outerNormalWeight);
+                patchPoints.emplace_back(curve.getVertex(idx),
+                                         curve.getNormal(idx),
+                                         outerPointWeight,
+                                         outerNormalWeight);
             }
         }
         if (!rightInflPoint) {
             const int rightOuterIdx = curve.getNextIdx(rightMiddleIdx);
+            const Vector2<S> rightOuter = curve.getVertex(rightOuterIdx);
             for (int i = 1; i < maxPatchSize; ++i) {
                 const int idx = rightMiddleIdx + i;
                 if (idx >= n || rightOuterIdx >= n) {
                     break;
                 }
-                if (!areInSameHalfPlane(verts[leftMiddleIdx],
-                                        verts[rightMiddleIdx],
-                                        verts[rightOuterIdx],
-                                        verts[idx])) {
+                if (!areInSameHalfPlane(leftMiddle, rightMiddle, rightOuter, curve.getVertex(idx))) {
                     break;
                 }
-                patchPoints.emplace_back(verts[idx],
-                                         normals[idx],
-                                         settings_.outerPointWeight,
-                                         settings_.outerNormalWeight);
+                patchPoints.emplace_back(curve.getVertex(idx),
+                                         curve.getNormal(idx),
+                                         outerPointWeight,
+                                         outerNormalWeight);
             }
         }
     }
-    return patchPoints;
 }
 
-bool ConicSubdivider::areInSameHalfPlane(const Vector2DD &v0,
-                                         const Vector2DD &v1,
-                                         const Vector2DD &v2,
-                                         const Vector2DD &v3) const {
-    const Vector2DD v1v3 = v3 - v1;
-    const Vector2DD v1v0 = v0 - v1;
-    if (v1v0.squaredNorm() < settings_.epsilon || v1v3.squaredNorm() < settings_.epsilon) {
+/*
+ * Double precision version of ConicSubdivider::areInSameHalfPlane.
+ * Returns an empty optional when one of the comparisons cannot be decided with certainty.
+ */
+CONIS_DISPATCH static std::optional<bool> filteredSameHalfPlane(const Vector2DD &v0,
+                                                                const Vector2DD &v1,
+                                                                const Vector2DD &v2,
+                                                                const Vector2DD &v3,
+                                                                const real_t eps) {
+    if (v2 == v3) {
+        // The first dot product below is exactly zero. This happens for the first point of every patch extension.
+        return true;
+    }
+    const FilteredValue epsilon(eps);
+    const FilteredValue x0(v0.x()), y0(v0.y());
+    const FilteredValue x1(v1.x()), y1(v1.y());
+    const FilteredValue x2(v2.x()), y2(v2.y());
+    const FilteredValue x3(v3.x()), y3(v3.y());
+
+    const FilteredValue v1v3x = x3 - x1;
+    const FilteredValue v1v3y = y3 - y1;
+    const FilteredValue v1v0x = x0 - x1;
+    const FilteredValue v1v0y = y0 - y1;
+    const FilteredValue sqNorm13 = v1v3x * v1v3x + v1v3y * v1v3y;
+    const FilteredValue sqNorm10 = v1v0x * v1v0x + v1v0y * v1v0y;
+    if (sqNorm10.certainlyAbsBelow(epsilon) || sqNorm13.certainlyAbsBelow(epsilon)) {
+        return true;
+    }
+    if (!sqNorm10.certainlyAbsAtLeast(epsilon) || !sqNorm13.certainlyAbsAtLeast(epsilon)) {
+        return std::nullopt;
+    }
+    const FilteredValue normalX = y2 - y1;
+    const FilteredValue normalY = x1 - x2;
+    const FilteredValue dotProduct1 = normalX * v1v3x + normalY * v1v3y;
+    const FilteredValue dotProduct2 = normalX * v1v0x + normalY * v1v0y;
+    if (dotProduct1.certainlyAbsBelow(epsilon) || dotProduct2.certainlyAbsBelow(epsilon)) {
+        return true;
+    }
+    if (!dotProduct1.certainlyAbsAtLeast(epsilon) || !dotProduct2.certainlyAbsAtLeast(epsilon)) {
+        return std::nullopt;
+    }
+    // Both are bounded away from zero, so their signs are certain
+    return dotProduct1.certainlyPositive() == dotProduct2.certainlyPositive();
+}
+
+template<typename S>
+bool ConicSubdivider::areInSameHalfPlane(const Vector2<S> &v0,
+                                         const Vector2<S> &v1,
+                                         const Vector2<S> &v2,
+                                         const Vector2<S> &v3) const {
+#ifdef FILTERED_CONIC_PRECISION
+    if constexpr (std::is_same_v<S, real_t> && useFilteredPrecision) {
+        if (const std::optional<bool> sameHalfPlane = filteredSameHalfPlane(v0, v1, v2, v3, settings_.epsilon)) {
+            precisionStats().halfPlaneFast.fetch_add(1, std::memory_order_relaxed);
+            return *sameHalfPlane;
+        }
+        precisionStats().halfPlaneFallback.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    const S epsilon = settingAs<S>(settings_.epsilon);
+    const Vector2<S> v1v3 = v3 - v1;
+    const Vector2<S> v1v0 = v0 - v1;
+    if (v1v0.squaredNorm() < epsilon || v1v3.squaredNorm() < epsilon) {
         return true; // End point edge case
     }
-    const Vector2DD normal = Vector2DD(v2.y() - v1.y(), v1.x() - v2.x());
-    const real_t dotProduct1 = normal.dot(v1v3);
-    const real_t dotProduct2 = normal.dot(v1v0);
-    if (std::abs(dotProduct1) < settings_.epsilon || std::abs(dotProduct2) < settings_.epsilon) {
+    const Vector2<S> normal = Vector2<S>(v2.y() - v1.y(), v1.x() - v2.x());
+    const S dotProduct1 = normal.dot(v1v3);
+    const S dotProduct2 = normal.dot(v1v0);
+    if (abs(dotProduct1) < epsilon || abs(dotProduct2) < epsilon) {
         return true; // curve is flat
     }
-    const real_t sign = dotProduct1 > 0 ? 1.0 : -1.0;
+    const S sign = dotProduct1 > 0 ? 1.0 : -1.0;
     return dotProduct2 * sign >= 0;
 }
 
-void ConicSubdivider::insertInflPoints(const Curve &curve, Curve &targetCurve) {
-    targetCurve.setClosed(curve.isClosed(), false);
+template<typename CurveT>
+void ConicSubdivider::insertInflPoints(const CurveT &curve, CurveT &targetCurve) {
+    using S = CurveScalar<CurveT>;
+    // Only Curve keeps track of the custom normals
+    constexpr bool hasCustomNormals = std::is_same_v<CurveT, Curve>;
+    if constexpr (hasCustomNormals) {
+        targetCurve.setClosed(curve.isClosed(), false);
+    } else {
+        targetCurve.setClosed(curve.isClosed());
+    }
     // Setup
     const int n = int(curve.numPoints());
     inflPointIndices_.clear();
     inflPointIndices_.reserve(n);
-    auto &verts = targetCurve.getVertices();
-    auto &normals = targetCurve.getNormals();
-    auto &customNormals = targetCurve.getCustomNormals();
-    verts.clear();
-    normals.clear();
-    customNormals.clear();
+    const auto addPoint = [&targetCurve](const Vector2<S> &vertex, const Vector2<S> &normal, const bool customNormal) {
+        if constexpr (hasCustomNormals) {
+            targetCurve.getVertices().emplace_back(vertex);
+            targetCurve.getNormals().emplace_back(normal);
+            targetCurve.getCustomNormals().emplace_back(customNormal);
+        } else {
+            targetCurve.addPoint(vertex, normal);
+        }
+    };
+    if constexpr (hasCustomNormals) {
+        targetCurve.getVertices().clear();
+        targetCurve.getNormals().clear();
+        targetCurve.getCustomNormals().clear();
+    } else {
+        targetCurve.clear();
+    }
 
     int idx = 0;
     // For all points
     for (int i = 0; i < n; i++) {
         const int nextIdx = curve.getNextIdx(i);
-        const Vector2DD &v0 = curve.getVertex(curve.getPrevIdx(i));
-        const Vector2DD &v1 = curve.getVertex(i);
-        const Vector2DD &v2 = curve.getVertex(nextIdx);
-        const Vector2DD &v3 = curve.getVertex(curve.getNextIdx(nextIdx));
+        const Vector2<S> v0 = curve.getVertex(curve.getPrevIdx(i));
+        const Vector2<S> v1 = curve.getVertex(i);
+        const Vector2<S> v2 = curve.getVertex(nextIdx);
+        const Vector2<S> v3 = curve.getVertex(curve.getNextIdx(nextIdx));
 
         // Insert original point and normal
-        verts.emplace_back(v1);
-        normals.emplace_back(curve.getNormal(i));
-        customNormals.emplace_back(curve.isCustomNormal(i));
+        if constexpr (hasCustomNormals) {
+            addPoint(v1, curve.getNormal(i), curve.isCustomNormal(i));
+        } else {
+            addPoint(v1, curve.getNormal(i), false);
+        }
         idx++;
         // For non-closed curves or when there are not enough points (<= 2)
         if (v0 == v1 || v2 == v3 || v1 == v2) {
@@ -269,17 +568,17 @@ void ConicSubdivider::insertInflPoints(const Curve &curve, Curve &targetCurve) {
 
         // Insert an inflection point
         if (!areInSameHalfPlane(v0, v1, v2, v3)) {
-            const Vector2DD v0v1 = (v0 - v1).normalized();
-            const Vector2DD v1v2 = (v1 - v2).normalized();
-            const Vector2DD v3v2 = (v3 - v2).normalized();
-            const Vector2DD orthogonalV1V2 = {-v1v2.y(), v1v2.x()};
+            const Vector2<S> v0v1 = (v0 - v1).normalized();
+            const Vector2<S> v1v2 = (v1 - v2).normalized();
+            const Vector2<S> v3v2 = (v3 - v2).normalized();
+            const Vector2<S> orthogonalV1V2 = {-v1v2.y(), v1v2.x()};
 
-            real_t ratio = 0.5;
+            S ratio = 0.5;
             if (settings_.weightedInflPointLocation) {
-                const real_t dot1 = (v0 - v1).normalized().dot((v1 - v2).normalized());
-                const real_t dot2 = (v3 - v2).normalized().dot((v2 - v1).normalized());
-                const real_t l1 = std::abs(std::acos(dot1));
-                const real_t l2 = std::abs(std::acos(dot2));
+                const S dot1 = (v0 - v1).normalized().dot((v1 - v2).normalized());
+                const S dot2 = (v3 - v2).normalized().dot((v2 - v1).normalized());
+                const S l1 = abs(inflAcos(dot1, settings_.fastMath));
+                const S l2 = abs(inflAcos(dot2, settings_.fastMath));
                 if (settings_.gravitateSmallerAngles) {
                     ratio = l1 / (l1 + l2);
                 } else {
@@ -287,16 +586,14 @@ void ConicSubdivider::insertInflPoints(const Curve &curve, Curve &targetCurve) {
                 }
             }
 
-            auto [inflNormalLeft, leftAngle] = inflNormal(v0v1, -v1v2, orthogonalV1V2);
-            auto [inflNormalRight, rightAngle] = inflNormal(v3v2, v1v2, orthogonalV1V2);
+            auto [inflNormalLeft, leftAngle] = inflNormal<S>(v0v1, -v1v2, orthogonalV1V2);
+            auto [inflNormalRight, rightAngle] = inflNormal<S>(v3v2, v1v2, orthogonalV1V2);
             // The location is the midpoint of the edge
-            const Vector2DD midPoint = mix(v1, v2, ratio);
+            const Vector2<S> midPoint = mix(v1, v2, ratio);
             // The normal is the normal of either of the edge point normals resulting in the least curvature change (i.e. the flattest curve)
-            const Vector2DD inflNormal = leftAngle < rightAngle ? inflNormalLeft : inflNormalRight;
+            const Vector2<S> inflNormal = leftAngle < rightAngle ? inflNormalLeft : inflNormalRight;
             // save
-            verts.emplace_back(midPoint);
-            normals.emplace_back(inflNormal);
-            customNormals.emplace_back(true);
+            addPoint(midPoint, inflNormal, true);
             inflPointIndices_.push_back(idx);
             idx++;
             // std::cout << "Inserting inflection point" << std::endl;
@@ -310,32 +607,38 @@ Curve ConicSubdivider::getInflPointCurve(const Curve &curve) {
     return inflCurve;
 }
 
-std::pair<Vector2DD, real_t> ConicSubdivider::inflNormal(const Vector2DD &edgeAB,
-                                                         const Vector2DD &edgeBC,
-                                                         const Vector2DD &orthogonal) const {
+template<typename S>
+std::pair<Vector2<S>, S> ConicSubdivider::inflNormal(const Vector2<S> &edgeAB,
+                                                     const Vector2<S> &edgeBC,
+                                                     const Vector2<S> &orthogonal) const {
     // angle is between pi and 0
-    const real_t angle = std::acos(edgeAB.normalized().dot(edgeBC.normalized()));
+    const S cosAngle = edgeAB.normalized().dot(edgeBC.normalized());
+    const S angle = inflAcos(cosAngle, settings_.fastMath);
     //               angle  / M_PI        is between 1 and 0
     //               angle  / M_PI - 0.5  is between 0.5 and -0.5
     //      std::abs(angle) / M_PI - 0.5) is between 0.5 and 0
     // 0.5  std::abs(angle) / M_PI - 0.5) is between 0 and 0.5
-    const real_t gamma = 0.5 - std::abs(angle / M_PI - 0.5);
+    const S gamma = 0.5 - abs(angle / M_PI - 0.5);
     // Set the normal in the correct direction to ensure the inflection normal makes the correct angle
     const auto reflectFlatNormal = edgeAB.dot(orthogonal) < 0 ? edgeBC : -edgeBC;
     // linear blend, gamma is in the range [0,0.5]
-    Vector2DD normal = mix(orthogonal, reflectFlatNormal, gamma).normalized();
+    Vector2<S> normal = mix<Vector2<S>>(orthogonal, reflectFlatNormal, gamma).normalized();
 
     // Make sure we use the orthogonal vector pointing in the same general direction as the normal
-    const Vector2DD correctedOrtho = normal.dot(orthogonal) < 0 ? -orthogonal : orthogonal;
+    const Vector2<S> correctedOrtho = normal.dot(orthogonal) < 0 ? Vector2<S>(-orthogonal) : orthogonal;
     if (settings_.areaWeightedNormals) {
         // Mix between the orthogonal vector and the found normal depending on the length ratio between the edges.
         // This ensures a flatter curve when one edge is disproportionally large compared to the other
-        const real_t lr = std::abs(edgeAB.norm() / (edgeAB.norm() + edgeBC.norm()) - 0.5) * 2;
+        const S lr = abs(edgeAB.norm() / (edgeAB.norm() + edgeBC.norm()) - 0.5) * 2;
         normal = mix(normal, correctedOrtho, lr);
     }
     // The angle the normal makes with the orthogonal vector
-    const real_t angleOrtho = std::abs(std::acos(normal.dot(correctedOrtho)));
+    const S cosAngleOrtho = normal.dot(correctedOrtho);
+    const S angleOrtho = abs(inflAcos(cosAngleOrtho, settings_.fastMath));
     return {normal, angleOrtho};
 }
 
+template void ConicSubdivider::subdivide(const Curve &curve, int level, CompactCurve<double> &result);
+template void ConicSubdivider::subdivide(const Curve &curve, int level, CompactCurve<float> &result);
+
 } // namespace conis::core
@@ -0,0 +1,123 @@
+#include "conis/core/jobs/jobsystem.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "conis/core/log.hpp"
+
+namespace conis::core {
+
+void JobHandle::cancel() const {
+    if (state_) {
+        state_->token.cancel();
+    }
+}
+
+bool JobHandle::isCancelled() const {
+    return state_ && state_->token.isCancelled();
+}
+
+bool JobHandle::isDone() const {
+    if (!state_) {
+        return true;
+    }
+    std::lock_guard lock(state_->mutex);
+    return state_->done;
+}
+
+void JobHandle::wait() const {
+    if (!state_) {
+        return;
+    }
+    std::unique_lock lock(state_->mutex);
+    state_->finished.wait(lock, [&] { return state_->done; });
+}
+
+JobSystem::JobSystem(const int numThreads) {
+    workers_.reserve(std::max(numThreads, 1));
+    for (int i = 0; i < std::max(numThreads, 1); i++) {
+        workers_.emplace_back(&JobSystem::run, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+        // The pending jobs are still completed (as cancelled), so that nobody waits for them forever
+        for (auto &queue: queues_) {
+            for (auto &queued: queue) {
+                queued.state->token.cancel();
+            }
+        }
+    }
+    jobAdded_.notify_all();
+    for (auto &worker: workers_) {
+        worker.join();
+    }
+}
+
+JobHandle JobSystem::submit(Job job, const JobPriority priority, JobCompletion onComplete) {
+    auto state = std::make_shared<JobHandle::State>();
+    {
+        std::lock_guard lock(mutex_);
+        if (stop_) {
+            // The workers may already have exited, so the job is discarded rather than queued
+            state->token.cancel();
+            state->done = true;
+            return JobHandle(state);
+        }
+        queues_[priority].push_back({std::move(job), std::move(onComplete), state});
+    }
+    jobAdded_.notify_one();
+    return JobHandle(state);
+}
+
+void JobSystem::run() {
+    while (true) {
+        QueuedJob queued;
+        {
+            std::unique_lock lock(mutex_);
+            jobAdded_.wait(lock, [&] {
+                return stop_ || std::any_of(std::begin(queues_), std::end(queues_), [](const auto &queue) {
+                           return !queue.empty();
+                       });
+            });
+            const auto queue = std::find_if(std::begin(queues_), std::end(queues_), [](const auto &queue) {
+                return !queue.empty();
+            });
+            if (queue == std::end(queues_)) {
+                // Stopped and no jobs left
+                return;
+            }
+            queued = std::move(queue->front());
+            queue->pop_front();
+        }
+        const CancellationToken &token = queued.state->token;
+        // Jobs cancelled while they were pending are not started at all
+        if (!token.isCancelled()) {
+            try {
+                queued.job(token);
+            } catch (const std::exception &e) {
+                CONIS_LOG(LOG_ERROR, "Job failed: " << e.what());
+            } catch (...) {
+                CONIS_LOG(LOG_ERROR, "Job failed with an unknown exception");
+            }
+        }
+        if (queued.onComplete) {
+            queued.onComplete(token.isCancelled());
+        }
+        {
+            std::lock_guard lock(queued.state->mutex);
+            queued.state->done = true;
+        }
+        queued.state->finished.notify_all();
+    }
+}
+
+JobSystem &jobSystem() {
+    static JobSystem system(std::max(static_cast<int>(std::thread::hardware_concurrency()), 2));
+    return system;
+}
+
+} // namespace conis::core
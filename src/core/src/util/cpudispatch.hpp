@@ -0,0 +1,23 @@
+#pragma once
+
+// The hot kernels are compiled for several x86-64 ISA levels: baseline, SSE4.2 (v2), AVX2 + FMA (v3) and AVX-512 (v4).
+// The best supported version is selected once at load time through an ifunc resolver.
+// CONIS_RUNTIME_DISPATCH is set by CMake unless the library is built for the native architecture.
+#if defined(CONIS_RUNTIME_DISPATCH) && defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && \
+    defined(__linux__)
+#define CONIS_DISPATCH_TARGETS "default", "arch=x86-64-v2", "arch=x86-64-v3", "arch=x86-64-v4"
+#define CONIS_DISPATCH __attribute__((target_clones(CONIS_DISPATCH_TARGETS)))
+// Also inlines all callees, so that library code (e.g. Eigen's SVD) is compiled for every ISA level as well
+#define CONIS_DISPATCH_FLATTEN __attribute__((flatten, target_clones(CONIS_DISPATCH_TARGETS)))
+#else
+#define CONIS_DISPATCH
+#define CONIS_DISPATCH_FLATTEN
+#endif
+
+// Kernels on real_t are only dispatched when it is double: the extended precision types do not use SIMD, so they would
+// only gain code size
+#ifdef CONIS_SCALAR_DOUBLE
+#define CONIS_DISPATCH_REAL CONIS_DISPATCH
+#else
+#define CONIS_DISPATCH_REAL
+#endif
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+
+/*
+ * Approximations of the transcendental functions used in the inner loops of the subdivision, curvature and normal
+ * refinement code. They are used instead of the (long double) libm functions when SubdivisionSettings::fastMath is set.
+ *
+ * All functions are evaluated in double precision using range reduction followed by a polynomial, without calls into
+ * libm (sqrt compiles to a single instruction). As such, they can be inlined and vectorised. The results are converted
+ * back to the input type, so for extended precision types the result is only accurate up to double precision.
+ *
+ * Maximum errors, measured over the documented input ranges (see test/scalar/fastmath_test.cpp):
+ *  - sin, cos: 2e-16 absolute for |x| <= 1e5
+ *  - tan:      4 ulp for |x| <= pi / 4
+ *  - atan:     4 ulp for all x
+ *  - acos:     7e-16 absolute for |x| <= 1. Inputs outside of [-1, 1] result in NaN, like std::acos.
+ */
+namespace conis::core::fastmath {
+
+namespace detail {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double twoOverPi = 0.63661977236758134308;
+// pi / 2 split into its first 33 bits and the remainder (Cody-Waite), so that k * halfPi1 is exact for |k| < 2^20
+constexpr double halfPi1 = 1.57079632673412561417e+00;
+constexpr double halfPi2 = 6.07710050650619224932e-11;
+// 1.5 * 2^52; adding and subtracting this rounds a double to the nearest integer
+constexpr double roundMagic = 6755399441055744.0;
+constexpr double tanPiOver12 = 0.26794919243112270647;
+constexpr double sqrt3 = 1.73205080756887729353;
+
+// Taylor polynomials on [-pi / 4, pi / 4]. The truncation error is below 5e-17.
+inline double sinPoly(const double r) {
+    const double r2 = r * r;
+    const double p =
+        -1.0 / 6.0 +
+        r2 * (1.0 / 120.0 +
+              r2 * (-1.0 / 5040.0 +
+                    r2 * (1.0 / 362880.0 +
+                          r2 * (-1.0 / 39916800.0 + r2 * (1.0 / 6227020800.0 + r2 * (-1.0 / 1307674368000.0))))));
+    return r + r * r2 * p;
+}
+
+inline double cosPoly(const double r) {
+    const double r2 = r * r;
+    const double p =
+        1.0 / 24.0 +
+        r2 * (-1.0 / 720.0 +
+              r2 * (1.0 / 40320.0 +
+                    r2 * (-1.0 / 3628800.0 +
+                          r2 * (1.0 / 479001600.0 + r2 * (-1.0 / 87178291200.0 + r2 * (1.0 / 20922789888000.0))))));
+    return 1.0 - 0.5 * r2 + r2 * r2 * p;
+}
+
+// Taylor polynomial on [-tan(pi / 12), tan(pi / 12)]. The truncation error is below 2e-17.
+inline double atanPoly(const double z) {
+    const double z2 = z * z;
+    // z - z^3 / 3 + z^5 / 5 - ... + z^25 / 25 using Horner's scheme in z^2
+    double p = 1.0 / 25.0;
+    p = 1.0 / 23.0 - z2 * p;
+    p = 1.0 / 21.0 - z2 * p;
+    p = 1.0 / 19.0 - z2 * p;
+    p = 1.0 / 17.0 - z2 * p;
+    p = 1.0 / 15.0 - z2 * p;
+    p = 1.0 / 13.0 - z2 * p;
+    p = 1.0 / 11.0 - z2 * p;
+    p = 1.0 / 9.0 - z2 * p;
+    p = 1.0 / 7.0 - z2 * p;
+    p = 1.0 / 5.0 - z2 * p;
+    p = 1.0 / 3.0 - z2 * p;
+    return z - z * z2 * p;
+}
+
+/**
+ * @brief Computes the sine and cosine of x at the same time.
+ */
+inline void sinCos(const double x, double &s, double &c) {
+    const double k = (x * twoOverPi + roundMagic) - roundMagic;
+    const double r = (x - k * halfPi1) - k * halfPi2;
+    const int quadrant = static_cast<int>(k) & 3;
+    const double sr = sinPoly(r);
+    const double cr = cosPoly(r);
+    // sin(r + k * pi / 2) and cos(r + k * pi / 2) per quadrant
+    s = (quadrant & 1) ? cr : sr;
+    c = (quadrant & 1) ? sr : cr;
+    s = (quadrant & 2) ? -s : s;
+    c = ((quadrant + 1) & 2) ? -c : c;
+}
+
+inline double atan(const double x) {
+    const double ax = std::abs(x);
+    // atan(x) = pi / 2 - atan(1 / x)
+    const bool inverted = ax > 1.0;
+    double y = inverted ? 1.0 / ax : ax;
+    // atan(y) = pi / 6 + atan((y * sqrt(3) - 1) / (y + sqrt(3)))
+    const bool shifted = y > tanPiOver12;
+    y = shifted ? (y * sqrt3 - 1.0) / (y + sqrt3) : y;
+    double result = atanPoly(y) + (shifted ? pi / 6.0 : 0.0);
+    result = inverted ? pi / 2.0 - result : result;
+    return std::copysign(result, x);
+}
+
+} // namespace detail
+
+template<typename S>
+S sin(const S x) {
+    double s, c;
+    detail::sinCos(static_cast<double>(x), s, c);
+    return static_cast<S>(s);
+}
+
+template<typename S>
+S cos(const S x) {
+    double s, c;
+    detail::sinCos(static_cast<double>(x), s, c);
+    return static_cast<S>(c);
+}
+
+template<typename S>
+S tan(const S x) {
+    double s, c;
+    detail::sinCos(static_cast<double>(x), s, c);
+    return static_cast<S>(s / c);
+}
+
+template<typename S>
+S atan(const S x) {
+    return static_cast<S>(detail::atan(static_cast<double>(x)));
+}
+
+template<typename S>
+S acos(const S x) {
+    // acos(x) = 2 * atan(sqrt((1 - x) / (1 + x))). Both 1 - x and 1 + x are exact where they matter (Sterbenz).
+    const double xd = static_cast<double>(x);
+    return static_cast<S>(2.0 * detail::atan(std::sqrt((1.0 - xd) / (1.0 + xd))));
+}
+
+} // namespace conis::core::fastmath
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "conis/core/precisionstats.hpp"
+#include "conis/core/vector.hpp"
+
+namespace conis::core {
+
+// Filtering only pays off when real_t is more expensive than double
+constexpr bool useFilteredPrecision = !std::is_same_v<real_t, double>;
+
+/**
+ * A value evaluated in double precision together with an upper bound on its absolute error with respect to the exact
+ * result. Every operation propagates the bound (running error analysis), so that a comparison can be decided in double
+ * precision whenever the value is far enough away from the threshold. Otherwise, the caller falls back to real_t.
+ *
+ * Each rounding is accounted for with DBL_EPSILON instead of the unit round-off and every product adds the smallest
+ * subnormal for underflow. This over-estimates the error by a factor two, which also covers the rounding errors made
+ * while computing the bound itself. Overflow results in an infinite or NaN bound, which never certifies anything.
+ */
+class FilteredValue {
+public:
+    constexpr FilteredValue(const double value, const double error) : value_(value), error_(error) {}
+
+    explicit FilteredValue(const real_t &value)
+        : value_(static_cast<double>(value)),
+          error_(std::abs(value_) * std::numeric_limits<double>::epsilon()) {}
+
+    [[nodiscard]] double value() const { return value_; }
+    [[nodiscard]] double error() const { return error_; }
+
+    FilteredValue operator-() const { return {-value_, error_}; }
+
+    friend FilteredValue operator+(const FilteredValue &a, const FilteredValue &b) {
+        const double sum = a.value_ + b.value_;
+        return {sum, a.error_ + b.error_ + std::abs(sum) * unitError};
+    }
+
+    friend FilteredValue operator-(const FilteredValue &a, const FilteredValue &b) { return a + (-b); }
+
+    friend FilteredValue operator*(const FilteredValue &a, const FilteredValue &b) {
+        const double product = a.value_ * b.value_;
+        return {product,
+                std::abs(a.value_) * b.error_ + std::abs(b.value_) * a.error_ + a.error_ * b.error_ +
+                    std::abs(product) * unitError + std::numeric_limits<double>::denorm_min()};
+    }
+
+    // The exact value is guaranteed to be positive
+    [[nodiscard]] bool certainlyPositive() const { return value_ - error_ > 0.0; }
+    // The exact value is guaranteed to be negative
+    [[nodiscard]] bool certainlyNegative() const { return value_ + error_ < 0.0; }
+    // The exact absolute value is guaranteed to be smaller than the threshold
+    [[nodiscard]] bool certainlyAbsBelow(const FilteredValue &threshold) const {
+        return std::abs(value_) + error_ + threshold.error_ < threshold.value_;
+    }
+    // The exact absolute value is guaranteed to be larger than or equal to the threshold
+    [[nodiscard]] bool certainlyAbsAtLeast(const FilteredValue &threshold) const {
+        return std::abs(value_) - error_ - threshold.error_ > threshold.value_;
+    }
+
+private:
+    static constexpr double unitError = std::numeric_limits<double>::epsilon();
+
+    double value_;
+    double error_;
+};
+
+} // namespace conis::core
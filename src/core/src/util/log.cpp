@@ -0,0 +1,161 @@
+#include "conis/core/log.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace conis::core {
+
+namespace {
+
+const char *levelName(const LogLevel level) {
+    switch (level) {
+        case LOG_TRACE:
+            return "trace";
+        case LOG_DEBUG:
+            return "debug";
+        case LOG_INFO:
+            return "info";
+        case LOG_WARNING:
+            return "warning";
+        case LOG_ERROR:
+            return "error";
+        default:
+            return "";
+    }
+}
+
+void defaultSink(const LogLevel level, const std::string &message) {
+    // No std::endl: the stream is only flushed by flushLog or when its buffer is full
+    std::clog << "[" << levelName(level) << "] " << message << '\n';
+}
+
+/*
+ * The messages are queued and written by a single background thread, so that logging in a hot loop only costs the
+ * formatting and a short critical section. The thread is started by the first message and stopped (after writing the
+ * remaining messages) when the program exits.
+ */
+class LogQueue {
+public:
+    ~LogQueue() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        messageAdded_.notify_one();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    void push(const LogLevel level, std::string message) {
+        {
+            std::lock_guard lock(mutex_);
+            if (!worker_.joinable()) {
+                worker_ = std::thread(&LogQueue::run, this);
+            }
+            pending_.emplace_back(level, std::move(message));
+            numQueued_++;
+        }
+        messageAdded_.notify_one();
+    }
+
+    void flush() {
+        std::unique_lock lock(mutex_);
+        const uint64_t target = numQueued_;
+        messagesWritten_.wait(lock, [&] { return numWritten_ >= target; });
+        if (!sink_) {
+            std::clog.flush();
+        }
+    }
+
+    void setSink(LogSink sink) {
+        flush();
+        std::lock_guard lock(mutex_);
+        sink_ = std::move(sink);
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable messageAdded_;
+    std::condition_variable messagesWritten_;
+    std::vector<std::pair<LogLevel, std::string>> pending_;
+    uint64_t numQueued_ = 0;
+    uint64_t numWritten_ = 0;
+    LogSink sink_;
+    bool stop_ = false;
+    std::thread worker_;
+
+    void run() {
+        std::vector<std::pair<LogLevel, std::string>> batch;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            messageAdded_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                // Stopped and everything has been written
+                break;
+            }
+            batch.swap(pending_);
+            // The sink can only be replaced between batches (see setSink)
+            const LogSink sink = sink_;
+            lock.unlock();
+            for (const auto &[level, message]: batch) {
+                if (sink) {
+                    sink(level, message);
+                } else {
+                    defaultSink(level, message);
+                }
+            }
+            lock.lock();
+            numWritten_ += batch.size();
+            batch.clear();
+            messagesWritten_.notify_all();
+        }
+        if (!sink_) {
+            std::clog.flush();
+        }
+    }
+};
+
+std::atomic<int> minLevel{LOG_INFO};
+
+LogQueue &logQueue() {
+    static LogQueue queue;
+    return queue;
+}
+
+} // namespace
+
+void setLogLevel(const LogLevel level) {
+    minLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel logLevel() {
+    return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed));
+}
+
+bool logEnabled(const LogLevel level) {
+    return level != LOG_OFF && level >= minLevel.load(std::memory_order_relaxed);
+}
+
+void setLogSink(LogSink sink) {
+    logQueue().setSink(std::move(sink));
+}
+
+void logMessage(const LogLevel level, std::string message) {
+    if (!logEnabled(level)) {
+        return;
+    }
+    logQueue().push(level, std::move(message));
+}
+
+void flushLog() {
+    logQueue().flush();
+}
+
+} // namespace conis::core
@@ -0,0 +1,49 @@
+#include "conis/core/memory.hpp"
+
+namespace conis::core {
+
+std::ostream &operator<<(std::ostream &os, const AllocationStats &stats) {
+    return os << stats.numAllocations << " allocations (" << stats.bytesAllocated << " bytes), "
+              << stats.numDeallocations << " deallocations, " << stats.bytesInUse << " bytes in use (peak "
+              << stats.peakBytesInUse << ")";
+}
+
+AllocationStats CountingResource::stats() const {
+    AllocationStats stats;
+    stats.numAllocations = numAllocations_.load(std::memory_order_relaxed);
+    stats.numDeallocations = numDeallocations_.load(std::memory_order_relaxed);
+    stats.bytesAllocated = bytesAllocated_.load(std::memory_order_relaxed);
+    stats.bytesInUse = bytesInUse_.load(std::memory_order_relaxed);
+    stats.peakBytesInUse = peakBytesInUse_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CountingResource::resetStats() {
+    numAllocations_ = 0;
+    numDeallocations_ = 0;
+    bytesAllocated_ = 0;
+    peakBytesInUse_ = bytesInUse_.load();
+}
+
+void *CountingResource::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+    void *p = upstream_->allocate(bytes, alignment);
+    numAllocations_.fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated_.fetch_add(bytes, std::memory_order_relaxed);
+    const uint64_t inUse = bytesInUse_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t peak = peakBytesInUse_.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytesInUse_.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+    return p;
+}
+
+void CountingResource::do_deallocate(void *p, const std::size_t bytes, const std::size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    numDeallocations_.fetch_add(1, std::memory_order_relaxed);
+    bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+} // namespace conis::core
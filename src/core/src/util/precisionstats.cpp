@@ -0,0 +1,17 @@
+#include "conis/core/precisionstats.hpp"
+
+namespace conis::core {
+
+void PrecisionStats::reset() {
+    halfPlaneFast = 0;
+    halfPlaneFallback = 0;
+    intersectFast = 0;
+    intersectFallback = 0;
+}
+
+PrecisionStats &precisionStats() {
+    static PrecisionStats stats;
+    return stats;
+}
+
+} // namespace conis::core
@@ -1,4 +1,5 @@
 #include "conis/core/conics/conic.hpp"
+#include "conis/core/precisionstats.hpp"
 #include "conis/core/vector.hpp"
 #include <gtest/gtest.h>
 
@@ -137,6 +138,36 @@ TEST(ConicTest, TestConicNormalParabolaAtVertex) {
     ASSERT_NEAR(expectedNormal.y(), actualNormal.normalized().y(), eps);
 }
 
+// Tests: curvature of conic
+
+TEST(ConicTest, TestCurvatureStraightLineIsZero) {
+    // Line y = x (45 degrees)
+    const Conic conic(0, 0, 0, -0.5, 0.5, 0, eps);
+    ASSERT_NEAR(conic.curvature({1, 1}), 0, eps);
+}
+
+TEST(ConicTest, TestCurvatureCircle) {
+    // Circle with radius 5 centered at origin
+    const Conic conic(1, 0, 1, 0, 0, -25, eps);
+    ASSERT_NEAR(conic.curvature({5, 0}), 0.2, eps);
+    ASSERT_NEAR(conic.curvature({-3, 4}), 0.2, eps);
+}
+
+TEST(ConicTest, TestCurvatureEllipse) {
+    // Ellipse: 4*x^2 + y^2 - 25 = 0, so with semi-axes 2.5 and 5. The curvature at the end of an axis is a / b^2.
+    const Conic conic(4, 0, 1, 0, 0, -25, eps);
+    ASSERT_NEAR(conic.curvature({2.5, 0}), 2.5 / 25.0, eps);
+    ASSERT_NEAR(conic.curvature({0, 5}), 5 / 6.25, eps);
+}
+
+TEST(ConicTest, TestCurvatureIsScaleIndependent) {
+    // Scaling the coefficients does not change the conic
+    const Conic conic(-2, 0, 0, 0, 4, 0, eps);
+    const Conic scaledConic(-1, 0, 0, 0, 2, 0, eps);
+    const Vector2DD point(2, 1);
+    ASSERT_NEAR(conic.curvature(point), scaledConic.curvature(point), eps);
+}
+
 // Tests: intersections of ray with conic
 
 TEST(ConicTest, TestIntersectsLine) {
@@ -204,6 +235,38 @@ TEST(ConicTest, TestIntersectsEdgeCaseTangent) {
     ASSERT_NEAR(t, 0, eps);                   // Expected intersection at the origin point
 }
 
+TEST(ConicTest, TestIntersectsWellConditionedUsesFastPath) {
+    // Circle with radius 5 centered at origin
+    const Conic conic(1, 0, 1, 0, 0, -25, eps);
+    const Vector2DD ro(0, -10); // Ray origin below the circle
+    const Vector2DD rd(0, 1);   // Ray direction (upward)
+    real_t t;
+
+    precisionStats().reset();
+    ASSERT_TRUE(conic.intersects(ro, rd, t));
+    ASSERT_NEAR(t, 5.0, eps);
+    if (!std::is_same_v<real_t, double>) {
+        ASSERT_EQ(precisionStats().intersectFast, 1);
+        ASSERT_EQ(precisionStats().intersectFallback, 0);
+    }
+}
+
+TEST(ConicTest, TestIntersectsTangentFallsBack) {
+    // Circle with radius 5 centered at origin; the determinant is exactly zero for a tangent ray
+    const Conic conic(1, 0, 1, 0, 0, -25, eps);
+    const Vector2DD ro(0, 5);
+    const Vector2DD rd(1, 0);
+    real_t t;
+
+    precisionStats().reset();
+    ASSERT_TRUE(conic.intersects(ro, rd, t));
+    ASSERT_NEAR(t, 0, eps);
+    if (!std::is_same_v<real_t, double>) {
+        ASSERT_EQ(precisionStats().intersectFast, 0);
+        ASSERT_EQ(precisionStats().intersectFallback, 1);
+    }
+}
+
 // Tests: Sampling of conic with ray
 TEST(ConicTest, TestSampleLine) {
     // Line y = 2
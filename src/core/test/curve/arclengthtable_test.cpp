@@ -0,0 +1,67 @@
+#include "conis/core/curve/arclengthtable.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace conis::core;
+
+// Tests: the arc-length table and the uniform resampling
+
+TEST(ArcLengthTableTest, TestLengths) {
+    // A square with sides of length 2
+    const std::vector<Vector2DD> points = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    const Curve closed(points, true);
+    const ArcLengthTable closedTable(closed);
+    ASSERT_EQ(closedTable.getLengths(), std::vector<real_t>({0, 2, 4, 6, 8}));
+    ASSERT_EQ(closedTable.positionAt(3), Vector2DD(2, 1));
+    ASSERT_EQ(closedTable.positionAt(7.5), Vector2DD(0, 0.5));
+    ASSERT_EQ(closedTable.positionAt(8), Vector2DD(0, 0));
+    ASSERT_EQ(closedTable.locate(4), std::make_pair(2, real_t(0)));
+
+    const Curve open(points, false);
+    const ArcLengthTable openTable(open);
+    ASSERT_EQ(openTable.totalLength(), 6);
+    ASSERT_EQ(openTable.positionAt(-1), Vector2DD(0, 0));
+    ASSERT_EQ(openTable.positionAt(10), Vector2DD(0, 2));
+}
+
+TEST(ArcLengthTableTest, TestParallelPrefixSum) {
+    // More than one block, so that the block offsets are added
+    auto [points, normals] = test::circle(20000, 0, 0, 5);
+    const Curve curve(points, normals, true);
+    const ArcLengthTable table(curve);
+    real_t length = 0;
+    // The blocks sum in a different order, so allow the rounding error bound of a running sum
+    const real_t tolerance = curve.numPoints() * std::numeric_limits<real_t>::epsilon();
+    for (int i = 0; i < curve.numPoints(); i++) {
+        ASSERT_NEAR(table.getLengths()[i], length, tolerance * length);
+        length += (curve.getVertex(curve.getNextIdx(i)) - curve.getVertex(i)).norm();
+    }
+    ASSERT_NEAR(table.totalLength(), 2 * M_PI * 5, 1e-5);
+}
+
+TEST(ArcLengthTableTest, TestUniformResampling) {
+    auto [points, normals] = test::ellipse(64, 0, 0, 5, 3);
+    for (const bool closed: {true, false}) {
+        const Curve curve(points, normals, closed);
+        const ArcLengthTable table(curve);
+        const real_t spacing = 0.1;
+        const int numSamples = table.numUniformSamples(spacing);
+        const Curve resampled = table.resample(spacing);
+        ASSERT_EQ(resampled.numPoints(), numSamples);
+        ASSERT_EQ(resampled.isClosed(), closed);
+        ASSERT_EQ(resampled.getVertex(0), curve.getVertex(0));
+        if (!closed) {
+            ASSERT_EQ(resampled.getVertex(numSamples - 1), curve.getVertex(curve.numPoints() - 1));
+        }
+        // The samples lie on the curve, evenly spaced along it
+        const ArcLengthTable resampledTable(resampled);
+        const int numSpaces = closed ? numSamples : numSamples - 1;
+        const real_t step = table.totalLength() / numSpaces;
+        ASSERT_NEAR(step, spacing, spacing / 100);
+        for (int i = 1; i < numSamples; i++) {
+            ASSERT_NEAR(resampledTable.getLengths()[i] - resampledTable.getLengths()[i - 1], step, 1e-3);
+        }
+    }
+}
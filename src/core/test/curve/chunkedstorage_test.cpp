@@ -0,0 +1,145 @@
+#include "conis/core/chunkedsequence.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace conis::core;
+
+// Tests: the chunked storage of Curve behaves like the contiguous arrays
+
+TEST(ChunkedSequenceTest, TestRandomEdits) {
+    std::mt19937 rng(3);
+    // Small chunks, so that chunks are split and merged often
+    ChunkedSequence<int, 8> sequence;
+    std::vector<int> expected;
+    // The id of every element, by its value
+    std::vector<int> ids;
+    int nextValue = 0;
+    for (int i = 0; i < 5000; i++) {
+        // Grow first, then shrink to nothing
+        const bool insert = expected.empty() || std::uniform_int_distribution<int>(0, 99)(rng) < (i < 2500 ? 70 : 25);
+        if (insert) {
+            const int pos = std::uniform_int_distribution<int>(0, static_cast<int>(expected.size()))(rng);
+            expected.insert(expected.begin() + pos, nextValue);
+            ids.push_back(sequence.insert(pos, nextValue++));
+        } else {
+            const int pos = std::uniform_int_distribution<int>(0, static_cast<int>(expected.size()) - 1)(rng);
+            expected.erase(expected.begin() + pos);
+            sequence.erase(pos);
+        }
+        ASSERT_EQ(sequence.size(), static_cast<int>(expected.size()));
+        if (i % 50 != 0) {
+            continue;
+        }
+        const int n = sequence.size();
+        int pos = 0;
+        for (auto it = sequence.begin(); it != sequence.end(); ++it, pos++) {
+            ASSERT_EQ(*it, expected[pos]);
+            ASSERT_EQ(it.id(), ids[*it]);
+        }
+        ASSERT_EQ(pos, n);
+        for (pos = 0; pos < n; pos++) {
+            const int id = ids[expected[pos]];
+            ASSERT_EQ(sequence[pos], expected[pos]);
+            ASSERT_EQ(sequence.idAt(pos), id);
+            ASSERT_EQ(sequence.indexOf(id), pos);
+            ASSERT_EQ(sequence.byId(id), expected[pos]);
+            ASSERT_EQ(sequence.nextId(id), ids[expected[(pos + 1) % n]]);
+            ASSERT_EQ(sequence.prevId(id), ids[expected[(pos - 1 + n) % n]]);
+        }
+    }
+    while (!sequence.empty()) {
+        sequence.erase(0);
+    }
+    ASSERT_EQ(sequence.numChunks(), 0);
+}
+
+static void expectSameCurves(const Curve &chunked, const Curve &flat) {
+    ASSERT_EQ(chunked.numPoints(), flat.numPoints());
+    // The chunked storage calculates single normals with the same functions, but not in the loop of the range kernel
+    const real_t tolerance = 4 * std::numeric_limits<real_t>::epsilon();
+    for (int i = 0; i < flat.numPoints(); i++) {
+        ASSERT_EQ(chunked.getVertex(i), flat.getVertex(i)) << "at index " << i;
+        ASSERT_LE((chunked.getNormal(i) - flat.getNormal(i)).cwiseAbs().maxCoeff(), tolerance) << "at index " << i;
+        ASSERT_EQ(chunked.isCustomNormal(i), flat.isCustomNormal(i)) << "at index " << i;
+    }
+}
+
+static void expectSameQueries(const Curve &chunked, const Curve &flat, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> coord(-7, 7);
+    for (int i = 0; i < 100; i++) {
+        const Vector2DD p(coord(rng), coord(rng));
+        for (const double maxDist: {0.05, 20.0}) {
+            ASSERT_EQ(chunked.findClosestVertex(p, maxDist), flat.findClosestVertex(p, maxDist)) << p.transpose();
+            ASSERT_EQ(chunked.findClosestEdge(p, maxDist), flat.findClosestEdge(p, maxDist)) << p.transpose();
+            ASSERT_EQ(chunked.findClosestNormal(p, maxDist, 0.3), flat.findClosestNormal(p, maxDist, 0.3))
+                << p.transpose();
+        }
+    }
+}
+
+TEST(ChunkedStorageTest, TestEditsMatchFlatStorage) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-6, 6);
+    for (const bool closed: {true, false}) {
+        // Several chunks
+        Curve flat(test::noisyEllipse(2000, 5, 5, 0.02, rng).first, closed);
+        flat.setSpatialIndexEnabled(true);
+        Curve chunked = flat;
+        chunked.setChunkedStorageEnabled(true);
+        for (int i = 0; i < 1200; i++) {
+            const Vector2DD p(coord(rng), coord(rng));
+            const int idx = std::uniform_int_distribution<int>(0, flat.numPoints() - 1)(rng);
+            switch (i % 5) {
+                case 0:
+                case 1:
+                    ASSERT_EQ(chunked.addPoint(p), flat.addPoint(p));
+                    break;
+                case 2:
+                    chunked.removePoint(idx);
+                    flat.removePoint(idx);
+                    break;
+                case 3:
+                    chunked.setVertexPosition(idx, p);
+                    flat.setVertexPosition(idx, p);
+                    break;
+                default:
+                    chunked.setCustomNormal(idx, 3 * p.normalized());
+                    flat.setCustomNormal(idx, 3 * p.normalized());
+                    break;
+            }
+            if (i == 600) {
+                // Reads by index while the arrays are out of date, then switches back to the arrays and continues
+                expectSameCurves(chunked, flat);
+                expectSameQueries(chunked, flat, rng);
+                chunked.translate({0, 0});
+            }
+        }
+        expectSameQueries(chunked, flat, rng);
+        expectSameCurves(chunked, flat);
+        chunked.syncArrays();
+        ASSERT_EQ(std::as_const(chunked).getVertices(), std::as_const(flat).getVertices());
+        ASSERT_EQ(std::as_const(chunked).getCustomNormals(), std::as_const(flat).getCustomNormals());
+    }
+}
+
+TEST(ChunkedStorageTest, TestEmptyCurve) {
+    for (const bool closed: {true, false}) {
+        Curve curve;
+        curve.setClosed(closed);
+        curve.setSpatialIndexEnabled(true);
+        curve.setChunkedStorageEnabled(true);
+        ASSERT_EQ(curve.addPoint({1, 2}), 0);
+        const int idx = curve.addPoint({3, 2});
+        ASSERT_EQ(curve.findClosestVertex({3, 2}, 10), idx);
+        curve.removePoint(0);
+        curve.removePoint(0);
+        ASSERT_EQ(curve.numPoints(), 0);
+        ASSERT_EQ(curve.findClosestVertex({1, 2}, 10), -1);
+        ASSERT_TRUE(std::as_const(curve).getVertices().empty());
+    }
+}
@@ -0,0 +1,364 @@
+#include "conis/core/coniscurve.hpp"
+#include "conis/core/curve/refinement/normalrefinementsettings.hpp"
+#include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "test/test_helpers.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <thread>
+
+using namespace conis::core;
+
+// Tests: the snapshots published by ConisCurve
+
+// A closed convex curve doubles its number of points every subdivision level (no inflection points are inserted)
+static bool isConsistent(const CurveSnapshot &snapshot) {
+    return snapshot.subdivCurve.numPoints() == snapshot.controlCurve.numPoints() << snapshot.subdivLevel;
+}
+
+TEST(ConisCurveTest, TestSnapshotsAreImmutable) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    conisCurve.setControlCurve(Curve(points, normals, true));
+    conisCurve.subdivideCurve(3);
+
+    const std::shared_ptr<const CurveSnapshot> snapshot = conisCurve.getSnapshot();
+    ASSERT_EQ(snapshot->subdivLevel, 3);
+    ASSERT_TRUE(isConsistent(*snapshot));
+    ASSERT_EQ(&snapshot->subdivCurve, &conisCurve.getSubdivCurve());
+    const std::vector<Vector2DD> subdivVertices = snapshot->subdivCurve.getVertices();
+
+    // Later edits publish new snapshots and leave the held one untouched
+    conisCurve.setVertexPosition(2, points[2] * 1.1);
+    conisCurve.addPoint({4.6, 1.3});
+    conisCurve.subdivideCurve(4);
+    const std::shared_ptr<const CurveSnapshot> latest = conisCurve.getSnapshot();
+    ASSERT_GT(latest->version, snapshot->version);
+    ASSERT_TRUE(isConsistent(*latest));
+    ASSERT_EQ(latest->controlCurve.numPoints(), 9);
+    ASSERT_EQ(snapshot->controlCurve.numPoints(), 8);
+    ASSERT_EQ(snapshot->controlCurve.getVertex(2), points[2]);
+    ASSERT_EQ(snapshot->subdivCurve.getVertices(), subdivVertices);
+}
+
+TEST(ConisCurveTest, TestConcurrentReaders) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    conisCurve.setControlCurve(Curve(points, normals, true));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> numInconsistent{0};
+    std::atomic<int> numOutOfOrder{0};
+    std::thread reader([&] {
+        uint64_t lastVersion = 0;
+        while (!done) {
+            const std::shared_ptr<const CurveSnapshot> snapshot = conisCurve.getSnapshot();
+            numInconsistent += !isConsistent(*snapshot);
+            numOutOfOrder += snapshot->version < lastVersion;
+            lastVersion = snapshot->version;
+        }
+    });
+    for (int i = 0; i < 50; i++) {
+        conisCurve.setVertexPosition(i % 8, points[i % 8] * 1.1);
+        conisCurve.subdivideCurve(1 + i % 4);
+    }
+    done = true;
+    reader.join();
+    ASSERT_EQ(numInconsistent, 0);
+    ASSERT_EQ(numOutOfOrder, 0);
+}
+
+TEST(ConisCurveTest, TestMixedPrecisionSnapshot) {
+    SubdivisionSettings subdivSettings;
+    subdivSettings.fullPrecisionLevels = 1;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    const Curve controlCurve(points, normals, true);
+    conisCurve.setControlCurve(controlCurve);
+    for (const bool floatPreview: {false, true}) {
+        subdivSettings.floatPreview = floatPreview;
+        conisCurve.subdivideCurve(3);
+        ConicSubdivider subdivider(subdivSettings);
+        Curve expected;
+        if (floatPreview) {
+            CompactCurve<float> result;
+            subdivider.subdivide(controlCurve, 3, result);
+            expected = result.toCurve();
+        } else {
+            CompactCurve<double> result;
+            subdivider.subdivide(controlCurve, 3, result);
+            expected = result.toCurve();
+        }
+        ASSERT_TRUE(isConsistent(*conisCurve.getSnapshot()));
+        ASSERT_EQ(conisCurve.getSubdivCurve().getVertices(), expected.getVertices());
+        ASSERT_EQ(conisCurve.getSubdivCurve().getNormals(), expected.getNormals());
+    }
+}
+
+TEST(ConisCurveTest, TestChangeRangesAreMerged) {
+    CurveChanges changes;
+    changes.add({5, 8});
+    changes.add({1, 2});
+    changes.add({3, 3});
+    ASSERT_EQ(changes.ranges, (std::vector<IndexRange>{{1, 2}, {5, 8}}));
+    // Adjacent and overlapping ranges are merged
+    changes.add({2, 4});
+    changes.add({7, 10});
+    ASSERT_EQ(changes.ranges, (std::vector<IndexRange>{{1, 4}, {5, 10}}));
+    changes.add({0, 6});
+    ASSERT_EQ(changes.ranges, (std::vector<IndexRange>{{0, 10}}));
+    ASSERT_FALSE(changes.resized);
+}
+
+class RecordingListener : public Listener {
+public:
+    std::vector<ChangeSet> notifications;
+
+    void onListenerUpdated(const ChangeSet &changes) override { notifications.push_back(changes); }
+};
+
+TEST(ConisCurveTest, TestNotificationsDescribeChangedRanges) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(64, 0, 0, 5, 3);
+    conisCurve.setControlCurve(Curve(points, normals, true));
+    conisCurve.subdivideCurve(3);
+    RecordingListener listener;
+    conisCurve.addListener(&listener);
+
+    conisCurve.setVertexPosition(16, points[16] * 1.005);
+    ASSERT_EQ(listener.notifications.size(), 1);
+    const ChangeSet &changes = listener.notifications.back();
+    // The moved vertex and the normals of its neighbours
+    ASSERT_EQ(changes.control.ranges, (std::vector<IndexRange>{{15, 18}}));
+    ASSERT_FALSE(changes.subdiv.resized);
+    ASSERT_EQ(changes.subdiv.ranges.size(), 1);
+    // Only the patches around the vertex are affected
+    const IndexRange subdivRange = changes.subdiv.ranges[0];
+    ASSERT_LE(subdivRange.begin, 16 << 3);
+    ASSERT_GT(subdivRange.end, 16 << 3);
+    ASSERT_LT(subdivRange.end - subdivRange.begin, conisCurve.getSubdivCurve().numPoints() / 2);
+
+    conisCurve.addPoint({0, 3.5});
+    ASSERT_TRUE(listener.notifications.back().control.resized);
+    ASSERT_TRUE(listener.notifications.back().subdiv.resized);
+    conisCurve.removeListener(&listener);
+}
+
+TEST(ConisCurveTest, TestChangedRangesCoverEdits) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    auto [points, normals] = test::ellipse(40, 0, 0, 5, 3);
+    // Dents that insert inflection points
+    points[10] *= 0.8;
+    points[25] *= 0.85;
+    for (const bool closed: {true, false}) {
+        ConisCurve conisCurve(subdivSettings, normRefSettings);
+        conisCurve.setControlCurve(Curve(points, normals, closed));
+        conisCurve.subdivideCurve(3);
+        RecordingListener listener;
+        conisCurve.addListener(&listener);
+        for (const int idx: {0, 1, 9, 11, 20, 38, 39}) {
+            const std::shared_ptr<const CurveSnapshot> before = conisCurve.getSnapshot();
+            conisCurve.setVertexPosition(idx, points[idx] * 1.01);
+            const std::shared_ptr<const CurveSnapshot> after = conisCurve.getSnapshot();
+            const CurveChanges &changes = listener.notifications.back().subdiv;
+            ASSERT_FALSE(changes.resized);
+            const Curve &subdivBefore = before->subdivCurve;
+            const Curve &subdivAfter = after->subdivCurve;
+            for (int i = 0; i < subdivAfter.numPoints(); i++) {
+                if (subdivBefore.getVertex(i) == subdivAfter.getVertex(i) &&
+                    subdivBefore.getNormal(i) == subdivAfter.getNormal(i)) {
+                    continue;
+                }
+                const bool reported = std::any_of(changes.ranges.begin(), changes.ranges.end(), [&](const auto &r) {
+                    return r.begin <= i && i < r.end;
+                });
+                ASSERT_TRUE(reported) << "point " << i << " after moving vertex " << idx << ", closed: " << closed;
+            }
+        }
+        conisCurve.removeListener(&listener);
+    }
+}
+
+TEST(ConisCurveTest, TestCallerMemoryResource) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    normRefSettings.testSubdivLevel = 2;
+    normRefSettings.maxRefinementIterations = 2;
+    // An arena that is released in one go once the curve is done
+    std::pmr::monotonic_buffer_resource arena;
+    CountingResource resource(&arena);
+    {
+        ConisCurve conisCurve(subdivSettings, normRefSettings, &resource);
+        auto [points, normals] = test::ellipse(16, 0, 0, 5, 3);
+        conisCurve.setControlCurve(Curve(points, normals, true));
+        conisCurve.subdivideCurve(3);
+        conisCurve.refineNormals(AREA_INFLATION);
+        ASSERT_GT(conisCurve.getAllocationStats().numAllocations, 0);
+    }
+    ASSERT_GT(resource.stats().numAllocations, 0);
+    ASSERT_EQ(resource.stats().bytesInUse, 0);
+}
+
+TEST(ConisCurveTest, TestRefinementInsertsInflectionPoints) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    normRefSettings.testSubdivLevel = 2;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    std::vector<Vector2DD> wave;
+    for (int i = 0; i < 12; i++) {
+        wave.emplace_back(i, 3 * std::sin(0.7 * i));
+    }
+    conisCurve.setControlCurve(Curve(wave, false));
+    conisCurve.subdivideCurve(2);
+    RecordingListener listener;
+    conisCurve.addListener(&listener);
+
+    conisCurve.checkpoint();
+    conisCurve.refineNormals(AREA_INFLATION);
+    const int numPoints = conisCurve.getControlCurve().numPoints();
+    ASSERT_GT(numPoints, 12);
+    ASSERT_TRUE(listener.notifications.back().control.resized);
+    // The inserted points are inflection points, whose normals can be moved freely
+    const auto &customNormals = conisCurve.getControlCurve().getCustomNormals();
+    const int inflIdx = static_cast<int>(std::find(customNormals.begin(), customNormals.end(), 1) - customNormals.begin());
+    ASSERT_LT(inflIdx, numPoints);
+    const Vector2DD inflPoint = conisCurve.getControlCurve().getVertex(inflIdx);
+    conisCurve.redirectNormalToPoint(inflIdx, inflPoint + Vector2DD(0.6, 0.8), true);
+    ASSERT_TRUE((conisCurve.getControlCurve().getNormal(inflIdx) - Vector2DD(0.6, 0.8)).norm() < 1e-12);
+    ASSERT_TRUE(conisCurve.undo());
+    ASSERT_EQ(conisCurve.getControlCurve().getVertices(), wave);
+    ASSERT_TRUE(conisCurve.redo());
+    ASSERT_EQ(conisCurve.getControlCurve().numPoints(), numPoints);
+    conisCurve.removeListener(&listener);
+}
+
+TEST(ConisCurveTest, TestNotificationsAreCoalesced) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(32, 0, 0, 5, 3);
+    conisCurve.setControlCurve(Curve(points, normals, true));
+    conisCurve.subdivideCurve(2);
+    RecordingListener listener;
+    conisCurve.addListener(&listener);
+    int numScheduled = 0;
+    conisCurve.setNotificationScheduler([&] { numScheduled++; });
+
+    conisCurve.setVertexPosition(4, points[4] * 1.05);
+    conisCurve.setVertexPosition(20, points[20] * 1.05);
+    conisCurve.setVertexPosition(20, points[20] * 1.1);
+    ASSERT_EQ(numScheduled, 1);
+    ASSERT_TRUE(listener.notifications.empty());
+
+    conisCurve.flushNotifications();
+    ASSERT_EQ(listener.notifications.size(), 1);
+    ASSERT_EQ(listener.notifications[0].control.ranges, (std::vector<IndexRange>{{3, 6}, {19, 22}}));
+    // Nothing changed since the last delivery
+    conisCurve.flushNotifications();
+    ASSERT_EQ(listener.notifications.size(), 1);
+    // Resubdividing (e.g. for new settings) changes the entire subdivision curve, but not the control curve
+    conisCurve.resubdivide();
+    conisCurve.flushNotifications();
+    ASSERT_EQ(listener.notifications.size(), 2);
+    ASSERT_TRUE(listener.notifications[1].control.empty());
+    ASSERT_EQ(listener.notifications[1].subdiv.ranges,
+              (std::vector<IndexRange>{{0, conisCurve.getSubdivCurve().numPoints()}}));
+    ASSERT_EQ(numScheduled, 2);
+    conisCurve.removeListener(&listener);
+}
+
+TEST(ConisCurveTest, TestEditBatch) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve batched(subdivSettings, normRefSettings);
+    ConisCurve sequential(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    for (ConisCurve *conisCurve: {&batched, &sequential}) {
+        conisCurve->setControlCurve(Curve(points, normals, true));
+        conisCurve->subdivideCurve(3);
+    }
+    RecordingListener listener;
+    batched.addListener(&listener);
+    const uint64_t version = batched.getSnapshot()->version;
+
+    const auto edit = [&](ConisCurve &conisCurve) {
+        for (int i = 0; i < 8; i++) {
+            conisCurve.setVertexPosition(i, points[i] * 1.1);
+        }
+        conisCurve.addPoint({5, 1});
+        conisCurve.translate({1, 2});
+    };
+    {
+        EditBatch batch(batched);
+        edit(batched);
+        // Nested batches are committed by the outermost one
+        batched.beginEdit();
+        batched.removePoint(0);
+        batched.commit();
+        ASSERT_EQ(batched.getSnapshot()->version, version);
+        ASSERT_TRUE(listener.notifications.empty());
+    }
+    edit(sequential);
+    sequential.removePoint(0);
+
+    // A single subdivision and notification for the whole batch, with the same result
+    ASSERT_EQ(batched.getSnapshot()->version, version + 1);
+    ASSERT_EQ(listener.notifications.size(), 1);
+    ASSERT_EQ(batched.getSubdivCurve().getVertices(), sequential.getSubdivCurve().getVertices());
+    ASSERT_EQ(batched.getSubdivCurve().getNormals(), sequential.getSubdivCurve().getNormals());
+    batched.removeListener(&listener);
+}
+
+TEST(ConisCurveTest, TestUndoRedo) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    conisCurve.setControlCurve(Curve(points, normals, true));
+    conisCurve.subdivideCurve(3);
+    ASSERT_FALSE(conisCurve.canUndo());
+    const std::vector<Vector2DD> original = conisCurve.getControlCurve().getVertices();
+    const std::vector<Vector2DD> originalSubdiv = conisCurve.getSubdivCurve().getVertices();
+
+    conisCurve.checkpoint();
+    conisCurve.setVertexPosition(2, points[2] * 1.1);
+    conisCurve.setVertexPosition(2, points[2] * 1.2);
+    conisCurve.checkpoint();
+    const std::vector<Vector2DD> moved = conisCurve.getControlCurve().getVertices();
+    conisCurve.addPoint({4.6, 1.3});
+    const std::vector<Vector2DD> added = conisCurve.getControlCurve().getVertices();
+    // Checkpoints without edits in between do not add steps
+    conisCurve.checkpoint();
+    conisCurve.checkpoint();
+    ASSERT_EQ(conisCurve.getHistorySize(), 3);
+
+    ASSERT_TRUE(conisCurve.undo());
+    ASSERT_EQ(conisCurve.getControlCurve().getVertices(), moved);
+    ASSERT_TRUE(conisCurve.undo());
+    ASSERT_EQ(conisCurve.getControlCurve().getVertices(), original);
+    ASSERT_EQ(conisCurve.getSubdivCurve().getVertices(), originalSubdiv);
+    ASSERT_FALSE(conisCurve.undo());
+    ASSERT_TRUE(conisCurve.redo());
+    ASSERT_TRUE(conisCurve.redo());
+    ASSERT_EQ(conisCurve.getControlCurve().getVertices(), added);
+    ASSERT_FALSE(conisCurve.redo());
+
+    // An edit after an undo discards the undone steps
+    ASSERT_TRUE(conisCurve.undo());
+    conisCurve.removePoint(0);
+    ASSERT_FALSE(conisCurve.canRedo());
+    ASSERT_FALSE(conisCurve.redo());
+    ASSERT_EQ(conisCurve.getControlCurve().numPoints(), 7);
+    ASSERT_TRUE(conisCurve.undo());
+    ASSERT_EQ(conisCurve.getControlCurve().getVertices(), moved);
+}
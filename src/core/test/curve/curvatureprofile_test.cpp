@@ -0,0 +1,129 @@
+#include "conis/core/curve/compactcurve.hpp"
+#include "conis/core/curve/curvatureprofile.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <omp.h>
+#include <random>
+
+using namespace conis::core;
+
+// Tests: the bulk curvature computation matches Curve::curvatureAtIdx
+
+// The statistics computed in a straightforward way
+static CurvatureStats expectedStats(const std::vector<real_t> &curvatures, const bool closed) {
+    const int n = static_cast<int>(curvatures.size());
+    const int first = closed ? 0 : 1;
+    const int last = closed ? n - 1 : n - 2;
+    CurvatureStats stats;
+    real_t sum = 0;
+    for (int i = first; i <= last; i++) {
+        stats.max = std::max(stats.max, curvatures[i]);
+        sum += curvatures[i];
+        const int next = i + 1 < n ? i + 1 : 0;
+        if (i < last || closed) {
+            const real_t jump = std::abs(curvatures[next] - curvatures[i]);
+            stats.totalVariation += jump;
+            if (stats.maxJumpIdx < 0 || jump > stats.maxJump) {
+                stats.maxJump = jump;
+                stats.maxJumpIdx = i;
+            }
+        }
+    }
+    stats.mean = sum / (last - first + 1);
+    return stats;
+}
+
+// A relative tolerance in units of the precision of real_t. The floor covers the curvatures close to zero, which are the
+// difference of much larger terms.
+static real_t tolerance(const real_t expected) {
+    return 1e4 * std::numeric_limits<real_t>::epsilon() * std::max(std::abs(expected), real_t(1));
+}
+
+TEST(CurvatureProfileTest, TestMatchesCurvatureAtIdx) {
+    for (const bool closed: {true, false}) {
+        // More than one block, so that the blocks are combined
+        std::mt19937 rng(5);
+        const Curve curve(test::noisyEllipse(10000, 5, 3, 1e-4, rng).first, closed);
+        const auto profiles = computeCurvatureProfiles(curve);
+        for (int type = 0; type < numCurvatureTypes; type++) {
+            const auto curvatureType = static_cast<CurvatureType>(type);
+            const CurvatureProfile profile = computeCurvatureProfile(curve, curvatureType);
+            for (int i = 0; i < curve.numPoints(); i++) {
+                // The end points of open curves can be NaN
+                const real_t expected = curve.curvatureAtIdx(i, curvatureType);
+                if (!std::isnan(expected)) {
+                    ASSERT_NEAR(profile.curvatures[i], expected, tolerance(expected)) << "at index " << i;
+                    ASSERT_EQ(profiles[type].curvatures[i], profile.curvatures[i]) << "at index " << i;
+                }
+            }
+            const CurvatureStats stats = expectedStats(profile.curvatures, closed);
+            ASSERT_EQ(profile.stats.max, stats.max);
+            ASSERT_NEAR(profile.stats.mean, stats.mean, tolerance(stats.mean));
+            ASSERT_NEAR(profile.stats.totalVariation, stats.totalVariation, tolerance(stats.totalVariation));
+            ASSERT_EQ(profile.stats.maxJump, stats.maxJump);
+            ASSERT_EQ(profile.stats.maxJumpIdx, stats.maxJumpIdx);
+        }
+    }
+}
+
+TEST(CurvatureProfileTest, TestIndependentOfThreads) {
+    std::mt19937 rng(5);
+    const Curve curve(test::noisyEllipse(20000, 5, 3, 1e-4, rng).first, true);
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    const CurvatureProfile sequential = computeCurvatureProfile(curve, AREA_INFLATION);
+    omp_set_num_threads(4);
+    const CurvatureProfile parallel = computeCurvatureProfile(curve, AREA_INFLATION);
+    omp_set_num_threads(maxThreads);
+    ASSERT_EQ(parallel.curvatures, sequential.curvatures);
+    ASSERT_EQ(parallel.stats.mean, sequential.stats.mean);
+    ASSERT_EQ(parallel.stats.totalVariation, sequential.stats.totalVariation);
+}
+
+TEST(CurvatureProfileTest, TestSmallCurves) {
+    for (const int numPoints: {0, 1, 2, 3}) {
+        for (const bool closed: {true, false}) {
+            std::mt19937 rng(5);
+            const Curve curve(test::noisyEllipse(numPoints, 5, 3, 1e-4, rng).first, closed);
+            const CurvatureProfile profile = computeCurvatureProfile(curve, CIRCLE_RADIUS);
+            ASSERT_EQ(profile.curvatures.size(), numPoints);
+            for (int i = 0; i < numPoints; i++) {
+                ASSERT_EQ(profile.curvatures[i], curve.curvatureAtIdx(i, CIRCLE_RADIUS));
+            }
+        }
+    }
+}
+
+TEST(CurvatureProfileTest, TestCompactCurve) {
+    for (const bool closed: {true, false}) {
+        std::mt19937 rng(5);
+        const Curve curve(test::noisyEllipse(10000, 5, 3, 1e-4, rng).first, closed);
+        const CompactCurve<double> compact(curve);
+        // The fast math approximations are compiled into separate loops
+        for (const bool fastMath: {false, true}) {
+            const auto expectedProfiles = computeCurvatureProfiles(curve, fastMath);
+            const auto profiles = computeCurvatureProfiles(compact, fastMath);
+            for (int type = 0; type < numCurvatureTypes; type++) {
+                const std::vector<real_t> &expected = expectedProfiles[type].curvatures;
+                const std::vector<real_t> &curvatures = profiles[type].curvatures;
+                ASSERT_EQ(curvatures.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); i++) {
+                    if (!std::isnan(expected[i])) {
+                        // The short edges lose most of the precision of double in the coordinate differences
+                        ASSERT_NEAR(curvatures[i], expected[i], 1e-6 * std::max(std::abs(expected[i]), real_t(1)))
+                            << "at index " << i;
+                    }
+                }
+                ASSERT_NEAR(profiles[type].stats.mean, expectedProfiles[type].stats.mean, 1e-6);
+            }
+        }
+        CurvatureProfile profile;
+        computeCurvatureProfile(compact, AREA_INFLATION, profile);
+        // The end points of open curves are NaN, so only the statistics are compared
+        const CurvatureStats stats = computeCurvatureProfiles(compact)[AREA_INFLATION].stats;
+        ASSERT_EQ(profile.stats.mean, stats.mean);
+        ASSERT_EQ(profile.stats.totalVariation, stats.totalVariation);
+    }
+}
@@ -0,0 +1,89 @@
+#include "conis/core/curve/compactcurve.hpp"
+#include "conis/core/curve/curve.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <utility>
+
+using namespace conis::core;
+
+// Tests: recalculating all normals at once agrees with recalculating them one at a time
+
+static Curve circleWithCoincidingVertices(const int numPoints, const bool closed, std::mt19937 &rng) {
+    auto [points, normals] = test::noisyEllipse(numPoints, 5, 5, 0.05, rng);
+    // Coinciding vertices take a different path in the normal calculation
+    points[numPoints / 2] = points[numPoints / 2 + 1];
+    return Curve(points, closed);
+}
+
+static void expectCloseNormals(const Curve &curve, const Curve &expected) {
+    ASSERT_EQ(curve.numPoints(), expected.numPoints());
+    // Both use the same kernel, but the compiler may still contract or vectorise its arithmetic differently in a loop.
+    // The normals have unit length, so this is a few ulp.
+    const real_t tolerance = 4 * std::numeric_limits<real_t>::epsilon();
+    for (int i = 0; i < curve.numPoints(); i++) {
+        const real_t difference = (curve.getNormal(i) - expected.getNormal(i)).cwiseAbs().maxCoeff();
+        ASSERT_LE(difference, tolerance) << "at index " << i;
+        ASSERT_EQ(curve.isCustomNormal(i), expected.isCustomNormal(i)) << "at index " << i;
+    }
+}
+
+TEST(CurveNormalsTest, TestRecalculateNormals) {
+    std::mt19937 rng(5);
+    // Spans several blocks, so that the blocks are computed in parallel
+    for (const bool closed: {true, false}) {
+        for (const auto &[areaWeighted, circleNormals]: {std::pair(true, false), {false, false}, {false, true}}) {
+            Curve curve = circleWithCoincidingVertices(10000, closed, rng);
+            curve.recalculateNormals(areaWeighted, circleNormals);
+            Curve expected = curve;
+            for (int i = 0; i < expected.numPoints(); i++) {
+                expected.setCustomNormal(i, Vector2DD(0, 1));
+                expected.recalculateNormal(i);
+            }
+            expectCloseNormals(curve, expected);
+        }
+    }
+}
+
+TEST(CurveNormalsTest, TestRecalculateNormalRange) {
+    std::mt19937 rng(6);
+    for (const bool closed: {true, false}) {
+        Curve curve = circleWithCoincidingVertices(500, closed, rng);
+        curve.recalculateNormals(true, false);
+        for (int i = 0; i < curve.numPoints(); i++) {
+            curve.setCustomNormal(i, Vector2DD(1, 0));
+        }
+        Curve expected = curve;
+        // Includes both end points, which wrap around on closed curves
+        for (const auto &[begin, end]: {std::pair(0, 3), {100, 250}, {497, 500}, {10, 10}}) {
+            curve.recalculateNormalRange(begin, end);
+            for (int i = begin; i < end; i++) {
+                expected.recalculateNormal(i);
+            }
+        }
+        expectCloseNormals(curve, expected);
+        ASSERT_THROW(curve.recalculateNormalRange(5, 501), std::out_of_range);
+        ASSERT_THROW(curve.recalculateNormalRange(5, 4), std::out_of_range);
+    }
+}
+
+TEST(CurveNormalsTest, TestCompactCurveNormals) {
+    std::mt19937 rng(7);
+    for (const bool closed: {true, false}) {
+        for (const auto &[areaWeighted, circleNormals]: {std::pair(true, false), {false, false}, {false, true}}) {
+            Curve curve = circleWithCoincidingVertices(1000, closed, rng);
+            curve.recalculateNormals(areaWeighted, circleNormals);
+            CompactCurve<double> compact(curve);
+            for (int i = 0; i < compact.numPoints(); i++) {
+                compact.setNormal(i, Eigen::Vector2d(0, 1));
+            }
+            compact.recalculateNormals(areaWeighted, circleNormals);
+            for (int i = 0; i < curve.numPoints(); i++) {
+                const real_t difference = (compact.getNormal(i).cast<real_t>() - curve.getNormal(i)).norm();
+                // The osculating circles amplify the rounding errors of double
+                ASSERT_LE(difference, 1e-8) << "at index " << i;
+            }
+        }
+    }
+}
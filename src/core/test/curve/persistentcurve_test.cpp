@@ -0,0 +1,108 @@
+#include "conis/core/curve/persistentcurve.hpp"
+#include "test/test_helpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace conis::core;
+
+// Tests: the persistent curve versions share the chunks that were not edited
+
+static void expectSameCurve(const Curve &actual, const Curve &expected) {
+    ASSERT_EQ(actual.isClosed(), expected.isClosed());
+    ASSERT_EQ(actual.getVertices(), expected.getVertices());
+    ASSERT_EQ(actual.getNormals(), expected.getNormals());
+    ASSERT_EQ(actual.getCustomNormals(), expected.getCustomNormals());
+}
+
+TEST(PersistentCurveTest, TestVersionsShareUnchangedChunks) {
+    auto [points, normals] = test::circle(50000, 0, 0, 5);
+    Curve curve(points, normals, true);
+    const PersistentCurve original(curve);
+    expectSameCurve(original.toCurve(), curve);
+    ASSERT_TRUE(original.matches(curve));
+    const int numChunks = original.numChunks();
+
+    // Moving a single vertex only copies the chunks containing it and its neighbours
+    PersistentCurve::Edits edits(original);
+    ASSERT_TRUE(edits.empty());
+    curve.setVertexPosition(20000, points[20000] * 1.01);
+    edits.pointsChanged(19999, 20002);
+    ASSERT_FALSE(edits.empty());
+    const PersistentCurve moved(curve, original, edits);
+    ASSERT_FALSE(original.matches(curve));
+    expectSameCurve(moved.toCurve(), curve);
+    ASSERT_GE(moved.numSharedChunks(original), numChunks - 2);
+
+    // Inserting and removing points shifts the chunks after them, but they can still be shared
+    edits = PersistentCurve::Edits(moved);
+    const int idx = curve.addPoint((points[100] + points[101]) / 2 * 1.0001);
+    edits.pointInserted(idx);
+    edits.pointsChanged(idx - 1, idx + 2);
+    curve.removePoint(40000);
+    edits.pointRemoved(40000);
+    edits.pointsChanged(39999, 40001);
+    const PersistentCurve edited(curve, moved, edits);
+    expectSameCurve(edited.toCurve(), curve);
+    ASSERT_GE(edited.numSharedChunks(moved), moved.numChunks() - 4);
+    ASSERT_TRUE(moved.matches(moved.toCurve()));
+
+    // Many small edits do not fragment the chunks
+    PersistentCurve version = edited;
+    for (int i = 0; i < 200; i++) {
+        edits = PersistentCurve::Edits(version);
+        const int vertIdx = 1 + i * 7;
+        curve.setVertexPosition(vertIdx, curve.getVertex(vertIdx) * 1.0001);
+        edits.pointsChanged(vertIdx - 1, vertIdx + 2);
+        version = PersistentCurve(curve, version, edits);
+    }
+    expectSameCurve(version.toCurve(), curve);
+    ASSERT_LE(version.numChunks(), 2 * numChunks);
+
+    // A replaced curve shares nothing
+    edits = PersistentCurve::Edits(version);
+    edits.curveReplaced();
+    ASSERT_EQ(PersistentCurve(curve, version, edits).numSharedChunks(version), 0);
+}
+
+TEST(PersistentCurveTest, TestRandomEdits) {
+    std::mt19937 rng(7);
+    auto [points, normals] = test::circle(5000, 0, 0, 5);
+    Curve curve(points, normals, false);
+    PersistentCurve version(curve);
+    for (int step = 0; step < 50; step++) {
+        PersistentCurve::Edits edits(version);
+        // Clusters of inserts and removals grow and shrink the chunks across their bounds
+        const int center = std::uniform_int_distribution<int>(0, curve.numPoints() - 1)(rng);
+        for (int i = 0; i < 300; i++) {
+            const int n = curve.numPoints();
+            const int idx = std::clamp(center + std::uniform_int_distribution<int>(-200, 200)(rng), 0, n - 1);
+            switch (std::uniform_int_distribution<int>(0, 2)(rng)) {
+                case 0:
+                    curve.setNormal(idx, Vector2DD(0, 1));
+                    edits.pointsChanged(idx, idx + 1);
+                    break;
+                case 1:
+                    curve.getVertices().insert(curve.getVertices().begin() + idx, Vector2DD(idx, step));
+                    curve.getNormals().insert(curve.getNormals().begin() + idx, Vector2DD(1, 0));
+                    curve.getCustomNormals().insert(curve.getCustomNormals().begin() + idx, false);
+                    edits.pointInserted(idx);
+                    break;
+                default:
+                    curve.getVertices().erase(curve.getVertices().begin() + idx);
+                    curve.getNormals().erase(curve.getNormals().begin() + idx);
+                    curve.getCustomNormals().erase(curve.getCustomNormals().begin() + idx);
+                    edits.pointRemoved(idx);
+                    break;
+            }
+        }
+        const PersistentCurve next(curve, version, edits);
+        expectSameCurve(next.toCurve(), curve);
+        ASSERT_GT(next.numSharedChunks(version), 0);
+        for (const auto &chunk: next.getChunks()) {
+            ASSERT_GT(chunk->size(), 0);
+            ASSERT_LE(chunk->size(), PersistentCurve::chunkSize);
+        }
+        version = next;
+    }
+}
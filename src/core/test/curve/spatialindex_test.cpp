@@ -0,0 +1,84 @@
+#include "conis/core/curve/curve.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+
+using namespace conis::core;
+
+// Tests: the spatial index of Curve gives the same results as the linear scans
+
+static void expectSameQueries(const Curve &indexed, const Curve &linear, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> coord(-7, 7);
+    for (int i = 0; i < 200; i++) {
+        const Vector2DD p(coord(rng), coord(rng));
+        for (const double maxDist: {0.05, 0.5, 20.0}) {
+            ASSERT_EQ(indexed.findClosestVertex(p, maxDist), linear.findClosestVertex(p, maxDist)) << p.transpose();
+            ASSERT_EQ(indexed.findClosestEdge(p, maxDist), linear.findClosestEdge(p, maxDist)) << p.transpose();
+            ASSERT_EQ(indexed.findClosestNormal(p, maxDist, 0.3), linear.findClosestNormal(p, maxDist, 0.3))
+                << p.transpose();
+        }
+    }
+}
+
+TEST(SpatialIndexTest, TestQueriesMatchLinearScan) {
+    std::mt19937 rng(42);
+    for (const bool closed: {true, false}) {
+        Curve linear(test::noisyEllipse(500, 5, 5, 0.02, rng).first, closed);
+        Curve indexed = linear;
+        indexed.setSpatialIndexEnabled(true);
+        expectSameQueries(indexed, linear, rng);
+    }
+}
+
+TEST(SpatialIndexTest, TestIncrementalUpdates) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-6, 6);
+    for (const bool closed: {true, false}) {
+        Curve linear(test::noisyEllipse(300, 5, 5, 0.02, rng).first, closed);
+        Curve indexed = linear;
+        indexed.setSpatialIndexEnabled(true);
+        expectSameQueries(indexed, linear, rng);
+        for (int i = 0; i < 50; i++) {
+            const Vector2DD p(coord(rng), coord(rng));
+            std::uniform_int_distribution<int> index(0, linear.numPoints() - 1);
+            const int idx = index(rng);
+            switch (i % 4) {
+                case 0:
+                    ASSERT_EQ(indexed.addPoint(p), linear.addPoint(p));
+                    break;
+                case 1:
+                    indexed.removePoint(idx);
+                    linear.removePoint(idx);
+                    break;
+                case 2:
+                    indexed.setVertexPosition(idx, p);
+                    linear.setVertexPosition(idx, p);
+                    break;
+                default:
+                    indexed.setCustomNormal(idx, 3 * p.normalized());
+                    linear.setCustomNormal(idx, 3 * p.normalized());
+                    break;
+            }
+        }
+        ASSERT_EQ(std::as_const(indexed).getVertices(), std::as_const(linear).getVertices());
+        expectSameQueries(indexed, linear, rng);
+    }
+}
+
+TEST(SpatialIndexTest, TestEmptyCurve) {
+    for (const bool closed: {true, false}) {
+        Curve curve;
+        curve.setClosed(closed);
+        curve.setSpatialIndexEnabled(true);
+        // Builds the (empty) index, so that the edits below update it incrementally
+        ASSERT_EQ(curve.findClosestVertex({1, 2}, 10), -1);
+        ASSERT_EQ(curve.addPoint({1, 2}), 0);
+        ASSERT_EQ(curve.findClosestVertex({1, 2}, 10), 0);
+        curve.removePoint(0);
+        ASSERT_EQ(curve.numPoints(), 0);
+        ASSERT_EQ(curve.findClosestVertex({1, 2}, 10), -1);
+        ASSERT_EQ(curve.addPoint({3, 4}), 0);
+        ASSERT_EQ(curve.findClosestVertex({3, 4}, 10), 0);
+    }
+}
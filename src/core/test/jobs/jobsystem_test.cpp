@@ -0,0 +1,121 @@
+#include "conis/core/coniscurve.hpp"
+#include "conis/core/curve/refinement/normalrefinementsettings.hpp"
+#include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/jobs/jobsystem.hpp"
+#include "test/test_helpers.hpp"
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace conis::core;
+
+TEST(JobSystemTest, TestInteractiveJobsRunFirst) {
+    JobSystem jobs(1);
+    // Occupy the only worker, so that the other jobs are queued
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    jobs.submit([released](const CancellationToken &) { released.wait(); });
+
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto record = [&](const int id) {
+        return [&, id](const CancellationToken &) {
+            std::lock_guard lock(mutex);
+            order.push_back(id);
+        };
+    };
+    jobs.submit(record(0), PRIORITY_BACKGROUND);
+    jobs.submit(record(1), PRIORITY_INTERACTIVE);
+    jobs.submit(record(2), PRIORITY_BACKGROUND);
+    const JobHandle last = jobs.submit(record(3), PRIORITY_INTERACTIVE);
+    release.set_value();
+    // Lower priority jobs run last
+    jobs.submit(record(4), PRIORITY_BACKGROUND).wait();
+
+    ASSERT_TRUE(last.isDone());
+    ASSERT_EQ(order, (std::vector<int>{1, 3, 0, 2, 4}));
+}
+
+TEST(JobSystemTest, TestCancellation) {
+    JobSystem jobs(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> completedCancelled{false};
+    const JobHandle running = jobs.submit(
+        [&](const CancellationToken &token) {
+            started = true;
+            while (!token.isCancelled()) {
+                std::this_thread::yield();
+            }
+        },
+        PRIORITY_BACKGROUND,
+        [&](const bool cancelled) { completedCancelled = cancelled; });
+    std::atomic<bool> pendingRan{false};
+    const JobHandle pending = jobs.submit([&](const CancellationToken &) { pendingRan = true; });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    ASSERT_FALSE(running.isDone());
+
+    pending.cancel();
+    running.cancel();
+    running.wait();
+    pending.wait();
+    ASSERT_TRUE(completedCancelled);
+    ASSERT_TRUE(pending.isCancelled());
+    // Cancelled before it started
+    ASSERT_FALSE(pendingRan);
+}
+
+TEST(JobSystemTest, TestFailingJobs) {
+    JobSystem jobs(1);
+    const JobHandle failed = jobs.submit([](const CancellationToken &) { throw std::runtime_error("failed"); });
+    const JobHandle unknown = jobs.submit([](const CancellationToken &) { throw 42; });
+    failed.wait();
+    unknown.wait();
+    // The worker survives both
+    std::atomic<bool> ran{false};
+    jobs.submit([&](const CancellationToken &) { ran = true; }).wait();
+    ASSERT_TRUE(ran);
+}
+
+TEST(JobSystemTest, TestProgressiveRefinement) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings normRefSettings;
+    normRefSettings.testSubdivLevel = 2;
+    normRefSettings.angleLimit = 1e-3;
+    ConisCurve conisCurve(subdivSettings, normRefSettings);
+    auto [points, normals] = test::ellipse(16, 0, 0, 5, 3);
+    normals[3] = {1, 0};
+    conisCurve.setControlCurve(Curve(points, normals, true));
+
+    // The refinement runs on a copy: the control curve only changes when a snapshot is applied
+    const JobHandle job = conisCurve.refineNormalsProgressively(AREA_INFLATION);
+    job.wait();
+    ASSERT_FALSE(job.isCancelled());
+    ASSERT_EQ(conisCurve.getControlCurve().getNormal(3), normals[3]);
+    ASSERT_TRUE(conisCurve.applyRefinementSnapshot());
+    ASSERT_NE(conisCurve.getControlCurve().getNormal(3), normals[3]);
+    ASSERT_FALSE(conisCurve.applyRefinementSnapshot());
+
+    // The inflection points the refinement inserts are inserted into the control curve as well
+    std::vector<Vector2DD> wave;
+    for (int i = 0; i < 12; i++) {
+        wave.emplace_back(i, 3 * std::sin(0.7 * i));
+    }
+    conisCurve.setControlCurve(Curve(wave, false));
+    conisCurve.refineNormalsProgressively(AREA_INFLATION).wait();
+    ASSERT_GT(conisCurve.getControlCurve().numPoints(), 12);
+    ASSERT_TRUE(conisCurve.applyRefinementSnapshot());
+
+    // A cancelled refinement leaves nothing to apply
+    normRefSettings.maxRefinementIterations = 1000;
+    normRefSettings.convergenceAngle = -1;
+    const JobHandle cancelledJob = conisCurve.refineNormalsProgressively(AREA_INFLATION);
+    conisCurve.cancelRefinement();
+    ASSERT_TRUE(cancelledJob.isDone());
+    ASSERT_FALSE(conisCurve.applyRefinementSnapshot());
+}
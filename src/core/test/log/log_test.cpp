@@ -0,0 +1,78 @@
+#include "conis/core/curve/subdivision/conicsubdivider.hpp"
+#include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/log.hpp"
+#include "test/test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace conis::core;
+
+// Collects the messages of the sink; the sink only runs on the logging thread, flushLog synchronises with it
+class LogTest : public ::testing::Test {
+protected:
+    std::vector<std::pair<LogLevel, std::string>> messages;
+
+    void SetUp() override {
+        setLogSink([this](const LogLevel level, const std::string &message) { messages.emplace_back(level, message); });
+    }
+
+    void TearDown() override {
+        setLogSink({});
+        setLogLevel(LOG_INFO);
+    }
+};
+
+TEST_F(LogTest, TestLevelsAndOrder) {
+    setLogLevel(LOG_INFO);
+    CONIS_LOG(LOG_DEBUG, "hidden");
+    for (int i = 0; i < 100; i++) {
+        CONIS_LOG(LOG_INFO, "message " << i);
+    }
+    CONIS_LOG(LOG_ERROR, "error");
+    flushLog();
+
+    ASSERT_EQ(messages.size(), 101);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(messages[i].first, LOG_INFO);
+        ASSERT_EQ(messages[i].second, "message " + std::to_string(i));
+    }
+    ASSERT_EQ(messages.back(), std::make_pair(LOG_ERROR, std::string("error")));
+
+    setLogLevel(LOG_OFF);
+    CONIS_LOG(LOG_ERROR, "hidden");
+    flushLog();
+    ASSERT_EQ(messages.size(), 101);
+}
+
+TEST_F(LogTest, TestDisabledMessagesAreNotFormatted) {
+    int numFormatted = 0;
+    const auto format = [&] { return ++numFormatted; };
+    setLogLevel(LOG_WARNING);
+    CONIS_LOG(LOG_INFO, format());
+    ASSERT_EQ(numFormatted, 0);
+    CONIS_LOG(LOG_WARNING, format());
+    ASSERT_EQ(numFormatted, 1);
+#if CONIS_MIN_LOG_LEVEL > 0
+    // Compiled out, even though the level is enabled at runtime
+    setLogLevel(LOG_TRACE);
+    CONIS_LOG(LOG_TRACE, format());
+    ASSERT_EQ(numFormatted, 1);
+#endif
+    flushLog();
+    ASSERT_EQ(messages.size(), 1);
+}
+
+TEST(ProgressTest, TestSubdivisionProgress) {
+    SubdivisionSettings settings;
+    ConicSubdivider subdivider(settings);
+    std::vector<std::pair<int, int>> progress;
+    subdivider.setProgressCallback(
+        [&](std::string_view, const int done, const int total) { progress.emplace_back(done, total); });
+    auto [points, normals] = test::circle(6, 0, 0, 5);
+    Curve curve(points, normals, true);
+    subdivider.subdivide(curve, 3);
+
+    ASSERT_EQ(progress, (std::vector<std::pair<int, int>>{{1, 3}, {2, 3}, {3, 3}}));
+}
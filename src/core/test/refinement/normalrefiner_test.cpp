@@ -0,0 +1,284 @@
+#include "conis/core/curve/refinement/normalrefinementsettings.hpp"
+#include "conis/core/curve/refinement/normalrefiner.hpp"
+#include "conis/core/curve/subdivision/conicsubdivider.hpp"
+#include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/memory.hpp"
+#include "test/test_helpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <omp.h>
+
+using namespace conis::core;
+
+// Ellipse with slightly rotated normals, so that the refinement has something to do
+static Curve perturbedEllipse(const bool closed) {
+    auto [points, normals] = test::ellipse(32, 0, 0, 5, 3);
+    for (int i = 0; i < static_cast<int>(normals.size()); i++) {
+        const real_t angle = (i % 3 - 1) * 0.05;
+        const Vector2DD n = normals[i];
+        normals[i] = {cos(angle) * n.x() - sin(angle) * n.y(), sin(angle) * n.x() + cos(angle) * n.y()};
+    }
+    return {points, normals, closed};
+}
+
+// Smoothness penalty of the vertex at idx as used by the normal refiner
+static real_t smoothnessPenalty(Curve curve, const int idx, const int level, const SubdivisionSettings &settings) {
+    ConicSubdivider subdivider(settings);
+    subdivider.subdivide(curve, level);
+    const int subdivIdx = idx * (1 << level);
+    const real_t prevCurvature = curve.curvatureAtIdx(curve.getPrevIdx(subdivIdx), AREA_INFLATION);
+    const real_t nextCurvature = curve.curvatureAtIdx(curve.getNextIdx(subdivIdx), AREA_INFLATION);
+    return std::max(prevCurvature, nextCurvature) / std::min(prevCurvature, nextCurvature);
+}
+
+static void assertWindowedMatchesFull(const bool closed) {
+    SubdivisionSettings subdivSettings;
+    // A lower test level than the default keeps the full evaluation fast enough for a unit test
+    NormalRefinementSettings windowedSettings;
+    windowedSettings.testSubdivLevel = 4;
+    windowedSettings.windowedEvaluation = true;
+    NormalRefinementSettings fullSettings = windowedSettings;
+    fullSettings.windowedEvaluation = false;
+    NormalRefiner windowedRefiner(windowedSettings, subdivSettings);
+    NormalRefiner fullRefiner(fullSettings, subdivSettings);
+
+    Curve windowedCurve = perturbedEllipse(closed);
+    Curve fullCurve = perturbedEllipse(closed);
+    // Includes the vertices close to the ends of the open curve, whose windows are clipped
+    for (const int idx: {0, 2, 16, 30}) {
+        windowedRefiner.refineSelected(windowedCurve, AREA_INFLATION, idx);
+        fullRefiner.refineSelected(fullCurve, AREA_INFLATION, idx);
+        ASSERT_NEAR((windowedCurve.getNormal(idx) - fullCurve.getNormal(idx)).norm(), 0, 1e-15) << "at index " << idx;
+    }
+}
+
+TEST(NormalRefinerTest, TestWindowedMatchesFullClosed) {
+    assertWindowedMatchesFull(true);
+}
+
+TEST(NormalRefinerTest, TestWindowedMatchesFullOpen) {
+    assertWindowedMatchesFull(false);
+}
+
+TEST(NormalRefinerTest, TestParallelCandidatesMatchSequential) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings sequentialSettings;
+    sequentialSettings.testSubdivLevel = 4;
+    // Only the bisection search evaluates two candidates at a time
+    sequentialSettings.searchMethod = BISECTION;
+    NormalRefinementSettings parallelSettings = sequentialSettings;
+    parallelSettings.parallel = true;
+    NormalRefiner sequentialRefiner(sequentialSettings, subdivSettings);
+    NormalRefiner parallelRefiner(parallelSettings, subdivSettings);
+
+    Curve sequentialCurve = perturbedEllipse(true);
+    Curve parallelCurve = perturbedEllipse(true);
+    for (const int idx: {0, 7}) {
+        sequentialRefiner.refineSelected(sequentialCurve, AREA_INFLATION, idx);
+        parallelRefiner.refineSelected(parallelCurve, AREA_INFLATION, idx);
+        ASSERT_EQ(parallelCurve.getNormal(idx), sequentialCurve.getNormal(idx)) << "at index " << idx;
+    }
+}
+
+TEST(NormalRefinerTest, TestParallelRefineIsDeterministic) {
+    SubdivisionSettings subdivSettings;
+    // Keep the refinement of the whole curve cheap
+    NormalRefinementSettings settings;
+    settings.testSubdivLevel = 3;
+    settings.angleLimit = 1e-3;
+    settings.parallel = true;
+    NormalRefiner refiner(settings, subdivSettings);
+
+    const int maxThreads = omp_get_max_threads();
+    Curve singleThreadCurve = perturbedEllipse(true);
+    omp_set_num_threads(1);
+    refiner.refine(singleThreadCurve, AREA_INFLATION);
+    Curve multiThreadCurve = perturbedEllipse(true);
+    omp_set_num_threads(4);
+    refiner.refine(multiThreadCurve, AREA_INFLATION);
+    omp_set_num_threads(maxThreads);
+
+    ASSERT_EQ(multiThreadCurve.numPoints(), singleThreadCurve.numPoints());
+    for (int i = 0; i < singleThreadCurve.numPoints(); i++) {
+        ASSERT_EQ(multiThreadCurve.getNormal(i), singleThreadCurve.getNormal(i)) << "at index " << i;
+    }
+}
+
+TEST(NormalRefinerTest, TestBrentMatchesBisectionWithFewerEvaluations) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings bisectionSettings;
+    bisectionSettings.testSubdivLevel = 4;
+    bisectionSettings.searchMethod = BISECTION;
+    NormalRefinementSettings brentSettings = bisectionSettings;
+    brentSettings.searchMethod = BRENT;
+    NormalRefiner bisectionRefiner(bisectionSettings, subdivSettings);
+    NormalRefiner brentRefiner(brentSettings, subdivSettings);
+
+    const Curve curve = perturbedEllipse(true);
+    const int level = bisectionSettings.testSubdivLevel;
+    for (const int idx: {0, 5, 13}) {
+        Curve bisectionCurve = curve;
+        Curve brentCurve = curve;
+        bisectionRefiner.refineSelected(bisectionCurve, AREA_INFLATION, idx);
+        brentRefiner.refineSelected(brentCurve, AREA_INFLATION, idx);
+        const real_t bisectionPenalty = smoothnessPenalty(bisectionCurve, idx, level, subdivSettings);
+        const real_t brentPenalty = smoothnessPenalty(brentCurve, idx, level, subdivSettings);
+        // Both stop at an angle resolution of about angleLimit. Close to the optimum the penalty changes by about 50 per
+        // radian, so either can be marginally better.
+        ASSERT_LE(brentPenalty, bisectionPenalty + 1e-3) << "at index " << idx;
+    }
+    ASSERT_GT(brentRefiner.getNumEvaluations(), 0);
+    // The initial search angles are small on this curve, so the bisection search needs fewer steps than usual
+    ASSERT_LT(brentRefiner.getNumEvaluations(), 0.75 * bisectionRefiner.getNumEvaluations());
+}
+
+TEST(NormalRefinerTest, TestAnalyticCurvatureReducesPenalty) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings settings;
+    settings.testSubdivLevel = 4;
+    settings.analyticCurvature = true;
+    NormalRefiner refiner(settings, subdivSettings);
+    ConicSubdivider subdivider(subdivSettings);
+    const auto analyticPenalty = [&](Curve curve, const int idx) {
+        std::vector<real_t> curvatures;
+        subdivider.subdivide(curve, settings.testSubdivLevel, curvatures);
+        const int subdivIdx = idx * (1 << settings.testSubdivLevel);
+        const real_t prevCurvature = curvatures[curve.getPrevIdx(subdivIdx)];
+        const real_t nextCurvature = curvatures[curve.getNextIdx(subdivIdx)];
+        return std::max(prevCurvature, nextCurvature) / std::min(prevCurvature, nextCurvature);
+    };
+
+    const Curve curve = perturbedEllipse(true);
+    for (const int idx: {0, 5, 13}) {
+        Curve refinedCurve = curve;
+        refiner.refineSelected(refinedCurve, AREA_INFLATION, idx);
+        ASSERT_LE(analyticPenalty(refinedCurve, idx), analyticPenalty(curve, idx)) << "at index " << idx;
+    }
+}
+
+TEST(NormalRefinerTest, TestGlobalRefinementIsSmootherThanSequential) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings sequentialSettings;
+    sequentialSettings.testSubdivLevel = 2;
+    NormalRefinementSettings globalSettings = sequentialSettings;
+    globalSettings.mode = GLOBAL;
+    globalSettings.maxGlobalIterations = 20;
+    NormalRefiner sequentialRefiner(sequentialSettings, subdivSettings);
+    NormalRefiner globalRefiner(globalSettings, subdivSettings);
+
+    Curve sequentialCurve = perturbedEllipse(true);
+    Curve globalCurve = perturbedEllipse(true);
+    sequentialRefiner.refine(sequentialCurve, AREA_INFLATION);
+    globalRefiner.refine(globalCurve, AREA_INFLATION);
+
+    const int level = sequentialSettings.testSubdivLevel;
+    real_t sequentialMax = 0;
+    real_t globalMax = 0;
+    for (int i = 0; i < globalCurve.numPoints(); i++) {
+        sequentialMax = std::max(sequentialMax, smoothnessPenalty(sequentialCurve, i, level, subdivSettings));
+        globalMax = std::max(globalMax, smoothnessPenalty(globalCurve, i, level, subdivSettings));
+    }
+    ASSERT_LT(globalMax, 1.01);
+    ASSERT_LE(globalMax, sequentialMax);
+}
+
+TEST(NormalRefinerTest, TestParallelGlobalRefinementMatchesSequential) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings sequentialSettings;
+    sequentialSettings.testSubdivLevel = 2;
+    sequentialSettings.mode = GLOBAL;
+    sequentialSettings.maxGlobalIterations = 3;
+    NormalRefinementSettings parallelSettings = sequentialSettings;
+    parallelSettings.parallel = true;
+    NormalRefiner sequentialRefiner(sequentialSettings, subdivSettings);
+    NormalRefiner parallelRefiner(parallelSettings, subdivSettings);
+
+    const int maxThreads = omp_get_max_threads();
+    Curve sequentialCurve = perturbedEllipse(false);
+    sequentialRefiner.refine(sequentialCurve, AREA_INFLATION);
+    Curve parallelCurve = perturbedEllipse(false);
+    omp_set_num_threads(4);
+    parallelRefiner.refine(parallelCurve, AREA_INFLATION);
+    omp_set_num_threads(maxThreads);
+
+    ASSERT_EQ(parallelCurve.numPoints(), sequentialCurve.numPoints());
+    for (int i = 0; i < sequentialCurve.numPoints(); i++) {
+        ASSERT_EQ(parallelCurve.getNormal(i), sequentialCurve.getNormal(i)) << "at index " << i;
+    }
+}
+
+TEST(NormalRefinerTest, TestMemoryResourceDoesNotChangeResult) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings settings;
+    settings.testSubdivLevel = 2;
+    settings.maxRefinementIterations = 2;
+    settings.maxGlobalIterations = 2;
+    NormalRefiner defaultRefiner(settings, subdivSettings);
+    NormalRefiner arenaRefiner(settings, subdivSettings);
+    // An arena that is only released with the refiner
+    std::pmr::monotonic_buffer_resource arena;
+    CountingResource resource(&arena);
+    arenaRefiner.setMemoryResource(&resource);
+
+    for (const NormalRefinementMode mode: {SEQUENTIAL, GLOBAL}) {
+        settings.mode = mode;
+        Curve expected = perturbedEllipse(true);
+        Curve curve = perturbedEllipse(true);
+        defaultRefiner.refine(expected, AREA_INFLATION);
+        arenaRefiner.refine(curve, AREA_INFLATION);
+        for (int i = 0; i < expected.numPoints(); i++) {
+            ASSERT_EQ(curve.getNormal(i), expected.getNormal(i)) << "at index " << i;
+        }
+    }
+    const AllocationStats stats = resource.stats();
+    ASSERT_GT(stats.numAllocations, 0);
+    ASSERT_LE(stats.bytesInUse, stats.peakBytesInUse);
+}
+
+TEST(NormalRefinerTest, TestDirtyTrackingMatchesFullSweeps) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings trackedSettings;
+    trackedSettings.testSubdivLevel = 2;
+    trackedSettings.angleLimit = 1e-3;
+    trackedSettings.maxRefinementIterations = 3;
+    // Any rotation marks the window dirty, so skipping a vertex cannot change the result
+    trackedSettings.convergenceAngle = 0;
+    NormalRefinementSettings fullSettings = trackedSettings;
+    fullSettings.convergenceAngle = -1;
+    NormalRefiner trackedRefiner(trackedSettings, subdivSettings);
+    NormalRefiner fullRefiner(fullSettings, subdivSettings);
+
+    // The parallel refinement marks the windows of a colour after the entire colour round
+    for (const auto &[closed, parallel]: {std::pair{true, false}, std::pair{false, false}, std::pair{true, true}}) {
+        trackedSettings.parallel = parallel;
+        fullSettings.parallel = parallel;
+        Curve trackedCurve = perturbedEllipse(closed);
+        Curve fullCurve = perturbedEllipse(closed);
+        trackedRefiner.refine(trackedCurve, AREA_INFLATION);
+        fullRefiner.refine(fullCurve, AREA_INFLATION);
+        for (int i = 0; i < fullCurve.numPoints(); i++) {
+            ASSERT_EQ(trackedCurve.getNormal(i), fullCurve.getNormal(i)) << "at index " << i;
+        }
+        ASSERT_LE(trackedRefiner.getNumEvaluations(), fullRefiner.getNumEvaluations());
+    }
+}
+
+TEST(NormalRefinerTest, TestDirtyTrackingStopsWhenConverged) {
+    SubdivisionSettings subdivSettings;
+    NormalRefinementSettings settings;
+    settings.testSubdivLevel = 2;
+    settings.angleLimit = 1e-3;
+    settings.convergenceAngle = 1e-2;
+    settings.maxRefinementIterations = 1;
+    NormalRefiner refiner(settings, subdivSettings);
+    Curve curve = perturbedEllipse(true);
+    refiner.refine(curve, AREA_INFLATION);
+    const uint64_t sweepEvaluations = refiner.getNumEvaluations();
+
+    // At this level the largest rotation drops below the convergence angle after a few sweeps
+    settings.maxRefinementIterations = 100;
+    curve = perturbedEllipse(true);
+    refiner.refine(curve, AREA_INFLATION);
+    ASSERT_LT(refiner.getNumEvaluations(), 5 * sweepEvaluations);
+}
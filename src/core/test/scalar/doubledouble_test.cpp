@@ -0,0 +1,48 @@
+#include "conis/core/doubledouble.hpp"
+#include <Eigen/Core>
+#include <Eigen/SVD>
+#include <gtest/gtest.h>
+
+using namespace conis::core;
+
+// Tests: arithmetic precision of the double-double type
+
+TEST(DoubleDoubleTest, DivisionRoundTrip) {
+    const DoubleDouble third = DoubleDouble(1.0) / 3.0;
+    const DoubleDouble residual = third * 3.0 - 1.0;
+    ASSERT_LT(std::abs(static_cast<double>(residual)), 1e-30);
+    // A plain double cannot represent this difference
+    ASSERT_NE(static_cast<double>(third.lo()), 0.0);
+}
+
+TEST(DoubleDoubleTest, SquareRoot) {
+    const DoubleDouble root = sqrt(DoubleDouble(2.0));
+    ASSERT_LT(std::abs(static_cast<double>(root * root - 2.0)), 1e-30);
+    ASSERT_EQ(static_cast<double>(sqrt(DoubleDouble(0.0))), 0.0);
+}
+
+TEST(DoubleDoubleTest, CancellationIsExact) {
+    const DoubleDouble big(1e20);
+    const DoubleDouble sum = big + 1.0;
+    ASSERT_EQ(static_cast<double>(sum - big), 1.0);
+}
+
+TEST(DoubleDoubleTest, InfinityPropagates) {
+    const DoubleDouble inf(std::numeric_limits<double>::infinity());
+    ASSERT_TRUE(isinf(inf + 1.0));
+    ASSERT_TRUE(isinf(inf * 2.0));
+    ASSERT_FALSE(isnan(inf * 2.0));
+}
+
+// Tests: DoubleDouble as an Eigen scalar
+
+TEST(DoubleDoubleTest, EigenSvdNullSpace) {
+    Eigen::Matrix<DoubleDouble, 3, 3> A;
+    A << 1, 2, 3, 4, 5, 6, 7, 8, 9;
+    Eigen::JacobiSVD<Eigen::Matrix<DoubleDouble, 3, 3>> svd(A, Eigen::ComputeFullV);
+    const Eigen::Matrix<DoubleDouble, 3, 1> nullVec = svd.matrixV().col(2);
+    const Eigen::Matrix<DoubleDouble, 3, 1> residual = A * nullVec;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_LT(std::abs(static_cast<double>(residual[i])), 1e-14);
+    }
+}
@@ -0,0 +1,71 @@
+#include "util/fastmath.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace conis::core;
+
+// Tests: the documented maximum errors of the fast math approximations
+
+constexpr int numSamples = 100000;
+
+static long double ulpError(const double value, const long double expected) {
+    const double rounded = static_cast<double>(expected);
+    const double ulp = std::nextafter(std::abs(rounded), std::numeric_limits<double>::infinity()) - std::abs(rounded);
+    return std::abs(value - expected) / ulp;
+}
+
+TEST(FastMathTest, SinCos) {
+    for (int i = 0; i <= numSamples; i++) {
+        // Both small angles and large ones that need range reduction
+        for (const double range: {4.0, 1e5}) {
+            const double x = range * (2.0 * i / numSamples - 1.0) + 0.1234;
+            ASSERT_LT(std::abs(fastmath::sin(x) - std::sin(static_cast<long double>(x))), 2e-16) << "at x = " << x;
+            ASSERT_LT(std::abs(fastmath::cos(x) - std::cos(static_cast<long double>(x))), 2e-16) << "at x = " << x;
+        }
+    }
+}
+
+TEST(FastMathTest, Tan) {
+    for (int i = 0; i <= numSamples; i++) {
+        const double x = M_PI / 4.0 * (2.0 * i / numSamples - 1.0);
+        if (x == 0.0) {
+            continue;
+        }
+        ASSERT_LT(ulpError(fastmath::tan(x), std::tan(static_cast<long double>(x))), 4) << "at x = " << x;
+    }
+}
+
+TEST(FastMathTest, Atan) {
+    for (int i = 1; i <= numSamples; i++) {
+        // Logarithmically spaced in [1e-8, 1e8] to cover all three argument reductions
+        const double x = std::pow(10.0, 16.0 * i / numSamples - 8.0);
+        ASSERT_LT(ulpError(fastmath::atan(x), std::atan(static_cast<long double>(x))), 4) << "at x = " << x;
+        ASSERT_EQ(fastmath::atan(-x), -fastmath::atan(x));
+    }
+    ASSERT_EQ(fastmath::atan(0.0), 0.0);
+    ASSERT_EQ(fastmath::atan(std::numeric_limits<double>::infinity()), M_PI / 2.0);
+    ASSERT_TRUE(std::isnan(fastmath::atan(std::numeric_limits<double>::quiet_NaN())));
+}
+
+TEST(FastMathTest, Acos) {
+    for (int i = 0; i <= numSamples; i++) {
+        const double x = 2.0 * i / numSamples - 1.0;
+        ASSERT_LT(std::abs(fastmath::acos(x) - std::acos(static_cast<long double>(x))), 7e-16) << "at x = " << x;
+    }
+    // Close to the end points, where acos is steep
+    for (int e = 1; e < 53; e++) {
+        const double x = 1.0 - std::ldexp(1.0, -e);
+        ASSERT_LT(std::abs(fastmath::acos(x) - std::acos(static_cast<long double>(x))), 7e-16) << "at x = " << x;
+        ASSERT_LT(std::abs(fastmath::acos(-x) - std::acos(static_cast<long double>(-x))), 7e-16) << "at x = " << -x;
+    }
+    ASSERT_EQ(fastmath::acos(1.0), 0.0);
+    ASSERT_TRUE(std::isnan(fastmath::acos(1.0 + 1e-12)));
+}
+
+TEST(FastMathTest, ExtendedPrecisionInput) {
+    // Extended precision types are evaluated in double and converted back
+    const long double x = 0.5L;
+    ASSERT_LT(std::abs(fastmath::atan(x) - std::atan(x)), 1e-15L);
+    ASSERT_LT(std::abs(fastmath::acos(x) - std::acos(x)), 1e-15L);
+}
@@ -1,9 +1,13 @@
+#include "conis/core/curve/compactcurve.hpp"
+#include "conis/core/curve/curveloader.hpp"
 #include "conis/core/curve/curvepresetfactory.hpp"
 #include "conis/core/curve/curvesaver.hpp"
 #include "conis/core/curve/subdivision/conicsubdivider.hpp"
 #include "conis/core/curve/subdivision/subdivisionsettings.hpp"
+#include "conis/core/memory.hpp"
 #include "conis/core/vector.hpp"
 #include "test/test_helpers.hpp"
+#include <filesystem>
 #include <gtest/gtest.h>
 
 using namespace conis::core;
@@ -175,6 +179,48 @@ TEST(ConicSubdivisionTest, TestSubdivisionCircle) {
     }
 }
 
+TEST(ConicSubdivisionTest, TestPatchBuffersAreReused) {
+    SubdivisionSettings settings;
+    ConicSubdivider defaultSubdivider(settings);
+    ConicSubdivider countedSubdivider(settings);
+    CountingResource resource;
+    countedSubdivider.setMemoryResource(&resource);
+
+    auto [points, normals] = test::ellipse(12, 0, 0, 5, 3);
+    Curve expected(points, normals, true);
+    defaultSubdivider.subdivide(expected, 6);
+    for (int i = 0; i < 2; i++) {
+        Curve curve(points, normals, true);
+        countedSubdivider.subdivide(curve, 6);
+        ASSERT_EQ(curve.getVertices(), expected.getVertices());
+        ASSERT_EQ(curve.getNormals(), expected.getNormals());
+        // The buffers only grow during the first subdivision
+        ASSERT_EQ(resource.stats().numAllocations > 0, i == 0);
+        resource.resetStats();
+    }
+}
+
+TEST(ConicSubdivisionTest, TestAnalyticCurvatureCircle) {
+    SubdivisionSettings settings;
+    ConicSubdivider subdivider(settings);
+    const int numPoints = 6;
+    const int level = 3;
+    auto [points, normals] = test::circle(numPoints, 0, 0, 5);
+    Curve curve(points, normals, true);
+    std::vector<real_t> curvatures;
+    subdivider.subdivide(curve, level, curvatures);
+
+    ASSERT_EQ(curvatures.size(), curve.numPoints());
+    for (int i = 0; i < curve.numPoints(); i++) {
+        if (i % (1 << level) == 0) {
+            // The control points were not sampled from a conic
+            ASSERT_TRUE(std::isnan(curvatures[i])) << "at index " << i;
+        } else {
+            ASSERT_NEAR(curvatures[i], 0.2, 1e-12) << "at index " << i;
+        }
+    }
+}
+
 // 4x*x + 9y*y = 36
 TEST(ConicSubdivisionTest, TestSubdivisionEllipse) {
     SubdivisionSettings settings;
@@ -286,3 +332,131 @@ TEST(ConicSubdivisionTest, TestSubdivisionG) {
         std::cout << i << ", " << meanAngleError << ", " << maxAngleError << std::endl;
     }
 }
+
+TEST(ConicSubdivisionTest, TestMixedPrecisionMatchesFullPrecision) {
+    SubdivisionSettings settings;
+    ConicSubdivider subdivider(settings);
+    const int subdivLevel = 8;
+
+    auto [points, normals] = test::ellipse(6, 0, 0, 5, 3);
+    Curve fullCurve(points, normals, true);
+    const Curve controlCurve = fullCurve;
+    subdivider.subdivide(fullCurve, subdivLevel);
+
+    settings.fullPrecisionLevels = 5;
+    CompactCurve<double> doubleCurve;
+    subdivider.subdivide(controlCurve, subdivLevel, doubleCurve);
+    CompactCurve<float> floatCurve;
+    subdivider.subdivide(controlCurve, subdivLevel, floatCurve);
+
+    ASSERT_EQ(doubleCurve.numPoints(), fullCurve.numPoints());
+    ASSERT_EQ(floatCurve.numPoints(), fullCurve.numPoints());
+    ASSERT_EQ(doubleCurve.isClosed(), fullCurve.isClosed());
+    for (int i = 0; i < fullCurve.numPoints(); i++) {
+        const Vector2DD &expected = fullCurve.getVertex(i);
+        ASSERT_NEAR((doubleCurve.getVertex(i).cast<real_t>() - expected).norm(), 0, 1e-9) << "at index " << i;
+        ASSERT_NEAR((floatCurve.getVertex(i).cast<real_t>() - expected).norm(), 0, 1e-2) << "at index " << i;
+    }
+    // The control points are never moved
+    for (int i = 0; i < controlCurve.numPoints(); i++) {
+        ASSERT_EQ(doubleCurve.getVertex(i * (1 << subdivLevel)), controlCurve.getVertex(i).cast<double>());
+    }
+}
+
+TEST(ConicSubdivisionTest, TestFastMathMatchesLibm) {
+    SubdivisionSettings settings;
+    // Also exercise the acos calls of the weighted inflection point location
+    settings.weightedInflPointLocation = true;
+    ConicSubdivider subdivider(settings);
+    CurveLoader loader;
+    const int subdivLevel = 4;
+
+    int numCurves = 0;
+    for (const auto &entry: std::filesystem::directory_iterator(CONIS_CURVES_DIR)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".txt") {
+            continue;
+        }
+        const Curve controlCurve = loader.loadCurveFromFile(entry.path().string());
+        if (controlCurve.numPoints() < 3) {
+            continue;
+        }
+        numCurves++;
+        Curve libmCurve = controlCurve;
+        settings.fastMath = false;
+        subdivider.subdivide(libmCurve, subdivLevel);
+        Curve fastCurve = controlCurve;
+        settings.fastMath = true;
+        subdivider.subdivide(fastCurve, subdivLevel);
+
+        ASSERT_EQ(fastCurve.numPoints(), libmCurve.numPoints()) << entry.path().filename();
+        for (int i = 0; i < libmCurve.numPoints(); i++) {
+            // The inflection point placement is only accurate up to double precision, which the fits amplify slightly
+            ASSERT_NEAR((fastCurve.getVertex(i) - libmCurve.getVertex(i)).norm(), 0, 1e-6)
+                << entry.path().filename() << " at index " << i;
+            // The normals are not normalized
+            ASSERT_NEAR((fastCurve.getNormal(i).normalized() - libmCurve.getNormal(i).normalized()).norm(), 0, 1e-5)
+                << entry.path().filename() << " at index " << i;
+            // Same curve, so that only the curvature approximation is compared. It is undefined at the end points of
+            // open curves.
+            const real_t curvature = libmCurve.curvatureAtIdx(i, AREA_INFLATION, false);
+            const real_t fastCurvature = libmCurve.curvatureAtIdx(i, AREA_INFLATION, true);
+            ASSERT_EQ(std::isnan(fastCurvature), std::isnan(curvature));
+            if (!std::isnan(curvature)) {
+                ASSERT_NEAR(fastCurvature, curvature, 1e-9 * (1 + curvature))
+                    << entry.path().filename() << " at index " << i;
+            }
+        }
+    }
+    ASSERT_GT(numCurves, 0);
+}
+
+TEST(ConicSubdivisionTest, TestDualDerivativesMatchFiniteDifferences) {
+    SubdivisionSettings settings;
+    ConicSubdivider subdivider(settings);
+    const int subdivLevel = 2;
+    // Pulling in a vertex creates a concave section, so that the inflection points are differentiated as well
+    auto [points, normals] = test::ellipse(8, 0, 0, 5, 3);
+    points[0] = {2, 0};
+    const Curve controlCurve(points, true);
+    const int normalIdx = 1;
+    const int vertexIdx = 0;
+
+    // Input 0 rotates the normal at normalIdx, input 1 moves the vertex at vertexIdx horizontally
+    CompactCurve<Dual> dualCurve(controlCurve);
+    const Vector2DD &n = controlCurve.getNormal(normalIdx);
+    Eigen::VectorXd rotation = Eigen::VectorXd::Zero(2);
+    rotation[0] = 1;
+    dualCurve.setNormal(normalIdx, {Dual(n.x(), -n.y() * rotation), Dual(n.y(), n.x() * rotation)});
+    const Vector2DD &v = controlCurve.getVertex(vertexIdx);
+    dualCurve.setVertex(vertexIdx, {dualInput(v.x(), 2, 1), Dual(v.y())});
+    CompactCurve<Dual> dualResult;
+    subdivider.subdivide(dualCurve, subdivLevel, dualResult);
+
+    const real_t h = 1e-6;
+    const auto subdivideWith = [&](const real_t angle, const real_t dx) {
+        Curve curve = controlCurve;
+        curve.setCustomNormal(normalIdx,
+                              {cos(angle) * n.x() - sin(angle) * n.y(), sin(angle) * n.x() + cos(angle) * n.y()});
+        curve.setVertex(vertexIdx, {v.x() + dx, v.y()});
+        subdivider.subdivide(curve, subdivLevel);
+        return curve;
+    };
+    const Curve normalPlus = subdivideWith(h, 0);
+    const Curve normalMin = subdivideWith(-h, 0);
+    const Curve vertexPlus = subdivideWith(0, h);
+    const Curve vertexMin = subdivideWith(0, -h);
+
+    ASSERT_EQ(dualResult.numPoints(), normalPlus.numPoints());
+    ASSERT_GT(dualResult.numPoints(), controlCurve.numPoints() * (1 << subdivLevel));
+    for (int i = 0; i < dualResult.numPoints(); i++) {
+        const Vector2DD normalDiff = (normalPlus.getVertex(i) - normalMin.getVertex(i)) / (2 * h);
+        const Vector2DD vertexDiff = (vertexPlus.getVertex(i) - vertexMin.getVertex(i)) / (2 * h);
+        for (int d = 0; d < 2; d++) {
+            // Constants have an empty derivative vector
+            const Dual coord = dualResult.getVertex(i)[d];
+            const Eigen::VectorXd &derivatives = coord.derivatives();
+            ASSERT_NEAR(derivatives.size() > 0 ? derivatives[0] : 0, normalDiff[d], 1e-6) << "at index " << i;
+            ASSERT_NEAR(derivatives.size() > 1 ? derivatives[1] : 0, vertexDiff[d], 1e-6) << "at index " << i;
+        }
+    }
+}
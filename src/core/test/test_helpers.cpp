@@ -32,12 +32,12 @@ PointNormalPairs circle(int numPoints, real_t x, real_t y, real_t radius) {
         real_t angle = i * angleStep;
 
         // Calculate point on the circle
-        real_t px = x + radius * std::cos(angle);
-        real_t py = y + radius * std::sin(angle);
+        real_t px = x + radius * cos(angle);
+        real_t py = y + radius * sin(angle);
         points.emplace_back(px, py);
 
         // Normal is the direction pointing outwards from the center
-        Vector2DD normal(std::cos(angle), std::sin(angle));
+        Vector2DD normal(cos(angle), sin(angle));
         normals.push_back(normal);
     }
 
@@ -54,12 +54,12 @@ PointNormalPairs ellipse(int numPoints, real_t x, real_t y, real_t a, real_t b)
         real_t angle = i * angleStep;
 
         // Parametric ellipse equation
-        real_t px = x + a * std::cos(angle);
-        real_t py = y + b * std::sin(angle);
+        real_t px = x + a * cos(angle);
+        real_t py = y + b * sin(angle);
         points.emplace_back(px, py);
 
         // Normal is perpendicular to the tangent at (a*cos(theta), b*sin(theta))
-        Vector2DD normal(b * std::cos(angle), a * std::sin(angle));
+        Vector2DD normal(b * cos(angle), a * sin(angle));
         normal.normalize();
         normals.push_back(normal);
     }
@@ -79,7 +79,7 @@ PointNormalPairs hyperbolaSingleBranch(int numPoints) {
     for (int i = 0; i < numPoints; ++i) {
         real_t px = startX + i * step; // x values spaced linearly
         // y^2 - 4x^2 = 4 -> y = +-sqrt(4 + 4x^2), we only take + to ensure we are on a single branch
-        real_t py = std::sqrt(4 * (px * px) + 4);
+        real_t py = sqrt(4 * (px * px) + 4);
         points.emplace_back(px, py);
 
         // Gradient for normal calculation
@@ -118,4 +118,13 @@ PointNormalPairs parabola(int numPoints) {
     return {points, normals};
 }
 
+PointNormalPairs noisyEllipse(int numPoints, real_t a, real_t b, double noise, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> offset(-noise, noise);
+    auto [points, normals] = ellipse(numPoints, 0, 0, a, b);
+    for (auto &p: points) {
+        p += Vector2DD(offset(rng), offset(rng));
+    }
+    return {points, normals};
+}
+
 } // namespace conis::core::test
@@ -1,6 +1,7 @@
 #pragma once
 #include "conis/core/vector.hpp"
 
+#include <random>
 #include <utility>
 
 namespace conis::core::test {
@@ -11,4 +12,6 @@ PointNormalPairs circle(int numPoints, real_t x, real_t y, real_t radius);
 PointNormalPairs ellipse(int numPoints, real_t x, real_t y, real_t a, real_t b);
 PointNormalPairs hyperbolaSingleBranch(int numPoints); // 4x^2-y^2=4
 PointNormalPairs parabola(int numPoints);              // 2x^2 - 2y = 0
+// Ellipse centred at the origin with every point moved by up to noise in x and y. The normals are those of the ellipse.
+PointNormalPairs noisyEllipse(int numPoints, real_t a, real_t b, double noise, std::mt19937 &rng);
 } // namespace conis::core::test
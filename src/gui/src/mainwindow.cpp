@@ -73,6 +73,7 @@ QDockWidget *MainWindow::initSideMenu() {
         subdivStepsSpinBox->setVal(0);
         presetLabel->setText(QString("<b>Preset:</b> %1").arg(QString::fromStdString(presetName)));
         viewSettings_.selectedVertex = -1;
+        conisCurve.checkpoint();
         conisCurve.setControlCurve(presetFactory_.getPreset(presetName));
         closedCurveAction->setChecked(conisCurve.getControlCurve().isClosed());
     });
@@ -92,6 +93,9 @@ QDockWidget *MainWindow::initSideMenu() {
         auto &conisCurve = sceneView_->getConisCurve();
         auto curv = conisCurve.getSubdivCurve();
         viewSettings_.selectedVertex = -1;
+        conisCurve.checkpoint();
+        // Resetting the spin box subdivides as well
+        core::EditBatch batch(conisCurve);
         conisCurve.setControlCurve(curv);
         subdivStepsSpinBox->setVal(0);
     });
@@ -101,6 +105,7 @@ QDockWidget *MainWindow::initSideMenu() {
     insertInflPointsButton->setToolTip("<html><head/><body><p>If pressed, inserts inflection points.</body></html>");
     connect(insertInflPointsButton, &QPushButton::pressed, [this] {
         auto &conisCurve = sceneView_->getConisCurve();
+        conisCurve.checkpoint();
         conisCurve.insertInflectionPoints();
     });
     vertLayout->addWidget(insertInflPointsButton);
@@ -255,6 +260,7 @@ QDockWidget *MainWindow::initSideMenu() {
     auto *recalcButton = new QPushButton("Reset Normals");
     connect(recalcButton, &QPushButton::pressed, this, [this] {
         auto &conisCurve = sceneView_->getConisCurve();
+        conisCurve.checkpoint();
         conisCurve.recalculateNormals();
     });
     vertLayout->addWidget(recalcButton);
@@ -395,6 +401,7 @@ QDockWidget *MainWindow::initSideMenu() {
 QMenuBar *MainWindow::initMenuBar() {
     auto *menuBar = new QMenuBar();
     menuBar->addMenu(getFileMenu());
+    menuBar->addMenu(getEditMenu());
     menuBar->addMenu(getPresetMenu());
     menuBar->addMenu(getRenderMenu());
     menuBar->addMenu(getWindowMenu());
@@ -438,6 +445,7 @@ QMenu *MainWindow::getFileMenu() {
         conis::core::Curve curve = loader.loadCurveFromFile(filePath.toStdString());
         auto &conisCurve = sceneView_->getConisCurve();
         viewSettings_.selectedVertex = -1;
+        conisCurve.checkpoint();
         conisCurve.setControlCurve(curve);
         subdivStepsSpinBox->setVal(0);
         closedCurveAction->setChecked(curve.isClosed());
@@ -477,8 +485,8 @@ QMenu *MainWindow::getFileMenu() {
             char *file_name;
             file_name = bytes.data();
             core::CurveSaver saver;
-            auto &conisCurve = sceneView_->getConisCurve();
-            bool success = saver.saveCurve(file_name, conisCurve.getSubdivCurve());
+            const auto snapshot = sceneView_->getConisCurve().getSnapshot();
+            bool success = saver.saveCurve(file_name, snapshot->subdivCurve);
 
             if (success) {
                 QMessageBox::information(this, "Curve Saved", filePath);
@@ -502,8 +510,8 @@ QMenu *MainWindow::getFileMenu() {
             file_name = bytes.data();
 
             core::CurveSaver saver;
-            auto &conisCurve = sceneView_->getConisCurve();
-            bool success = saver.saveCurveWithNormals(file_name, conisCurve.getSubdivCurve());
+            const auto snapshot = sceneView_->getConisCurve().getSnapshot();
+            bool success = saver.saveCurveWithNormals(file_name, snapshot->subdivCurve);
 
             if (success) {
                 QMessageBox::information(this, "Curve Saved", filePath);
@@ -526,6 +534,32 @@ QMenu *MainWindow::getFileMenu() {
     return fileMenu;
 }
 
+QMenu *MainWindow::getEditMenu() {
+    auto *editMenu = new QMenu("Edit");
+
+    auto *undoAction = new QAction(QStringLiteral("Undo"), editMenu);
+    undoAction->setShortcut(QKeySequence::Undo);
+    connect(undoAction, &QAction::triggered, [this]() {
+        auto &conisCurve = sceneView_->getConisCurve();
+        viewSettings_.selectedVertex = -1;
+        conisCurve.undo();
+        closedCurveAction->setChecked(conisCurve.getControlCurve().isClosed());
+    });
+    editMenu->addAction(undoAction);
+
+    auto *redoAction = new QAction(QStringLiteral("Redo"), editMenu);
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(redoAction, &QAction::triggered, [this]() {
+        auto &conisCurve = sceneView_->getConisCurve();
+        viewSettings_.selectedVertex = -1;
+        conisCurve.redo();
+        closedCurveAction->setChecked(conisCurve.getControlCurve().isClosed());
+    });
+    editMenu->addAction(redoAction);
+
+    return editMenu;
+}
+
 QMenu *MainWindow::getPresetMenu() {
     auto *presetMenu = new QMenu("Presets");
 
@@ -537,6 +571,7 @@ QMenu *MainWindow::getPresetMenu() {
             auto &conisCurve = sceneView_->getConisCurve();
             presetName = name;
             viewSettings_.selectedVertex = -1;
+            conisCurve.checkpoint();
             conisCurve.setControlCurve(presetFactory_.getPreset(presetName));
             presetLabel->setText(QString("<b>Preset:</b> %1").arg(QString::fromStdString(name)));
             subdivStepsSpinBox->setVal(0);
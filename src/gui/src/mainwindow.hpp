@@ -52,6 +52,8 @@ private:
 
     QMenu *getFileMenu();
 
+    QMenu *getEditMenu();
+
     QMenu *getWindowMenu();
 
     void resetView();
@@ -129,6 +129,52 @@ void CurveRenderer::updateBuffers(const conis::core::Curve &curve) {
     vboSize_ = indices.size();
 }
 
+void CurveRenderer::updateBuffers(const conis::core::Curve &curve, const conis::core::CurveChanges &changes) {
+    if (changes.resized || vboSize_ == 0) {
+        updateBuffers(curve);
+        return;
+    }
+    // The number of points is unchanged, so the index buffer stays valid
+    const auto &coords = curve.getVertices();
+    const auto &coordNormals = curve.getNormals();
+    for (const auto &range: changes.ranges) {
+        const int count = range.end - range.begin;
+        const std::vector<core::Vector2DD> rangeVerts(coords.begin() + range.begin, coords.begin() + range.end);
+        const std::vector<core::Vector2DD> rangeNormals(coordNormals.begin() + range.begin,
+                                                        coordNormals.begin() + range.end);
+        const std::vector<QVector2D> verts = qVecToVec(rangeVerts);
+        std::vector<QVector2D> normals = qVecToVec(rangeNormals);
+        for (auto &norm: normals) {
+            norm *= settings_.curvatureSign;
+            norm.normalize();
+        }
+
+        gl_->glBindBuffer(GL_ARRAY_BUFFER, vbo_[COORDS_IDX]);
+        gl_->glBufferSubData(GL_ARRAY_BUFFER, sizeof(QVector2D) * range.begin, sizeof(QVector2D) * count, verts.data());
+
+        gl_->glBindBuffer(GL_ARRAY_BUFFER, vbo_[NORM_IDX]);
+        gl_->glBufferSubData(GL_ARRAY_BUFFER,
+                             sizeof(QVector2D) * range.begin,
+                             sizeof(QVector2D) * count,
+                             normals.data());
+
+#if SHADER_DOUBLE_PRECISION
+        std::vector<double> doubleData;
+        doubleData.reserve(count * 2);
+        for (const auto &v: rangeVerts) {
+            doubleData.push_back(double(v.x()));
+            doubleData.push_back(double(v.y()));
+        }
+
+        gl_->glBindBuffer(GL_ARRAY_BUFFER, vbo_[DOUBLE_IDX]);
+        gl_->glBufferSubData(GL_ARRAY_BUFFER,
+                             sizeof(double) * 2 * range.begin,
+                             sizeof(double) * doubleData.size(),
+                             doubleData.data());
+#endif
+    }
+}
+
 void CurveRenderer::draw() {
     if (vboSize_ == 0) {
         return;
@@ -3,6 +3,7 @@
 #include <QOpenGLShaderProgram>
 #include <QOpenGLTexture>
 
+#include "conis/core/changeset.hpp"
 #include "conis/core/curve/curve.hpp"
 #include "renderer.hpp"
 #include "shadertypes.hpp"
@@ -16,6 +17,12 @@ public:
     ~CurveRenderer() override;
 
     void updateBuffers(const core::Curve &curve);
+    /**
+     * @brief Only uploads the changed points of the curve. Falls back to a full upload if the curve was resized.
+     * @param curve The curve, which should be the one that was last uploaded apart from the given changes.
+     * @param changes The changed points.
+     */
+    void updateBuffers(const core::Curve &curve, const core::CurveChanges &changes);
 
     void draw();
 
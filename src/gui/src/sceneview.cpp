@@ -9,6 +9,7 @@
 #include <iostream>
 #include <utility>
 
+#include "conis/core/log.hpp"
 #include "conis/core/vector.hpp"
 
 namespace conis::gui {
@@ -29,10 +30,13 @@ SceneView::SceneView(ViewSettings &settings, ConisCurve &conisCurve, QWidget *pa
     resetViewMatrix();
     setMouseTracking(true);
     conisCurve_.addListener(this);
+    // Edits are delivered once per frame (see paintGL) instead of after every single edit
+    conisCurve_.setNotificationScheduler([this] { update(); });
 }
 
 SceneView::~SceneView() {
     debugLogger_->stopLogging();
+    conisCurve_.setNotificationScheduler({});
     conisCurve_.removeListener(this);
 }
 
@@ -72,6 +76,9 @@ void SceneView::resizeGL(const int width, const int height) {
 }
 
 void SceneView::paintGL() {
+    // Uploads the changes made since the previous frame; the context is current here
+    conisCurve_.flushNotifications();
+
     const QColor bCol = settings_.style.backgroundCol;
     glClearColor(bCol.redF(), bCol.greenF(), bCol.blueF(), 1);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -127,13 +134,22 @@ void SceneView::resetViewMatrix() {
 }
 
 void SceneView::updateBuffers() {
-    cr_.updateBuffers(conisCurve_.getSubdivCurve());
-    cnr_.updateBuffers(conisCurve_.getControlCurve());
+    // A single snapshot, so that both renderers show the same state
+    const auto snapshot = conisCurve_.getSnapshot();
+    cr_.updateBuffers(snapshot->subdivCurve);
+    cnr_.updateBuffers(snapshot->controlCurve);
     repaint();
 }
 
-void SceneView::onListenerUpdated() {
-    updateBuffers();
+void SceneView::onListenerUpdated(const ChangeSet &changes) {
+    // Called from paintGL, so there is no need to repaint
+    const auto snapshot = conisCurve_.getSnapshot();
+    if (!changes.subdiv.empty()) {
+        cr_.updateBuffers(snapshot->subdivCurve, changes.subdiv);
+    }
+    if (!changes.control.empty()) {
+        cnr_.updateBuffers(snapshot->controlCurve);
+    }
 }
 
 // ===============================================================
@@ -266,7 +282,7 @@ void SceneView::selectVertex(const int idx) {
 void SceneView::selectEdge(const int idx) {
     settings_.selectedEdge = idx;
     if (idx >= 0) {
-        std::cout << "edge: " << conisCurve_.getControlCurve().edgePointingDir(idx) << std::endl;
+        CONIS_LOG(LOG_DEBUG, "edge: " << conisCurve_.getControlCurve().edgePointingDir(idx));
     }
     updateSelectedConic();
     update();
@@ -296,6 +312,8 @@ void SceneView::translationUpdate(const Vector2DD &scenePos, const QPointF &mous
 void SceneView::mousePressEvent(QMouseEvent *event) {
     // In order to allow keyPressEvents:
     setFocus();
+    // Makes the edit started by this press undoable; does nothing if the curve did not change since the last one
+    conisCurve_.checkpoint();
     const Vector2DD scenePos = toNormalizedScreenCoordinates(event->position().x(), event->position().y());
     switch (event->buttons()) {
         case Qt::LeftButton: {
@@ -396,6 +414,7 @@ void SceneView::keyPressEvent(QKeyEvent *event) {
     constexpr float movementSpeed = 0.02;
     // Only works when the widget has focus!
     auto &controlCurve = conisCurve_.getControlCurve();
+    conisCurve_.checkpoint();
     switch (event->key()) {
         case Qt::Key_Up:
             conisCurve_.translate({0, movementSpeed});
@@ -446,6 +465,7 @@ void SceneView::mouseDoubleClickEvent(QMouseEvent *event) {
     if (settings_.highlightedNormal < 0) {
         return;
     }
+    conisCurve_.checkpoint();
     conisCurve_.recalculateNormal(settings_.highlightedNormal);
 }
 
@@ -29,7 +29,7 @@ public:
     [[nodiscard]] const core::ConisCurve &getConisCurve() const { return conisCurve_; }
     [[nodiscard]] core::ConisCurve &getConisCurve() { return conisCurve_; }
 
-    void onListenerUpdated();
+    void onListenerUpdated(const core::ChangeSet &changes) override;
 
 protected:
     void initializeGL() override;